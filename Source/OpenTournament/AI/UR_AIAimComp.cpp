@@ -11,6 +11,14 @@
 #include "GameFramework/Controller.h"
 #include "GameFramework/Pawn.h"
 #include "AIHelpers.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+
+#include "UR_AITargetPredictionSubsystem.h"
+#include "UR_Character.h"
+#include "UR_FireModeBasic.h"
+#include "UR_InventoryComponent.h"
+#include "UR_Projectile.h"
+#include "UR_Weapon.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -25,6 +33,10 @@ UUR_AIAimComp::UUR_AIAimComp()
     DistanceSpeedFactor = 0.3f;
     PointDuration = FVector2D(0.2f, 0.4f);
     InterpSpeed = 10.f;
+    bLeadProjectiles = true;
+
+    CachedProjectileSpeed = 0.f;
+    CachedProjectileGravityZ = 0.f;
 }
 
 
@@ -92,15 +104,70 @@ FVector UUR_AIAimComp::CalculateNewGoalAimPoint(const AController* MyController,
 
 FVector UUR_AIAimComp::CalculateAimTargetForActor(const AActor* Actor)
 {
-    //TODO: if projectile weapon, take velocity/accel of target into account
-    const FVector& TargetLoc = Actor->GetActorLocation();
+    const AController* MyController = GetOwner<AController>();
+    const APawn* MyPawn = MyController ? MyController->GetPawn() : nullptr;
+
+    if (bLeadProjectiles && MyPawn)
+    {
+        UpdateProjectileParams();
+        if (CachedProjectileSpeed > 0.f)
+        {
+            if (auto PredictionSubsystem = GetWorld()->GetSubsystem<UUR_AITargetPredictionSubsystem>())
+            {
+                // Intercept already accounts for projectile drop
+                return PredictionSubsystem->GetInterceptPoint(Actor, MyPawn->GetPawnViewLocation(), CachedProjectileSpeed, CachedProjectileGravityZ);
+            }
+        }
+    }
 
-    return CalculateAimTargetForLocation(TargetLoc);
+    return CalculateAimTargetForLocation(Actor->GetActorLocation());
 }
 
 FVector UUR_AIAimComp::CalculateAimTargetForLocation(const FVector& WorldLocation)
 {
-    //TODO: if lobbing weapon, calculate Z toss
-
     return WorldLocation;
 }
+
+void UUR_AIAimComp::UpdateProjectileParams()
+{
+    const AController* MyController = GetOwner<AController>();
+    const AUR_Character* MyChar = MyController ? Cast<AUR_Character>(MyController->GetPawn()) : nullptr;
+    const AUR_Weapon* Weapon = (MyChar && MyChar->InventoryComponent) ? MyChar->InventoryComponent->ActiveWeapon : nullptr;
+
+    UUR_FireModeBase* FireMode = nullptr;
+    if (Weapon)
+    {
+        if (Weapon->CurrentFireMode)
+        {
+            FireMode = Weapon->CurrentFireMode;
+        }
+        else if (Weapon->DesiredFireModes.Num() > 0)
+        {
+            FireMode = Weapon->DesiredFireModes[0];
+        }
+        else if (Weapon->FireModes.Num() > 0)
+        {
+            FireMode = Weapon->FireModes[0];
+        }
+    }
+
+    if (FireMode == CachedFireMode.Get() && FireMode)
+    {
+        return;
+    }
+
+    CachedFireMode = FireMode;
+    CachedProjectileSpeed = 0.f;
+    CachedProjectileGravityZ = 0.f;
+
+    const UUR_FireModeBasic* BasicMode = Cast<UUR_FireModeBasic>(FireMode);
+    if (BasicMode && !BasicMode->bIsHitscan && BasicMode->ProjectileClass)
+    {
+        const AUR_Projectile* ProjectileCDO = BasicMode->ProjectileClass->GetDefaultObject<AUR_Projectile>();
+        if (const UProjectileMovementComponent* ProjMove = ProjectileCDO->ProjectileMovementComponent)
+        {
+            CachedProjectileSpeed = ProjMove->InitialSpeed;
+            CachedProjectileGravityZ = GetWorld()->GetGravityZ() * ProjMove->ProjectileGravityScale;
+        }
+    }
+}
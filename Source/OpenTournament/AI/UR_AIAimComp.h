@@ -11,6 +11,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 class AController;
+class UUR_FireModeBase;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -75,6 +76,10 @@ public:
     UPROPERTY(EditAnywhere, Category = "AimError")
     float InterpSpeed;
 
+    // Whether to lead targets with projectile weapons, using the shared target prediction.
+    UPROPERTY(EditAnywhere, Category = "AimPrediction")
+    bool bLeadProjectiles;
+
     // Entry point called by Controller->GetFocalPointOnActor
     // Return value is a point in the world that the controller should aim at.
     // We return our interpolated rotation instead of simply returning Actor->Location (default implementation)
@@ -89,4 +94,17 @@ protected:
     // This is where we should calculate the ideal aim point according to the weapon/firemode we are using, with no error applied.
     virtual FVector CalculateAimTargetForActor(const AActor* Actor);
     virtual FVector CalculateAimTargetForLocation(const FVector& WorldLocation);
+
+    // Refresh projectile speed/gravity for the fire mode our pawn is currently using.
+    // Results are cached per fire mode, as they come from the projectile class defaults.
+    virtual void UpdateProjectileParams();
+
+    // Fire mode the projectile params were cached for
+    TWeakObjectPtr<UUR_FireModeBase> CachedFireMode;
+
+    // Speed of the projectile fired by CachedFireMode, 0 for hitscan
+    float CachedProjectileSpeed;
+
+    // Gravity applied to the projectile fired by CachedFireMode
+    float CachedProjectileGravityZ;
 };
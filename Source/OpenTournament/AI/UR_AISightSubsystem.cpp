@@ -0,0 +1,348 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_AISightSubsystem.h"
+
+#include "AIController.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
+
+#include "UR_LogChannels.h"
+#include "GameModes/UR_BotCreationComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_AISightSubsystem)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT AI Sight"), STATGROUP_OTAISight, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Sight Service Update"), STAT_SightServiceUpdate, STATGROUP_OTAISight);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pairs Considered"), STAT_SightPairsConsidered, STATGROUP_OTAISight);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pairs Culled"), STAT_SightPairsCulled, STATGROUP_OTAISight);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Async Traces Last Batch"), STAT_SightTracesIssued, STATGROUP_OTAISight);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Total Async Traces"), STAT_SightTracesTotal, STATGROUP_OTAISight);
+
+namespace OTConsoleVariables
+{
+    static FAutoConsoleCommandWithWorldAndArgs CmdAISightReport(
+        TEXT("OT.AI.SightReport"),
+        TEXT("Server only. Measure the AI line-of-sight service at 8, 16 and 32 bots, adding or removing bots between steps. Optional arg: seconds per step (default 20)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (auto SightSubsystem = World ? World->GetSubsystem<UUR_AISightSubsystem>() : nullptr)
+            {
+                SightSubsystem->StartReport(Args.Num() > 0 ? FCString::Atof(*Args[0]) : 20.f);
+            }
+        }));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UUR_AISightSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // AI perception only runs on the server
+    return !IsRunningClientOnly() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UUR_AISightSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UUR_AISightSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_AISightSubsystem, STATGROUP_Tickables);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_AISightSubsystem::RegisterPawn(APawn* Pawn)
+{
+    if (Pawn)
+    {
+        Pawns.AddUnique(Pawn);
+    }
+}
+
+bool UUR_AISightSubsystem::GetCachedVisibility(const AActor* A, const AActor* B, bool& bOutVisible) const
+{
+    if (A && B)
+    {
+        if (const FVisibilityResult* Result = Results.Find(MakePairKey(A, B)))
+        {
+            if (GetWorld()->GetTimeSeconds() - Result->Time <= ResultLifetime)
+            {
+                bOutVisible = Result->bVisible;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void UUR_AISightSubsystem::StoreVisibility(const AActor* A, const AActor* B, bool bVisible)
+{
+    if (A && B)
+    {
+        FVisibilityResult& Result = Results.FindOrAdd(MakePairKey(A, B));
+        Result.bVisible = bVisible;
+        Result.Time = GetWorld()->GetTimeSeconds();
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_AISightSubsystem::RecordSightQuery(double Seconds, bool bFromCache)
+{
+    Counters.QuerySeconds += Seconds;
+    (bFromCache ? Counters.CachedQueries : Counters.FallbackQueries)++;
+}
+
+void UUR_AISightSubsystem::Tick(float DeltaTime)
+{
+    const double Now = GetWorld()->GetTimeSeconds();
+
+    if (Report.bActive)
+    {
+        TickReport(Now);
+    }
+
+    if (Now - LastUpdateTime < UpdateInterval)
+    {
+        return;
+    }
+    LastUpdateTime = Now;
+
+    SCOPE_CYCLE_COUNTER(STAT_SightServiceUpdate);
+    const double UpdateStartTime = FPlatformTime::Seconds();
+
+    Pawns.RemoveAllSwap([](const TWeakObjectPtr<APawn>& Pawn) { return !Pawn.IsValid(); });
+
+    // Expire old results so the table doesn't keep pairs of dead pawns around
+    for (auto It = Results.CreateIterator(); It; ++It)
+    {
+        if (Now - It.Value().Time > ResultLifetime)
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    IssueTraces();
+
+    Counters.UpdateSeconds += FPlatformTime::Seconds() - UpdateStartTime;
+}
+
+void UUR_AISightSubsystem::IssueTraces()
+{
+    if (!TraceDelegate.IsBound())
+    {
+        TraceDelegate.BindUObject(this, &ThisClass::OnTraceCompleted);
+    }
+
+    // Start a new batch, results of the previous one arriving late will be dropped
+    BatchId = (BatchId + 1) & (MAX_uint32 >> BatchIdShift);
+    PendingTraces.Reset();
+
+    struct FParticipant
+    {
+        APawn* Pawn;
+        FVector EyeLocation;
+        FVector ViewDir;
+        bool bIsObserver;
+    };
+
+    TArray<FParticipant, TInlineAllocator<64>> Participants;
+    for (const TWeakObjectPtr<APawn>& WeakPawn : Pawns)
+    {
+        APawn* Pawn = WeakPawn.Get();
+        if (!Pawn || Pawn->IsPendingKillPending())
+        {
+            continue;
+        }
+        FVector EyeLocation;
+        FRotator EyeRotation;
+        Pawn->GetActorEyesViewPoint(EyeLocation, EyeRotation);
+        Participants.Add({ Pawn, EyeLocation, EyeRotation.Vector(), Pawn->GetController<AAIController>() != nullptr });
+    }
+
+    const float MaxDistSq = FMath::Square(MaxSightDistance);
+    const float ConeCos = FMath::Cos(FMath::DegreesToRadians(ViewConeHalfAngle));
+
+    FCollisionQueryParams Params(SCENE_QUERY_STAT(AISightService), true);
+    const double Now = GetWorld()->GetTimeSeconds();
+    int32 NumConsidered = 0;
+    int32 NumCulled = 0;
+
+    for (int32 i = 0; i < Participants.Num(); i++)
+    {
+        const FParticipant& A = Participants[i];
+        for (int32 j = i + 1; j < Participants.Num(); j++)
+        {
+            const FParticipant& B = Participants[j];
+
+            // Nobody to perceive anything in this pair
+            if (!A.bIsObserver && !B.bIsObserver)
+            {
+                continue;
+            }
+
+            NumConsidered++;
+
+            // Culled pairs are stored too, so the sight sense doesn't fall back to its own trace for them
+            const FPairKey PairKey = MakePairKey(A.Pawn, B.Pawn);
+            const auto StoreCulled = [this, &PairKey, Now]()
+            {
+                FVisibilityResult& Result = Results.FindOrAdd(PairKey);
+                Result.bVisible = false;
+                Result.Time = Now;
+            };
+
+            const FVector AtoB = B.EyeLocation - A.EyeLocation;
+            const float DistSq = AtoB.SizeSquared();
+            if (DistSq > MaxDistSq)
+            {
+                NumCulled++;
+                StoreCulled();
+                continue;
+            }
+
+            // One trace serves both directions, so the pair is kept if either observer has the other in view
+            const FVector Dir = AtoB.GetSafeNormal();
+            const bool bAInCone = A.bIsObserver && FVector::DotProduct(A.ViewDir, Dir) >= ConeCos;
+            const bool bBInCone = B.bIsObserver && FVector::DotProduct(B.ViewDir, -Dir) >= ConeCos;
+            if (!bAInCone && !bBInCone)
+            {
+                NumCulled++;
+                StoreCulled();
+                continue;
+            }
+
+            if (PendingTraces.Num() > static_cast<int32>(TraceIndexMask))
+            {
+                break;
+            }
+
+            const uint32 UserData = (BatchId << BatchIdShift) | static_cast<uint32>(PendingTraces.Num());
+            PendingTraces.Add({ PairKey });
+
+            Params.ClearIgnoredActors();
+            Params.AddIgnoredActor(A.Pawn);
+            Params.AddIgnoredActor(B.Pawn);
+            GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, A.EyeLocation, B.EyeLocation, ECC_Visibility, Params, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, UserData);
+        }
+    }
+
+    SET_DWORD_STAT(STAT_SightPairsConsidered, NumConsidered);
+    SET_DWORD_STAT(STAT_SightPairsCulled, NumCulled);
+    SET_DWORD_STAT(STAT_SightTracesIssued, PendingTraces.Num());
+    INC_DWORD_STAT_BY(STAT_SightTracesTotal, PendingTraces.Num());
+    Counters.Traces += PendingTraces.Num();
+}
+
+void UUR_AISightSubsystem::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    if ((Datum.UserData >> BatchIdShift) != BatchId)
+    {
+        return;
+    }
+
+    const int32 Index = static_cast<int32>(Datum.UserData & TraceIndexMask);
+    if (PendingTraces.IsValidIndex(Index))
+    {
+        // Both pawns are ignored by the trace, so any blocking hit is an occluder
+        FVisibilityResult& Result = Results.FindOrAdd(PendingTraces[Index].PairKey);
+        Result.bVisible = !Datum.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+        Result.Time = GetWorld()->GetTimeSeconds();
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Report
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_AISightSubsystem::StartReport(float StepDuration)
+{
+    Report = FReport();
+    Report.BotCounts = { 8, 16, 32 };
+    Report.StepDuration = FMath::Max(StepDuration, 1.f);
+    Report.bActive = true;
+
+    UE_LOG(LogGame, Log, TEXT("SightReport: %.0f s per step"), Report.StepDuration);
+}
+
+void UUR_AISightSubsystem::TickReport(double Now)
+{
+    // Time for new bots to spawn and spread before measuring
+    static constexpr double SettleTime = 5.0;
+
+    if (Now < Report.PhaseEndTime)
+    {
+        return;
+    }
+
+    if (Report.bMeasuring)
+    {
+        const double Seconds = Report.StepDuration;
+        const FCounters& Start = Report.StartCounters;
+        const int64 Queries = (Counters.CachedQueries - Start.CachedQueries) + (Counters.FallbackQueries - Start.FallbackQueries);
+        Report.Lines.Add(FString::Printf(TEXT("  %2d bots: %7.0f async traces/s, %7.0f sync traces/s, %7.0f queries/s (%5.1f%% cached), service %.3f ms/s, queries %.3f ms/s"),
+            Report.BotCounts[Report.Step],
+            (Counters.Traces - Start.Traces) / Seconds,
+            (Counters.FallbackQueries - Start.FallbackQueries) / Seconds,
+            Queries / Seconds,
+            100.0 * (Counters.CachedQueries - Start.CachedQueries) / FMath::Max<int64>(Queries, 1),
+            (Counters.UpdateSeconds - Start.UpdateSeconds) * 1000.0 / Seconds,
+            (Counters.QuerySeconds - Start.QuerySeconds) * 1000.0 / Seconds));
+
+        Report.bMeasuring = false;
+        Report.PhaseEndTime = 0.0;
+        Report.Step++;
+    }
+    else if (Report.PhaseEndTime > 0.0)
+    {
+        Report.StartCounters = Counters;
+        Report.bMeasuring = true;
+        Report.PhaseEndTime = Now + Report.StepDuration;
+        return;
+    }
+
+    if (!Report.BotCounts.IsValidIndex(Report.Step))
+    {
+        Report.bActive = false;
+        UE_LOG(LogGame, Log, TEXT("SightReport: done, queries are the sight sense asking characters for visibility"));
+        for (const FString& Line : Report.Lines)
+        {
+            UE_LOG(LogGame, Log, TEXT("%s"), *Line);
+        }
+        return;
+    }
+
+#if WITH_SERVER_CODE
+    AGameStateBase* GameState = GetWorld()->GetGameState();
+    UUR_BotCreationComponent* BotCreation = GameState ? GameState->FindComponentByClass<UUR_BotCreationComponent>() : nullptr;
+    if (!BotCreation)
+    {
+        Report.bActive = false;
+        UE_LOG(LogGame, Warning, TEXT("SightReport: no bot creation component"));
+        return;
+    }
+
+    int32 NumBots = 0;
+    for (TActorIterator<AAIController> It(GetWorld()); It; ++It)
+    {
+        NumBots++;
+    }
+    for (; NumBots < Report.BotCounts[Report.Step]; NumBots++)
+    {
+        BotCreation->Cheat_AddBot();
+    }
+    for (; NumBots > Report.BotCounts[Report.Step]; NumBots--)
+    {
+        BotCreation->Cheat_RemoveBot();
+    }
+#endif
+
+    Report.PhaseEndTime = Now + SettleTime;
+}
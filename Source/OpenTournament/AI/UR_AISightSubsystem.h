@@ -0,0 +1,157 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+
+#include "UR_AISightSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+class APawn;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Central line-of-sight service for AI perception. Server only.
+ *
+ * Instead of every bot's sight sense tracing against every stimuli source on its own,
+ * visibility is computed once per update for each pair of registered pawns :
+ * - pairs are culled by distance, then by view cone of the AI-controlled side(s), and stored as not visible
+ * - the remaining pairs are traced eye-to-eye with async traces
+ * - results are symmetric, so a single trace serves both pawns
+ *
+ * Culling must be at least as wide as the sight sense config (sight radius, peripheral vision angle),
+ * or pawns the sense considers in view would be reported hidden until the next update.
+ *
+ * Characters implement IAISightTargetInterface and answer the sight sense from this cache.
+ */
+UCLASS(Config = Game)
+class OPENTOURNAMENT_API UUR_AISightSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    //~UWorldSubsystem interface
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    //~End of UWorldSubsystem interface
+
+    //~FTickableGameObject interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    //~End of FTickableGameObject interface
+
+    /** Register a pawn as both potential observer and sight target */
+    void RegisterPawn(APawn* Pawn);
+
+    /**
+    * Look up cached visibility between two pawns.
+    * Returns false if there is no fresh result for this pair.
+    */
+    bool GetCachedVisibility(const AActor* A, const AActor* B, bool& bOutVisible) const;
+
+    /** Store a visibility result computed elsewhere (eg. synchronous fallback trace) */
+    void StoreVisibility(const AActor* A, const AActor* B, bool bVisible);
+
+    /** Account for a sight query answered by a target, for the report */
+    void RecordSightQuery(double Seconds, bool bFromCache);
+
+    /**
+    * Measure the service at 8, 16 and 32 bots, adding or removing bots between steps.
+    * Backs the OT.AI.SightReport console command.
+    */
+    void StartReport(float StepDuration);
+
+    /** Max distance at which pairs are considered at all, should cover the sight sense's LoseSightRadius */
+    UPROPERTY(Config)
+    float MaxSightDistance = 8000.f;
+
+    /** Half-angle of the view cone of AI observers in degrees, should cover the sight sense's PeripheralVisionAngleDegrees */
+    UPROPERTY(Config)
+    float ViewConeHalfAngle = 80.f;
+
+    /** Interval between visibility updates */
+    UPROPERTY(Config)
+    float UpdateInterval = 0.1f;
+
+    /** Results older than this are not served anymore */
+    UPROPERTY(Config)
+    float ResultLifetime = 0.3f;
+
+protected:
+
+    struct FVisibilityResult
+    {
+        bool bVisible = false;
+        double Time = 0.0;
+    };
+
+    /** Object keys carry the serial number, so a pair never matches actors reusing the same object index after GC */
+    using FPairKey = TPair<TObjectKey<AActor>, TObjectKey<AActor>>;
+
+    struct FPendingTrace
+    {
+        FPairKey PairKey;
+    };
+
+    /** Order-independent key for a pair of actors */
+    static FPairKey MakePairKey(const AActor* A, const AActor* B)
+    {
+        return (A->GetUniqueID() < B->GetUniqueID()) ? FPairKey(A, B) : FPairKey(B, A);
+    }
+
+    void IssueTraces();
+
+    void TickReport(double Now);
+
+    void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+    TArray<TWeakObjectPtr<APawn>> Pawns;
+
+    TMap<FPairKey, FVisibilityResult> Results;
+
+    /** Traces of the batch in flight, indexed by trace UserData */
+    TArray<FPendingTrace> PendingTraces;
+
+    /** Stamped in trace UserData, so late results from a previous batch are ignored */
+    uint32 BatchId = 0;
+
+    static constexpr uint32 BatchIdShift = 20;
+    static constexpr uint32 TraceIndexMask = (1u << BatchIdShift) - 1;
+
+    double LastUpdateTime = 0.0;
+
+    FTraceDelegate TraceDelegate;
+
+    /** Running totals, sampled by the report */
+    struct FCounters
+    {
+        int64 Traces = 0;
+        int64 CachedQueries = 0;
+        int64 FallbackQueries = 0;
+        double QuerySeconds = 0.0;
+        double UpdateSeconds = 0.0;
+    };
+
+    FCounters Counters;
+
+    struct FReport
+    {
+        TArray<int32> BotCounts;
+        TArray<FString> Lines;
+        FCounters StartCounters;
+        double PhaseEndTime = 0.0;
+        float StepDuration = 0.f;
+        int32 Step = 0;
+        bool bMeasuring = false;
+        bool bActive = false;
+    };
+
+    FReport Report;
+};
@@ -0,0 +1,427 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_AITacticalSubsystem.h"
+
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerStart.h"
+#include "NavigationPath.h"
+#include "NavigationSystem.h"
+#include "NavFilters/NavigationQueryFilter.h"
+#include "NavMesh/RecastNavMesh.h"
+
+#include "UR_LogChannels.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_AITacticalSubsystem)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT AI Tactical"), STATGROUP_OTAITactical, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Find Path Cached"), STAT_FindPathCached, STATGROUP_OTAITactical);
+DECLARE_CYCLE_STAT(TEXT("Find Best Item Goal"), STAT_FindBestItemGoal, STATGROUP_OTAITactical);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Path Cache Hits"), STAT_PathCacheHits, STATGROUP_OTAITactical);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Path Cache Misses"), STAT_PathCacheMisses, STATGROUP_OTAITactical);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Path Cache Entries"), STAT_PathCacheEntries, STATGROUP_OTAITactical);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Influence Cells"), STAT_InfluenceCells, STATGROUP_OTAITactical);
+
+namespace OTConsoleVariables
+{
+    static FAutoConsoleCommandWithWorldAndArgs CmdAIPathBenchmark(
+        TEXT("OT.AI.PathBenchmark"),
+        TEXT("Server only. Time cached against uncached bot path queries at 8, 16 and 32 bots. Optional arg: queries per bot (default 10)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            auto TacticalSubsystem = World ? World->GetSubsystem<UUR_AITacticalSubsystem>() : nullptr;
+            if (!TacticalSubsystem)
+            {
+                return;
+            }
+            // Any pawn provides the nav agent and query filter
+            TActorIterator<APawn> It(World);
+            TacticalSubsystem->RunPathBenchmark(It ? *It : nullptr, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10);
+        }));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+    /** Deep copy of a path, so cached instances are never shared with path followers */
+    FNavPathSharedPtr CopyPath(const FNavigationPath& Source)
+    {
+        if (const FNavMeshPath* MeshPath = Source.CastPath<FNavMeshPath>())
+        {
+            return MakeShared<FNavMeshPath, ESPMode::ThreadSafe>(*MeshPath);
+        }
+        return MakeShared<FNavigationPath, ESPMode::ThreadSafe>(Source);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UUR_AITacticalSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // Bots only exist on the server
+    return !IsRunningClientOnly() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UUR_AITacticalSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UUR_AITacticalSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    if (auto NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(&InWorld))
+    {
+        NavSys->OnNavigationGenerationFinishedDelegate.AddUniqueDynamic(this, &ThisClass::OnNavigationGenerationFinished);
+    }
+}
+
+void UUR_AITacticalSubsystem::Deinitialize()
+{
+    if (auto NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld()))
+    {
+        NavSys->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &ThisClass::OnNavigationGenerationFinished);
+    }
+
+    InvalidatePathCache();
+    Cells.Empty();
+    ItemCells.Empty();
+
+    Super::Deinitialize();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Path cache
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+UNavigationPath* UUR_AITacticalSubsystem::FindPathToLocationCached(APawn* Pawn, const FVector& GoalLocation)
+{
+    if (!Pawn)
+    {
+        return nullptr;
+    }
+
+    auto NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+    if (!NavSys)
+    {
+        return nullptr;
+    }
+
+    UNavigationPath* Result = NewObject<UNavigationPath>(NavSys);
+    Result->SetPath(FindPathCached(Pawn, Pawn->GetNavAgentLocation(), GoalLocation));
+    return Result;
+}
+
+FNavPathSharedPtr UUR_AITacticalSubsystem::FindPathCached(const APawn* Pawn, const FVector& StartLocation, const FVector& GoalLocation, const ANavigationData* InNavData)
+{
+    SCOPE_CYCLE_COUNTER(STAT_FindPathCached);
+
+    auto NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+    if (!NavSys || !Pawn)
+    {
+        return nullptr;
+    }
+
+    const FNavAgentProperties& AgentProps = Pawn->GetNavAgentPropertiesRef();
+    const ANavigationData* NavData = InNavData ? InNavData : NavSys->GetNavDataForProps(AgentProps, StartLocation);
+    if (!NavData)
+    {
+        return nullptr;
+    }
+    const FSharedConstNavQueryFilter QueryFilter = UNavigationQueryFilter::GetQueryFilter(*NavData, Pawn, nullptr);
+
+    const double Now = GetWorld()->GetTimeSeconds();
+
+    // Resolve start and goal polys, only recast navmeshes can be cached
+    FPathCacheKey Key(nullptr, INVALID_NAVNODEREF, INVALID_NAVNODEREF);
+    if (const ARecastNavMesh* NavMesh = Cast<ARecastNavMesh>(NavData))
+    {
+        const NavNodeRef StartPoly = NavMesh->FindNearestPoly(StartLocation, PolyQueryExtent);
+        const NavNodeRef GoalPoly = NavMesh->FindNearestPoly(GoalLocation, PolyQueryExtent);
+        if (StartPoly != INVALID_NAVNODEREF && GoalPoly != INVALID_NAVNODEREF)
+        {
+            Key = FPathCacheKey(NavMesh, StartPoly, GoalPoly);
+        }
+    }
+    const bool bCacheable = Key.Get<0>() != nullptr;
+
+    if (bCacheable)
+    {
+        if (const FUR_CachedPath* Cached = PathCache.Find(Key))
+        {
+            if (Cached->Path.IsValid() && Cached->Path->IsValid() && Cached->Path->IsUpToDate() && Now - Cached->CreationTime < PathCacheLifetime)
+            {
+                INC_DWORD_STAT(STAT_PathCacheHits);
+                NumPathCacheHits++;
+
+                // Hand out a copy, so followers can't mess with the cached instance.
+                // The corridor is valid for any locations within the same polys, but its points were
+                // string-pulled for the original query, so pull them again for this one.
+                FNavPathSharedPtr Copy = CopyPath(*Cached->Path);
+                if (FNavMeshPath* MeshPath = Copy->CastPath<FNavMeshPath>())
+                {
+                    MeshPath->PerformStringPulling(StartLocation, GoalLocation);
+                }
+                // Repaths must use this pawn's query, not the one the entry was found with,
+                // and the navdata must know about the copy to invalidate it when tiles get rebuilt
+                Copy->SetQueryData(FPathFindingQueryData(Pawn, StartLocation, GoalLocation, QueryFilter));
+                Copy->EnableRecalculationOnInvalidation(true);
+                const_cast<ANavigationData*>(NavData)->RegisterActivePath(Copy);
+                return Copy;
+            }
+            PathCache.Remove(Key);
+        }
+    }
+
+    INC_DWORD_STAT(STAT_PathCacheMisses);
+    NumPathCacheMisses++;
+
+    FPathFindingQuery Query(Pawn, *NavData, StartLocation, GoalLocation, QueryFilter);
+    const FPathFindingResult Result = NavSys->FindPathSync(AgentProps, Query);
+
+    if (!Result.IsSuccessful())
+    {
+        return nullptr;
+    }
+
+    // Partial paths depend too much on the exact query, don't share them
+    if (bCacheable && !Result.IsPartial())
+    {
+        FUR_CachedPath& Entry = PathCache.Add(Key);
+        Entry.Path = CopyPath(*Result.Path);
+        Entry.CreationTime = Now;
+
+        // Let the navdata flag our entry when tiles under it get rebuilt, but never repath it on its own
+        Entry.Path->EnableRecalculationOnInvalidation(false);
+        const_cast<ANavigationData*>(NavData)->RegisterActivePath(Entry.Path);
+
+        SET_DWORD_STAT(STAT_PathCacheEntries, PathCache.Num());
+    }
+
+    return Result.Path;
+}
+
+void UUR_AITacticalSubsystem::RunPathBenchmark(const APawn* Pawn, int32 Rounds)
+{
+    auto NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+    ANavigationData* NavData = (NavSys && Pawn) ? NavSys->GetNavDataForProps(Pawn->GetNavAgentPropertiesRef(), Pawn->GetNavAgentLocation()) : nullptr;
+    if (!NavData)
+    {
+        UE_LOG(LogGame, Warning, TEXT("PathBenchmark: needs a pawn and navigation data"));
+        return;
+    }
+
+    TArray<FVector> Goals;
+    for (const auto& Pair : ItemCells)
+    {
+        if (const AActor* Item = Pair.Key.Get())
+        {
+            Goals.Add(Item->GetActorLocation());
+        }
+    }
+    TArray<FVector> Spawns;
+    for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+    {
+        Spawns.Add(It->GetActorLocation());
+    }
+    if (Goals.Num() == 0 || Spawns.Num() == 0)
+    {
+        UE_LOG(LogGame, Warning, TEXT("PathBenchmark: needs registered items and player starts"));
+        return;
+    }
+
+    const FNavAgentProperties& AgentProps = Pawn->GetNavAgentPropertiesRef();
+    const FSharedConstNavQueryFilter Filter = UNavigationQueryFilter::GetQueryFilter(*NavData, Pawn, nullptr);
+
+    UE_LOG(LogGame, Log, TEXT("PathBenchmark: %d goals, %d spawns, %d queries per bot"), Goals.Num(), Spawns.Num(), FMath::Max(Rounds, 1));
+
+    static const int32 BotCounts[] = { 8, 16, 32 };
+    for (const int32 NumBots : BotCounts)
+    {
+        // Pick starts and goals up front, so both runs issue the same queries
+        FRandomStream Random(NumBots);
+        TArray<TPair<FVector, FVector>> Queries;
+        for (int32 i = 0; i < FMath::Max(Rounds, 1) * NumBots; i++)
+        {
+            FNavLocation Start;
+            if (NavSys->GetRandomReachablePointInRadius(Spawns[Random.RandHelper(Spawns.Num())], 300.f, Start, NavData, Filter))
+            {
+                Queries.Emplace(Start.Location, Goals[Random.RandHelper(Goals.Num())]);
+            }
+        }
+
+        const double UncachedStart = FPlatformTime::Seconds();
+        for (const auto& Query : Queries)
+        {
+            NavSys->FindPathSync(AgentProps, FPathFindingQuery(Pawn, *NavData, Query.Key, Query.Value, Filter));
+        }
+        const double UncachedMs = (FPlatformTime::Seconds() - UncachedStart) * 1000.0;
+
+        InvalidatePathCache();
+        const int32 HitsBefore = NumPathCacheHits;
+        const double CachedStart = FPlatformTime::Seconds();
+        for (const auto& Query : Queries)
+        {
+            FindPathCached(Pawn, Query.Key, Query.Value);
+        }
+        const double CachedMs = (FPlatformTime::Seconds() - CachedStart) * 1000.0;
+        const int32 Hits = NumPathCacheHits - HitsBefore;
+
+        UE_LOG(LogGame, Log, TEXT("  %2d bots: %4d queries, uncached %7.2f ms, cached %7.2f ms, %5.1f%% hits"),
+            NumBots, Queries.Num(), UncachedMs, CachedMs, 100.f * Hits / FMath::Max(Queries.Num(), 1));
+    }
+
+    InvalidatePathCache();
+}
+
+void UUR_AITacticalSubsystem::InvalidatePathCache()
+{
+    PathCache.Empty();
+    SET_DWORD_STAT(STAT_PathCacheEntries, 0);
+}
+
+void UUR_AITacticalSubsystem::OnNavigationGenerationFinished(ANavigationData* NavData)
+{
+    InvalidatePathCache();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Influence map
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_AITacticalSubsystem::AddDanger(const FVector& Location, float Amount)
+{
+    const double Now = GetWorld()->GetTimeSeconds();
+
+    FUR_InfluenceCell& Cell = Cells.FindOrAdd(GetCellCoord(Location));
+    Cell.Danger = Decay(Cell.Danger, Now - Cell.DangerTime, DangerHalfLife) + Amount;
+    Cell.DangerTime = Now;
+
+    SET_DWORD_STAT(STAT_InfluenceCells, Cells.Num());
+}
+
+void UUR_AITacticalSubsystem::AddDeath(const FVector& Location)
+{
+    const double Now = GetWorld()->GetTimeSeconds();
+
+    FUR_InfluenceCell& Cell = Cells.FindOrAdd(GetCellCoord(Location));
+    Cell.Deaths = Decay(Cell.Deaths, Now - Cell.DeathsTime, DeathsHalfLife) + 1.f;
+    Cell.DeathsTime = Now;
+
+    SET_DWORD_STAT(STAT_InfluenceCells, Cells.Num());
+}
+
+void UUR_AITacticalSubsystem::SetItemValue(AActor* Item, float Value)
+{
+    if (!Item)
+    {
+        return;
+    }
+
+    const TWeakObjectPtr<AActor> ItemKey(Item);
+
+    // Remove from previous cell
+    if (const FIntPoint* OldCoord = ItemCells.Find(ItemKey))
+    {
+        if (FUR_InfluenceCell* OldCell = Cells.Find(*OldCoord))
+        {
+            OldCell->Items.RemoveAllSwap([&ItemKey](const TPair<TWeakObjectPtr<AActor>, float>& Entry) { return Entry.Key == ItemKey; });
+            OldCell->ItemValue = 0.f;
+            for (const auto& Entry : OldCell->Items)
+            {
+                OldCell->ItemValue += Entry.Value;
+            }
+        }
+        ItemCells.Remove(ItemKey);
+    }
+
+    if (Value > 0.f)
+    {
+        const FIntPoint Coord = GetCellCoord(Item->GetActorLocation());
+        FUR_InfluenceCell& Cell = Cells.FindOrAdd(Coord);
+        Cell.Items.Emplace(ItemKey, Value);
+        Cell.ItemValue += Value;
+        ItemCells.Add(ItemKey, Coord);
+    }
+
+    SET_DWORD_STAT(STAT_InfluenceCells, Cells.Num());
+}
+
+float UUR_AITacticalSubsystem::GetDangerAt(const FVector& Location) const
+{
+    if (const FUR_InfluenceCell* Cell = Cells.Find(GetCellCoord(Location)))
+    {
+        return Decay(Cell->Danger, GetWorld()->GetTimeSeconds() - Cell->DangerTime, DangerHalfLife);
+    }
+    return 0.f;
+}
+
+float UUR_AITacticalSubsystem::GetCellScore(const FUR_InfluenceCell& Cell, double Now) const
+{
+    const float Danger = Decay(Cell.Danger, Now - Cell.DangerTime, DangerHalfLife);
+    const float Deaths = Decay(Cell.Deaths, Now - Cell.DeathsTime, DeathsHalfLife);
+    return 1.f - Danger * DangerWeight - Deaths * DeathsWeight;
+}
+
+AActor* UUR_AITacticalSubsystem::FindBestItemGoal(const FVector& Location, float Radius, float& OutScore) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_FindBestItemGoal);
+
+    OutScore = 0.f;
+    if (Radius <= 0.f)
+    {
+        return nullptr;
+    }
+
+    const double Now = GetWorld()->GetTimeSeconds();
+    const FIntPoint MinCoord = GetCellCoord(Location - FVector(Radius));
+    const FIntPoint MaxCoord = GetCellCoord(Location + FVector(Radius));
+    const float RadiusSq = FMath::Square(Radius);
+
+    AActor* BestItem = nullptr;
+
+    for (int32 X = MinCoord.X; X <= MaxCoord.X; X++)
+    {
+        for (int32 Y = MinCoord.Y; Y <= MaxCoord.Y; Y++)
+        {
+            const FUR_InfluenceCell* Cell = Cells.Find(FIntPoint(X, Y));
+            if (!Cell || Cell->ItemValue <= 0.f)
+            {
+                continue;
+            }
+
+            const float CellScore = GetCellScore(*Cell, Now);
+            for (const auto& Entry : Cell->Items)
+            {
+                AActor* Item = Entry.Key.Get();
+                if (!Item)
+                {
+                    continue;
+                }
+
+                const float DistSq = FVector::DistSquared(Item->GetActorLocation(), Location);
+                if (DistSq > RadiusSq)
+                {
+                    continue;
+                }
+
+                // Prefer closer items, without ever going negative on distance alone
+                const float Score = Entry.Value * CellScore * (1.f - 0.5f * FMath::Sqrt(DistSq) / Radius);
+                if (Score > OutScore)
+                {
+                    OutScore = Score;
+                    BestItem = Item;
+                }
+            }
+        }
+    }
+
+    return BestItem;
+}
@@ -0,0 +1,188 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavigationData.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UR_AITacticalSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ANavigationData;
+class APawn;
+class UNavigationPath;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * One cell of the tactical influence map.
+ * Danger and deaths decay over time, the decay is applied lazily when reading.
+ */
+struct FUR_InfluenceCell
+{
+    float Danger = 0.f;
+    double DangerTime = 0.0;
+
+    float Deaths = 0.f;
+    double DeathsTime = 0.0;
+
+    /** Sum of ItemValues of the items currently available in this cell */
+    float ItemValue = 0.f;
+
+    /** Items currently registered in this cell, with their value */
+    TArray<TPair<TWeakObjectPtr<AActor>, float>> Items;
+};
+
+/**
+ * Cached path, keyed by start and goal nav polys.
+ * Only its poly corridor is reused: hits are string-pulled again between the actual query locations.
+ */
+struct FUR_CachedPath
+{
+    FNavPathSharedPtr Path;
+    double CreationTime = 0.0;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Shared tactical data for bots. Server only.
+ *
+ * - Path cache: bots heading to the same pickup or area from nearby share a single corridor search.
+ *   Entries are keyed by start/goal nav polys, and flushed when the navmesh is rebuilt.
+ *   Bot move requests go through it (AUR_BotController::FindPathForMoveRequest).
+ *
+ * - Influence map: coarse 2D grid of danger, item value and recent deaths.
+ *   Updated incrementally by gameplay events, so bots can pick goals by looking up a few cells
+ *   instead of scanning all actors (UUR_BTService_FindItemGoal).
+ */
+UCLASS(Config = Game)
+class OPENTOURNAMENT_API UUR_AITacticalSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    //~UWorldSubsystem interface
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+    //~End of UWorldSubsystem interface
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////
+    // Path cache
+
+    /**
+    * Cached equivalent of UNavigationSystemV1::FindPathToLocationSynchronously for a pawn.
+    * Returns a copy of a cached path when another query was issued recently between the same nav polys.
+    */
+    UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+    UNavigationPath* FindPathToLocationCached(APawn* Pawn, const FVector& GoalLocation);
+
+    /**
+    * Native version, returns a path owned by the caller (never the cached instance).
+    * Always uses the default query filter of the navigation data, found from the pawn's agent when InNavData is null.
+    */
+    FNavPathSharedPtr FindPathCached(const APawn* Pawn, const FVector& StartLocation, const FVector& GoalLocation, const ANavigationData* InNavData = nullptr);
+
+    /**
+    * Compare cached and uncached path queries for increasing bot counts, backs the OT.AI.PathBenchmark console command.
+    * Bots start around the player starts and head to registered items, like they would during a match.
+    */
+    void RunPathBenchmark(const APawn* Pawn, int32 Rounds);
+
+    /** Drop all cached paths */
+    UFUNCTION(BlueprintCallable, Category = "AI|Navigation")
+    void InvalidatePathCache();
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////
+    // Influence map
+
+    /** Add danger at a location (eg. damage taken or dealt there) */
+    void AddDanger(const FVector& Location, float Amount);
+
+    /** Register a death at a location */
+    void AddDeath(const FVector& Location);
+
+    /**
+    * Set the value of an item for bots. Value <= 0 removes the item (eg. picked up).
+    * Items are keyed by actor, so calling this again with a new value just updates it.
+    */
+    void SetItemValue(AActor* Item, float Value);
+
+    /** Current danger at a location, decayed */
+    UFUNCTION(BlueprintPure, Category = "AI|Influence")
+    float GetDangerAt(const FVector& Location) const;
+
+    /**
+    * Find the most valuable item within Radius, weighted down by danger and recent deaths around it.
+    * Only looks up the grid cells overlapping the radius.
+    */
+    UFUNCTION(BlueprintCallable, Category = "AI|Influence")
+    AActor* FindBestItemGoal(const FVector& Location, float Radius, float& OutScore) const;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /** Size of the influence map cells */
+    UPROPERTY(Config)
+    float CellSize = 1024.f;
+
+    /** Half-life of danger values, in seconds */
+    UPROPERTY(Config)
+    float DangerHalfLife = 5.f;
+
+    /** Half-life of recent deaths, in seconds */
+    UPROPERTY(Config)
+    float DeathsHalfLife = 15.f;
+
+    /** How much danger reduces item goal score */
+    UPROPERTY(Config)
+    float DangerWeight = 0.01f;
+
+    /** How much recent deaths reduce item goal score */
+    UPROPERTY(Config)
+    float DeathsWeight = 0.25f;
+
+    /** Cached paths older than this are recomputed, to account for dynamic obstacles */
+    UPROPERTY(Config)
+    float PathCacheLifetime = 10.f;
+
+    /** Extent used to find the nav poly of path start and goal */
+    UPROPERTY(Config)
+    FVector PolyQueryExtent = FVector(50.f, 50.f, 250.f);
+
+protected:
+
+    UFUNCTION()
+    void OnNavigationGenerationFinished(ANavigationData* NavData);
+
+    FIntPoint GetCellCoord(const FVector& Location) const
+    {
+        return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+    }
+
+    static float Decay(float Value, double Since, float HalfLife)
+    {
+        return (HalfLife > 0.f) ? Value * FMath::Pow(0.5f, static_cast<float>(Since) / HalfLife) : 0.f;
+    }
+
+    float GetCellScore(const FUR_InfluenceCell& Cell, double Now) const;
+
+    /** Key = (NavData, StartPoly, GoalPoly) */
+    using FPathCacheKey = TTuple<const ANavigationData*, NavNodeRef, NavNodeRef>;
+
+    TMap<FPathCacheKey, FUR_CachedPath> PathCache;
+
+    int32 NumPathCacheHits = 0;
+    int32 NumPathCacheMisses = 0;
+
+    TMap<FIntPoint, FUR_InfluenceCell> Cells;
+
+    /** Reverse lookup of the cell each item is registered in */
+    TMap<TWeakObjectPtr<AActor>, FIntPoint> ItemCells;
+};
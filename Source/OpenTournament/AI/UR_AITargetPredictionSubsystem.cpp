@@ -0,0 +1,322 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_AITargetPredictionSubsystem.h"
+
+#include "Components/CapsuleComponent.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "UObject/UObjectIterator.h"
+
+#include "UR_Character.h"
+#include "UR_LogChannels.h"
+#include "UR_Projectile.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_AITargetPredictionSubsystem)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT AI"), STATGROUP_OTAI, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Target Prediction Tick"), STAT_TargetPredictionTick, STATGROUP_OTAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Predicted Targets"), STAT_NumPredictedTargets, STATGROUP_OTAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Intercept Queries"), STAT_NumInterceptQueries, STATGROUP_OTAI);
+
+namespace OTConsoleVariables
+{
+    static FAutoConsoleCommandWithWorldAndArgs CmdAIAimTest(
+        TEXT("OT.AI.AimTest"),
+        TEXT("Server only. Measure bot hit rate against a scripted moving target for each loaded projectile class. Optional arg: duration in seconds (default 60)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (auto PredictionSubsystem = World ? World->GetSubsystem<UUR_AITargetPredictionSubsystem>() : nullptr)
+            {
+                PredictionSubsystem->RunAimTest(Args.Num() > 0 ? FCString::Atof(*Args[0]) : 60.f);
+            }
+        }));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UUR_AITargetPredictionSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // Bots only exist on the server
+    return !IsRunningClientOnly() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UUR_AITargetPredictionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UUR_AITargetPredictionSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_AITargetPredictionSubsystem, STATGROUP_Tickables);
+}
+
+void UUR_AITargetPredictionSubsystem::Tick(float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_TargetPredictionTick);
+
+    const double Now = GetWorld()->GetTimeSeconds();
+
+    for (auto It = Targets.CreateIterator(); It; ++It)
+    {
+        const AActor* Target = It.Key().Get();
+        if (!Target || Now - It.Value().LastQueryTime > TargetExpireTime)
+        {
+            It.RemoveCurrent();
+            continue;
+        }
+        SampleTarget(Target, It.Value(), Now);
+    }
+
+    SET_DWORD_STAT(STAT_NumPredictedTargets, Targets.Num());
+}
+
+void UUR_AITargetPredictionSubsystem::SampleTarget(const AActor* Target, FUR_TargetMotion& Motion, double Now) const
+{
+    if (Motion.NumSamples > 0 && Now <= Motion.SampleTime)
+    {
+        return;
+    }
+
+    float GravityZ = 0.f;
+    if (const ACharacter* Character = Cast<ACharacter>(Target))
+    {
+        const UCharacterMovementComponent* CharMove = Character->GetCharacterMovement();
+        GravityZ = (CharMove && CharMove->IsFalling()) ? CharMove->GetGravityZ() : 0.f;
+    }
+
+    UpdateMotion(Motion, Target->GetActorLocation(), Target->GetVelocity(), GravityZ, Now);
+}
+
+void UUR_AITargetPredictionSubsystem::UpdateMotion(FUR_TargetMotion& Motion, const FVector& Location, const FVector& Velocity, float GravityZ, double Now) const
+{
+    if (Motion.NumSamples > 0)
+    {
+        // Vertical velocity changes are gravity, jumps and landings, none of which should be extrapolated
+        const float Delta = static_cast<float>(Now - Motion.SampleTime);
+        FVector RawAccel = (Velocity - Motion.Velocity) / Delta;
+        RawAccel.Z = 0.f;
+        RawAccel = RawAccel.GetClampedToMaxSize(MaxAcceleration);
+        Motion.Acceleration = (Motion.NumSamples > 1) ? FMath::Lerp(Motion.Acceleration, RawAccel, AccelerationSmoothing) : RawAccel;
+    }
+
+    Motion.Location = Location;
+    Motion.Velocity = Velocity;
+    Motion.GravityZ = GravityZ;
+    Motion.SampleTime = Now;
+    Motion.NumSamples++;
+}
+
+const FUR_TargetMotion& UUR_AITargetPredictionSubsystem::GetTargetMotion(const AActor* Target)
+{
+    const double Now = GetWorld()->GetTimeSeconds();
+
+    FUR_TargetMotion& Motion = Targets.FindOrAdd(Target);
+    Motion.LastQueryTime = Now;
+    if (Motion.NumSamples == 0)
+    {
+        SampleTarget(Target, Motion, Now);
+    }
+    return Motion;
+}
+
+FVector UUR_AITargetPredictionSubsystem::GetInterceptPoint(const AActor* Target, const FVector& StartLocation, float ProjectileSpeed, float ProjectileGravityZ)
+{
+    INC_DWORD_STAT(STAT_NumInterceptQueries);
+
+    if (ProjectileSpeed <= 0.f)
+    {
+        return Target->GetActorLocation();
+    }
+
+    FVector AimPoint;
+    float Time;
+    SolveIntercept(GetTargetMotion(Target), StartLocation, ProjectileSpeed, ProjectileGravityZ, MaxLeadTime, AimPoint, Time);
+    return AimPoint;
+}
+
+bool UUR_AITargetPredictionSubsystem::SolveIntercept(const FUR_TargetMotion& Motion, const FVector& StartLocation, float ProjectileSpeed, float ProjectileGravityZ, float MaxTime, FVector& OutAimPoint, float& OutTime)
+{
+    // Fixed-point iteration on the flight time - converges quickly as long as the projectile is faster than the target
+    static constexpr int32 MaxIterations = 5;
+    static constexpr float TimeTolerance = 0.005f;
+
+    float Time = FMath::Min(FVector::Dist(Motion.Location, StartLocation) / ProjectileSpeed, MaxTime);
+    bool bConverged = false;
+
+    for (int32 i = 0; i < MaxIterations; i++)
+    {
+        const float NewTime = FVector::Dist(Motion.PredictLocation(Time), StartLocation) / ProjectileSpeed;
+        if (NewTime > MaxTime)
+        {
+            Time = MaxTime;
+            break;
+        }
+        bConverged = FMath::Abs(NewTime - Time) < TimeTolerance;
+        Time = NewTime;
+        if (bConverged)
+        {
+            break;
+        }
+    }
+
+    OutTime = Time;
+    OutAimPoint = Motion.PredictLocation(Time);
+
+    // Compensate for projectile drop by aiming higher
+    OutAimPoint.Z -= 0.5f * ProjectileGravityZ * FMath::Square(Time);
+
+    return bConverged;
+}
+
+void UUR_AITargetPredictionSubsystem::RunAimTest(float Duration) const
+{
+    static constexpr float TimeStep = 1.f / 60.f;
+    static constexpr float ShotInterval = 0.5f;
+    static constexpr float TargetDistance = 2000.f;
+    static constexpr int32 RandomSeed = 1234;
+
+    // Target movement is taken from the default character, so the test follows gameplay tuning
+    const AUR_Character* CharacterCDO = GetDefault<AUR_Character>();
+    const UCharacterMovementComponent* CharMoveCDO = CharacterCDO->GetCharacterMovement();
+    const float CapsuleRadius = CharacterCDO->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
+    const float CapsuleHalfHeight = CharacterCDO->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+    const float RunSpeed = CharMoveCDO ? CharMoveCDO->MaxWalkSpeed : 600.f;
+    const float JumpZ = CharMoveCDO ? CharMoveCDO->JumpZVelocity : 800.f;
+    const float WorldGravityZ = GetWorld()->GetGravityZ();
+    const float TargetGravityZ = WorldGravityZ * (CharMoveCDO ? CharMoveCDO->GravityScale : 1.f);
+
+    // Script the target path up front: strafing with random direction changes and jumps.
+    // Extra steps past the duration cover the flight of the last shots.
+    const int32 NumShotSteps = FMath::Max(FMath::RoundToInt(Duration / TimeStep), 1);
+    const int32 MaxFlightSteps = FMath::RoundToInt(MaxLeadTime / TimeStep) + 1;
+    const int32 NumSteps = NumShotSteps + MaxFlightSteps;
+
+    TArray<FVector> TargetLocations;
+    TArray<FVector> TargetVelocities;
+    TArray<bool> TargetFalling;
+    TargetLocations.SetNumUninitialized(NumSteps);
+    TargetVelocities.SetNumUninitialized(NumSteps);
+    TargetFalling.SetNumUninitialized(NumSteps);
+
+    FRandomStream Random(RandomSeed);
+    FVector Location(TargetDistance, 0.f, CapsuleHalfHeight);
+    FVector Velocity(0.f, RunSpeed, 0.f);
+    float NextTurnTime = Random.FRandRange(0.3f, 1.2f);
+    float NextJumpTime = Random.FRandRange(0.5f, 2.f);
+    for (int32 i = 0; i < NumSteps; i++)
+    {
+        const float Time = i * TimeStep;
+        bool bFalling = Location.Z > CapsuleHalfHeight;
+        if (Time >= NextTurnTime)
+        {
+            Velocity.Y = -Velocity.Y;
+            NextTurnTime = Time + Random.FRandRange(0.3f, 1.2f);
+        }
+        if (!bFalling && Time >= NextJumpTime)
+        {
+            Velocity.Z = JumpZ;
+            bFalling = true;
+            NextJumpTime = Time + Random.FRandRange(0.5f, 2.f);
+        }
+        TargetLocations[i] = Location;
+        TargetVelocities[i] = Velocity;
+        TargetFalling[i] = bFalling;
+
+        if (bFalling)
+        {
+            Velocity.Z += TargetGravityZ * TimeStep;
+        }
+        Location += Velocity * TimeStep;
+        if (Location.Z <= CapsuleHalfHeight)
+        {
+            Location.Z = CapsuleHalfHeight;
+            Velocity.Z = 0.f;
+        }
+    }
+
+    const FVector StartLocation(0.f, 0.f, CapsuleHalfHeight + CharacterCDO->BaseEyeHeight);
+    const int32 ShotSteps = FMath::Max(FMath::RoundToInt(ShotInterval / TimeStep), 1);
+
+    UE_LOG(LogGame, Log, TEXT("AimTest: %.0f s, target at %.0f uu strafing at %.0f uu/s, shot every %.1f s"), Duration, TargetDistance, RunSpeed, ShotInterval);
+
+    int32 NumClasses = 0;
+    for (TObjectIterator<UClass> It; It; ++It)
+    {
+        UClass* Class = *It;
+        if (!Class->IsChildOf(AUR_Projectile::StaticClass()) || Class->HasAnyClassFlags(CLASS_Abstract | CLASS_NewerVersionExists)
+            || Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+        {
+            continue;
+        }
+
+        const AUR_Projectile* ProjectileCDO = Class->GetDefaultObject<AUR_Projectile>();
+        const UProjectileMovementComponent* ProjMove = ProjectileCDO->ProjectileMovementComponent;
+        if (!ProjMove || ProjMove->InitialSpeed <= 0.f)
+        {
+            continue;
+        }
+
+        const float Speed = ProjMove->InitialSpeed;
+        const float ProjectileGravityZ = WorldGravityZ * ProjMove->ProjectileGravityScale;
+        const float ProjectileRadius = ProjectileCDO->CollisionComponent ? ProjectileCDO->CollisionComponent->GetUnscaledSphereRadius() : 0.f;
+
+        const auto IsHit = [&](const FVector& AimPoint, int32 FireStep)
+        {
+            const FVector Dir = (AimPoint - StartLocation).GetSafeNormal();
+            for (int32 j = 1; j < MaxFlightSteps; j++)
+            {
+                const float T = j * TimeStep;
+                const FVector P = StartLocation + Dir * Speed * T + FVector(0.f, 0.f, 0.5f * ProjectileGravityZ * T * T);
+                if (P.Z < 0.f)
+                {
+                    return false;
+                }
+                const FVector& TargetLocation = TargetLocations[FireStep + j];
+                if (FVector::Dist2D(P, TargetLocation) <= CapsuleRadius + ProjectileRadius && FMath::Abs(P.Z - TargetLocation.Z) <= CapsuleHalfHeight + ProjectileRadius)
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        FUR_TargetMotion Motion;
+        int32 Shots = 0;
+        int32 LeadHits = 0;
+        int32 DirectHits = 0;
+        for (int32 i = 0; i < NumShotSteps; i++)
+        {
+            UpdateMotion(Motion, TargetLocations[i], TargetVelocities[i], TargetFalling[i] ? TargetGravityZ : 0.f, i * TimeStep);
+
+            if (i == 0 || i % ShotSteps != 0)
+            {
+                continue;
+            }
+
+            FVector LeadPoint;
+            float LeadTime;
+            SolveIntercept(Motion, StartLocation, Speed, ProjectileGravityZ, MaxLeadTime, LeadPoint, LeadTime);
+
+            Shots++;
+            LeadHits += IsHit(LeadPoint, i) ? 1 : 0;
+            DirectHits += IsHit(TargetLocations[i], i) ? 1 : 0;
+        }
+
+        NumClasses++;
+        UE_LOG(LogGame, Log, TEXT("  %-40s speed %6.0f  lead %5.1f%%  direct %5.1f%%  (%d shots)"),
+            *Class->GetName(), Speed, 100.f * LeadHits / FMath::Max(Shots, 1), 100.f * DirectHits / FMath::Max(Shots, 1), Shots);
+    }
+
+    if (NumClasses == 0)
+    {
+        UE_LOG(LogGame, Warning, TEXT("AimTest: no projectile classes loaded"));
+    }
+}
@@ -0,0 +1,121 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UR_AITargetPredictionSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Motion state of a single target, sampled once per frame and shared by every bot aiming at it.
+ */
+struct FUR_TargetMotion
+{
+    /** Location at the last sample */
+    FVector Location = FVector::ZeroVector;
+
+    /** Velocity at the last sample */
+    FVector Velocity = FVector::ZeroVector;
+
+    /** Smoothed acceleration on the horizontal plane, estimated from the velocity history */
+    FVector Acceleration = FVector::ZeroVector;
+
+    /** Gravity applied to the target while it is falling, zero otherwise */
+    float GravityZ = 0.f;
+
+    /** World time of the last sample */
+    double SampleTime = 0.0;
+
+    /** World time of the last query - targets nobody asked about for a while are dropped */
+    double LastQueryTime = 0.0;
+
+    /** Number of samples taken, acceleration is only trusted after the second one */
+    int32 NumSamples = 0;
+
+    /** Predicted location after Time seconds */
+    FVector PredictLocation(float Time) const
+    {
+        return Location + Velocity * Time + 0.5f * (Acceleration + FVector(0.f, 0.f, GravityZ)) * FMath::Square(Time);
+    }
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Shared target-motion predictor for AI.
+ *
+ * Every target that bots are aiming at gets its velocity/acceleration sampled once per frame here,
+ * instead of each bot deriving it on its own. Bots then only have to solve their own intercept.
+ */
+UCLASS()
+class OPENTOURNAMENT_API UUR_AITargetPredictionSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    //~UWorldSubsystem interface
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    //~End of UWorldSubsystem interface
+
+    //~FTickableGameObject interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    //~End of FTickableGameObject interface
+
+    /**
+    * Get the shared motion state of a target, starting to track it if it wasn't already.
+    * Newly tracked targets are sampled immediately.
+    */
+    const FUR_TargetMotion& GetTargetMotion(const AActor* Target);
+
+    /**
+    * Calculate where a projectile fired from StartLocation should be aimed to hit Target.
+    * ProjectileSpeed <= 0 means hitscan, and the current location is returned.
+    * ProjectileGravityZ is the (usually negative) gravity applied to the projectile.
+    */
+    FVector GetInterceptPoint(const AActor* Target, const FVector& StartLocation, float ProjectileSpeed, float ProjectileGravityZ = 0.f);
+
+    /**
+    * Solve a projectile intercept against a given motion state. Deterministic and side-effect free.
+    * Returns false if the projectile can't catch up, in which case OutAimPoint is the best-effort lead.
+    */
+    static bool SolveIntercept(const FUR_TargetMotion& Motion, const FVector& StartLocation, float ProjectileSpeed, float ProjectileGravityZ, float MaxTime, FVector& OutAimPoint, float& OutTime);
+
+    /**
+    * Feed a new sample into a motion state.
+    * Acceleration is only estimated on the horizontal plane; vertical motion of a falling target follows GravityZ.
+    */
+    void UpdateMotion(FUR_TargetMotion& Motion, const FVector& Location, const FVector& Velocity, float GravityZ, double Now) const;
+
+    /**
+    * Deterministic aim test, backs the OT.AI.AimTest console command.
+    * A scripted target strafes and jumps in front of a shooter; for every loaded projectile class,
+    * log the hit rate when leading with the predictor and when aiming at the current location.
+    */
+    void RunAimTest(float Duration) const;
+
+protected:
+
+    void SampleTarget(const AActor* Target, FUR_TargetMotion& Motion, double Now) const;
+
+    TMap<TWeakObjectPtr<const AActor>, FUR_TargetMotion> Targets;
+
+    /** Targets that haven't been queried for this long are no longer sampled */
+    float TargetExpireTime = 2.f;
+
+    /** Smoothing factor of the acceleration estimate, 0 = frozen, 1 = raw */
+    float AccelerationSmoothing = 0.3f;
+
+    /** Acceleration estimates are clamped to this magnitude, to filter out teleports and landings */
+    float MaxAcceleration = 4000.f;
+
+    /** Maximum lead time considered when solving an intercept */
+    float MaxLeadTime = 2.f;
+};
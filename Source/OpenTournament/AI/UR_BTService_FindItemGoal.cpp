@@ -0,0 +1,44 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_BTService_FindItemGoal.h"
+
+#include "AIController.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+
+#include "UR_AITacticalSubsystem.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_BTService_FindItemGoal)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+UUR_BTService_FindItemGoal::UUR_BTService_FindItemGoal()
+{
+    NodeName = TEXT("Find Item Goal");
+    Interval = 0.5f;
+    RandomDeviation = 0.1f;
+
+    BlackboardKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(ThisClass, BlackboardKey), AActor::StaticClass());
+}
+
+void UUR_BTService_FindItemGoal::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+    Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
+
+    const AAIController* AIController = OwnerComp.GetAIOwner();
+    const APawn* Pawn = AIController ? AIController->GetPawn() : nullptr;
+    UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+    auto TacticalSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UUR_AITacticalSubsystem>() : nullptr;
+    if (!Pawn || !Blackboard || !TacticalSubsystem)
+    {
+        return;
+    }
+
+    float Score = 0.f;
+    AActor* Item = TacticalSubsystem->FindBestItemGoal(Pawn->GetActorLocation(), SearchRadius, Score);
+    Blackboard->SetValueAsObject(GetSelectedBlackboardKey(), (Item && Score > MinScore) ? Item : nullptr);
+}
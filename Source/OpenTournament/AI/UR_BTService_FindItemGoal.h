@@ -0,0 +1,39 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/Services/BTService_BlackboardBase.h"
+
+#include "UR_BTService_FindItemGoal.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Keeps the blackboard key set to the best item around the bot,
+ * looked up in the tactical influence map (UUR_AITacticalSubsystem::FindBestItemGoal).
+ * The key is cleared when no item scores above MinScore.
+ */
+UCLASS()
+class OPENTOURNAMENT_API UUR_BTService_FindItemGoal : public UBTService_BlackboardBase
+{
+    GENERATED_BODY()
+
+public:
+
+    UUR_BTService_FindItemGoal();
+
+    /** Only items within this distance are considered */
+    UPROPERTY(EditAnywhere, Category = "Goal")
+    float SearchRadius = 4000.f;
+
+    /** Items scoring below this are ignored */
+    UPROPERTY(EditAnywhere, Category = "Goal")
+    float MinScore = 0.f;
+
+protected:
+
+    virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+};
@@ -8,9 +8,11 @@
 #include "TimerManager.h"
 #include "GameFramework/PlayerState.h"
 #include "GameFramework/GameModeBase.h"
+#include "NavFilters/NavigationQueryFilter.h"
 
 #include "UR_AIAimComp.h"
 #include "UR_AINavigationJumpingComp.h"
+#include "UR_AITacticalSubsystem.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -75,3 +77,29 @@ FVector AUR_BotController::GetFocalPointOnActor(const AActor* Actor) const
 {
     return AimComponent->ApplyAimCorrectionForTargetActor(this, Actor);
 }
+
+void AUR_BotController::FindPathForMoveRequest(const FAIMoveRequest& MoveRequest, FPathFindingQuery& Query, FNavPathSharedPtr& OutPath) const
+{
+    // Custom filters change the result, only share default queries.
+    // The filter may also come from DefaultNavigationFilterClass, so check the one actually in the query.
+    // Cached paths are never partial, so queries that forbid partial paths would still get one on a miss.
+    auto TacticalSubsystem = GetWorld()->GetSubsystem<UUR_AITacticalSubsystem>();
+    const ANavigationData* NavData = Query.NavData.Get();
+    if (!TacticalSubsystem || !GetPawn() || !NavData || MoveRequest.GetNavigationFilter() || !Query.bAllowPartialPaths
+        || Query.QueryFilter != UNavigationQueryFilter::GetQueryFilter(*NavData, GetPawn(), nullptr))
+    {
+        Super::FindPathForMoveRequest(MoveRequest, Query, OutPath);
+        return;
+    }
+
+    FNavPathSharedPtr Path = TacticalSubsystem->FindPathCached(GetPawn(), Query.StartLocation, Query.EndLocation, NavData);
+    if (Path.IsValid())
+    {
+        if (MoveRequest.IsMoveToActorRequest())
+        {
+            Path->SetGoalActorObservation(*MoveRequest.GetGoalActor(), 100.0f);
+        }
+        Path->EnableRecalculationOnInvalidation(true);
+        OutPath = Path;
+    }
+}
@@ -29,6 +29,7 @@ protected:
     virtual void OnNewPawnHandler(APawn* P);
     virtual void UpdateControlRotation(float DeltaTime, bool bUpdatePawn) override;
     virtual FVector GetFocalPointOnActor(const AActor* Actor) const override;
+    virtual void FindPathForMoveRequest(const FAIMoveRequest& MoveRequest, FPathFindingQuery& Query, FNavPathSharedPtr& OutPath) const override;
 
 public:
 
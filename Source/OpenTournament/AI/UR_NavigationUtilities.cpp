@@ -6,6 +6,10 @@
 #include "AIController.h"
 #include "NavLinkCustomComponent.h"
 
+DECLARE_STATS_GROUP(TEXT("OT Navigation"), STATGROUP_OTNavigation, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("ForceReachedDestinationWithin"), STAT_ForceReachedDestinationWithin, STATGROUP_OTNavigation);
+DECLARE_CYCLE_STAT(TEXT("IsTraversingLinkLTR"), STAT_IsTraversingLinkLTR, STATGROUP_OTNavigation);
+
 // le sigh
 class UPathFollowingComponentAccessHack : UPathFollowingComponent
 {
@@ -19,6 +23,8 @@ public:
 
 void UUR_NavigationUtilities::ForceReachedDestinationWithin(APawn* Pawn, const FBoxSphereBounds& Bounds, bool bSphereBounds)
 {
+    SCOPE_CYCLE_COUNTER(STAT_ForceReachedDestinationWithin);
+
     if (Pawn)
     {
         if (auto AIController = Pawn->GetController<AAIController>())
@@ -44,6 +50,8 @@ void UUR_NavigationUtilities::ForceReachedDestinationWithin(APawn* Pawn, const F
 
 bool UUR_NavigationUtilities::IsTraversingLinkLTR(const FVector& Dest, const AActor* SmartLinkContainer, const float ZTolerance)
 {
+    SCOPE_CYCLE_COUNTER(STAT_IsTraversingLinkLTR);
+
     // SmartLinkComp is private in NavLinkProxy, so we use this..........
     if (auto SmartLinkComp = SmartLinkContainer->FindComponentByClass<UNavLinkCustomComponent>())
     {
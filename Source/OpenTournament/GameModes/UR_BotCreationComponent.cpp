@@ -10,13 +10,25 @@
 
 #include "UR_DeveloperSettings.h"
 #include "UR_GameMode.h"
+#include "UR_LogChannels.h"
 #include "GameModes/UR_ExperienceManagerComponent.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(UR_BotCreationComponent)
 
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT Bots"), STATGROUP_OTBots, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Spawn Pending Bots"), STAT_SpawnPendingBots, STATGROUP_OTBots);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pending Bots"), STAT_NumPendingBots, STATGROUP_OTBots);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Worst Frame Bot Spawn (ms)"), STAT_WorstFrameBotSpawnMs, STATGROUP_OTBots);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
 UUR_BotCreationComponent::UUR_BotCreationComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 }
 
 void UUR_BotCreationComponent::BeginPlay()
@@ -40,6 +52,25 @@ void UUR_BotCreationComponent::OnExperienceLoaded(const UUR_ExperienceDefinition
 #endif
 }
 
+void UUR_BotCreationComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+#if WITH_SERVER_CODE
+	SpawnPendingBots();
+#endif
+}
+
+bool UUR_BotCreationComponent::ShouldShowLoadingScreen(FString& OutReason) const
+{
+	if (bCreateBotsDuringLoadingScreen && NumPendingBots > 0)
+	{
+		OutReason = FString::Printf(TEXT("Creating bots (%d remaining)"), NumPendingBots);
+		return true;
+	}
+	return false;
+}
+
 #if WITH_SERVER_CODE
 
 void UUR_BotCreationComponent::ServerCreateBots()
@@ -70,10 +101,55 @@ void UUR_BotCreationComponent::ServerCreateBots()
 		EffectiveBotCount = UGameplayStatics::GetIntOption(GameModeBase->OptionsString, TEXT("NumBots"), EffectiveBotCount);
 	}
 
-	// Create them
-	for (int32 Count = 0; Count < EffectiveBotCount; ++Count)
+	// Create them over the next frames
+	NumPendingBots = FMath::Max(0, EffectiveBotCount);
+	WorstFrameSpawnTimeMs = 0.0;
+	SET_DWORD_STAT(STAT_NumPendingBots, NumPendingBots);
+	SET_FLOAT_STAT(STAT_WorstFrameBotSpawnMs, 0.f);
+
+	if (NumPendingBots > 0)
+	{
+		SpawnPendingBots();
+	}
+}
+
+void UUR_BotCreationComponent::SpawnPendingBots()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SpawnPendingBots);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double BudgetSeconds = BotSpawnBudgetPerFrameMs / 1000.0;
+
+	int32 NumSpawnedThisFrame = 0;
+	while (NumPendingBots > 0)
 	{
 		SpawnOneBot();
+		--NumPendingBots;
+		++NumSpawnedThisFrame;
+
+		if (MaxBotsPerFrame > 0 && NumSpawnedThisFrame >= MaxBotsPerFrame)
+		{
+			break;
+		}
+		if (BudgetSeconds > 0.0 && FPlatformTime::Seconds() - StartTime >= BudgetSeconds)
+		{
+			break;
+		}
+	}
+
+	const double FrameSpawnTimeMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	if (FrameSpawnTimeMs > WorstFrameSpawnTimeMs)
+	{
+		WorstFrameSpawnTimeMs = FrameSpawnTimeMs;
+		SET_FLOAT_STAT(STAT_WorstFrameBotSpawnMs, WorstFrameSpawnTimeMs);
+	}
+	SET_DWORD_STAT(STAT_NumPendingBots, NumPendingBots);
+
+	SetComponentTickEnabled(NumPendingBots > 0);
+
+	if (NumPendingBots == 0)
+	{
+		UE_LOG(LogGame, Log, TEXT("Created %d bots, worst frame spawn time: %.2f ms"), SpawnedBotList.Num(), WorstFrameSpawnTimeMs);
 	}
 }
 
@@ -127,6 +203,15 @@ void UUR_BotCreationComponent::SpawnOneBot()
 
 void UUR_BotCreationComponent::RemoveOneBot()
 {
+	// Cancel a bot that hasn't been created yet before removing a live one
+	if (NumPendingBots > 0)
+	{
+		--NumPendingBots;
+		SET_DWORD_STAT(STAT_NumPendingBots, NumPendingBots);
+		SetComponentTickEnabled(NumPendingBots > 0);
+		return;
+	}
+
 	if (SpawnedBotList.Num() > 0)
 	{
 		// Right now this removes a random bot as they're all the same; could prefer to remove one
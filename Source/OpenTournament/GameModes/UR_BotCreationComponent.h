@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Components/GameStateComponent.h"
+#include "LoadingProcessInterface.h"
 
 #include "UR_BotCreationComponent.generated.h"
 
@@ -12,7 +13,9 @@ class UUR_ExperienceDefinition;
 class AAIController;
 
 UCLASS(Blueprintable, Abstract)
-class UUR_BotCreationComponent : public UGameStateComponent
+class UUR_BotCreationComponent
+	: public UGameStateComponent
+	, public ILoadingProcessInterface
 {
 	GENERATED_BODY()
 
@@ -21,8 +24,13 @@ public:
 
 	//~UActorComponent interface
 	virtual void BeginPlay() override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	//~End of UActorComponent interface
 
+	//~ILoadingProcessInterface interface
+	virtual bool ShouldShowLoadingScreen(FString& OutReason) const override;
+	//~End of ILoadingProcessInterface
+
 private:
 	void OnExperienceLoaded(const UUR_ExperienceDefinition* Experience);
 
@@ -38,6 +46,34 @@ protected:
 
 	TArray<FString> RemainingBotNames;
 
+	/**
+	* Maximum number of bots created in a single frame when the match starts.
+	* Spawning a bot creates a controller, player state and pawn with inventory, so we spread them over several frames.
+	* 0 = no limit (only the time budget applies).
+	*/
+	UPROPERTY(EditDefaultsOnly, Category=Performance, meta=(ClampMin=0))
+	int32 MaxBotsPerFrame = 2;
+
+	/**
+	* Time budget (ms) spent creating bots per frame. At least one bot is always created per frame.
+	* 0 = no limit (only the count limit applies).
+	*/
+	UPROPERTY(EditDefaultsOnly, Category=Performance, meta=(ClampMin=0, Units="ms"))
+	float BotSpawnBudgetPerFrameMs = 4.f;
+
+	/**
+	* Keep the loading screen up until all initial bots have been created.
+	* Bots are still created over multiple frames, but the hitches are hidden behind the loading screen.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category=Performance)
+	bool bCreateBotsDuringLoadingScreen = false;
+
+	/** Number of initial bots still waiting to be created */
+	int32 NumPendingBots = 0;
+
+	/** Worst single-frame bot creation time (ms) for this match */
+	double WorstFrameSpawnTimeMs = 0.0;
+
 protected:
 	UPROPERTY(Transient)
 	TArray<TObjectPtr<AAIController>> SpawnedBotList;
@@ -50,6 +86,9 @@ public:
 protected:
 	virtual void ServerCreateBots();
 
+	/** Create pending bots until the per-frame count or time budget is exhausted */
+	void SpawnPendingBots();
+
 	virtual void SpawnOneBot();
 	virtual void RemoveOneBot();
 
@@ -4,11 +4,51 @@
 
 #include "GameVerbMessageReplication.h"
 
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
 #include "GameFramework/GameplayMessageSubsystem.h"
+#include "Net/DataReplication.h"
 #include "Messages/GameVerbMessage.h"
+#include "UR_LogChannels.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(GameVerbMessageReplication)
 
+//////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT Verb Messages"), STATGROUP_OTVerbMessages, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Current Messages"), STAT_VerbMessagesCurrent, STATGROUP_OTVerbMessages);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pruned Messages"), STAT_VerbMessagesPruned, STATGROUP_OTVerbMessages);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Delta Bytes Sent"), STAT_VerbMessagesDeltaBytes, STATGROUP_OTVerbMessages);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Bytes Per Message"), STAT_VerbMessagesBytesPerMessage, STATGROUP_OTVerbMessages);
+
+namespace OTConsoleVariables
+{
+	static FAutoConsoleCommandWithWorldAndArgs CmdVerbMessagesSoak(
+		TEXT("OT.VerbMessages.Soak"),
+		TEXT("Simulate a long match of verb messages through delta serialization and check the container size stays flat. Needs a connected net game. Optional args: minutes (default 60), messages per second (default 5)."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			const int32 Minutes = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 2) : 60;
+			const double Rate = Args.Num() > 1 ? FMath::Max(FCString::Atod(*Args[1]), 0.1) : 5.0;
+
+			UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+			UNetConnection* Connection = NetDriver ? (NetDriver->ServerConnection ? NetDriver->ServerConnection.Get() : (NetDriver->ClientConnections.Num() > 0 ? NetDriver->ClientConnections[0].Get() : nullptr)) : nullptr;
+			if (!Connection || !Connection->PackageMap)
+			{
+				UE_LOG(LogGame, Warning, TEXT("OT.VerbMessages.Soak: needs a net driver with a connection, start a listen server or connect a client"));
+				return;
+			}
+
+			// Requested rate hits the count cap if high enough, the low rate stays under it and relies on age expiry
+			const double LowRate = 0.5 * FGameVerbMessageReplication::DefaultMaxMessages / FGameVerbMessageReplication::DefaultMaxMessageAge;
+			const bool bRequested = FGameVerbMessageReplication::Soak(NetDriver, Connection->PackageMap, Minutes, Rate, false);
+			const bool bLowRate = FGameVerbMessageReplication::Soak(NetDriver, Connection->PackageMap, Minutes, LowRate, true);
+
+			UE_LOG(LogGame, Log, TEXT("OT.VerbMessages.Soak: %s"), (bRequested && bLowRate) ? TEXT("PASS") : TEXT("FAIL"));
+		}));
+}
+
 //////////////////////////////////////////////////////////////////////
 // FGameVerbMessageReplicationEntry
 
@@ -20,10 +60,196 @@ FString FGameVerbMessageReplicationEntry::GetDebugString() const
 //////////////////////////////////////////////////////////////////////
 // FGameVerbMessageReplication
 
+void FGameVerbMessageReplication::SetLimits(int32 InMaxMessages, double InMaxAge)
+{
+	MaxMessages = FMath::Max(InMaxMessages, 1);
+	MaxMessageAge = InMaxAge;
+
+	if (CurrentMessages.Num() > MaxMessages)
+	{
+		RemoveOldest(CurrentMessages.Num() - MaxMessages);
+	}
+}
+
 void FGameVerbMessageReplication::AddMessage(const FGameVerbMessage& Message)
 {
-	FGameVerbMessageReplicationEntry& NewStack = CurrentMessages.Emplace_GetRef(Message);
+	AddMessageAt(Message, GetServerTime());
+}
+
+void FGameVerbMessageReplication::AddMessageAt(const FGameVerbMessage& Message, double Time)
+{
+	PruneExpiredMessages(Time);
+
+	if (CurrentMessages.Num() >= MaxMessages)
+	{
+		RemoveOldest(CurrentMessages.Num() - MaxMessages + 1);
+	}
+
+	FGameVerbMessageReplicationEntry& NewStack = CurrentMessages.Emplace_GetRef(Message, Time);
 	MarkItemDirty(NewStack);
+
+	SET_DWORD_STAT(STAT_VerbMessagesCurrent, CurrentMessages.Num());
+}
+
+void FGameVerbMessageReplication::PruneExpiredMessages(double Time)
+{
+	if (MaxMessageAge <= 0.0)
+	{
+		return;
+	}
+
+	// Messages are in insertion order, so expired ones are at the front
+	int32 NumExpired = 0;
+	while (NumExpired < CurrentMessages.Num() && Time - CurrentMessages[NumExpired].AddTime > MaxMessageAge)
+	{
+		NumExpired++;
+	}
+	RemoveOldest(NumExpired);
+}
+
+void FGameVerbMessageReplication::RemoveOldest(int32 NumToRemove)
+{
+	if (NumToRemove > 0)
+	{
+		CurrentMessages.RemoveAt(0, NumToRemove, false);
+		MarkArrayDirty();
+
+		INC_DWORD_STAT_BY(STAT_VerbMessagesPruned, NumToRemove);
+		SET_DWORD_STAT(STAT_VerbMessagesCurrent, CurrentMessages.Num());
+	}
+}
+
+double FGameVerbMessageReplication::GetServerTime() const
+{
+	const UWorld* World = Owner ? Owner->GetWorld() : nullptr;
+	return World ? World->GetTimeSeconds() : 0.0;
+}
+
+bool FGameVerbMessageReplication::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+#if STATS
+	if (DeltaParms.Writer)
+	{
+		// Count the messages this delta sends, ie. new or changed since the connection's last state
+		int32 NumSent = CurrentMessages.Num();
+		if (const FNetFastTArrayBaseState* OldState = static_cast<const FNetFastTArrayBaseState*>(DeltaParms.OldState))
+		{
+			NumSent = 0;
+			for (const FGameVerbMessageReplicationEntry& Entry : CurrentMessages)
+			{
+				const int32* OldKey = OldState->IDToCLMap.Find(Entry.ReplicationID);
+				NumSent += (!OldKey || *OldKey != Entry.ReplicationKey) ? 1 : 0;
+			}
+		}
+
+		const int64 StartBits = DeltaParms.Writer->GetNumBits();
+		const bool bResult = FFastArraySerializer::FastArrayDeltaSerialize<FGameVerbMessageReplicationEntry, FGameVerbMessageReplication>(CurrentMessages, DeltaParms, *this);
+		const int64 NumBytes = (DeltaParms.Writer->GetNumBits() - StartBits + 7) / 8;
+
+		if (bResult && NumSent > 0)
+		{
+			INC_DWORD_STAT_BY(STAT_VerbMessagesDeltaBytes, NumBytes);
+			SET_FLOAT_STAT(STAT_VerbMessagesBytesPerMessage, (float)NumBytes / NumSent);
+		}
+		return bResult;
+	}
+#endif
+
+	return FFastArraySerializer::FastArrayDeltaSerialize<FGameVerbMessageReplicationEntry, FGameVerbMessageReplication>(CurrentMessages, DeltaParms, *this);
+}
+
+bool FGameVerbMessageReplication::Soak(UNetDriver* NetDriver, UPackageMap* PackageMap, int32 Minutes, double MessagesPerSecond, bool bExpectExpiry)
+{
+	FGameVerbMessageReplication Container;
+	FGameVerbMessage Message;
+
+	FNetSerializeCB SerializeCB(NetDriver);
+	TSharedPtr<INetDeltaBaseState> OldState;
+
+	// Let the container fill up for a minute, it must not grow after that
+	const double WarmupTime = 60.0;
+	const double NetUpdateInterval = 0.1;
+	SIZE_T WarmupSize = 0;
+	SIZE_T PeakSize = 0;
+	int32 PeakNum = 0;
+	int32 NumMessages = 0;
+	int64 TotalBytes = 0;
+	int32 NumErrors = 0;
+
+	const int32 NumUpdates = FMath::CeilToInt(Minutes * 60.0 / NetUpdateInterval);
+	for (int32 i = 0; i < NumUpdates; i++)
+	{
+		const double Time = i * NetUpdateInterval;
+
+		// Owners prune on a timer, see the class comment
+		Container.PruneExpiredMessages(Time);
+		while (NumMessages < (Time + NetUpdateInterval) * MessagesPerSecond)
+		{
+			Message.Magnitude = NumMessages;
+			Container.AddMessageAt(Message, Time);
+			NumMessages++;
+		}
+
+		FNetBitWriter Writer(PackageMap, 0);
+		TSharedPtr<INetDeltaBaseState> NewState;
+		FNetDeltaSerializeInfo Parms;
+		Parms.Writer = &Writer;
+		Parms.Map = PackageMap;
+		Parms.OldState = OldState.Get();
+		Parms.NewState = &NewState;
+		Parms.NetSerializeCB = &SerializeCB;
+		// Returns false when nothing changed since the previous state, which stays current
+		const bool bSent = Container.NetDeltaSerialize(Parms);
+		if (Writer.IsError())
+		{
+			UE_LOG(LogGame, Warning, TEXT("OT.VerbMessages.Soak: writer error at %.1f s"), Time);
+			NumErrors++;
+			break;
+		}
+		if (bSent && NewState.IsValid())
+		{
+			TotalBytes += Writer.GetNumBytes();
+			OldState = NewState;
+		}
+
+		const FNetFastTArrayBaseState* DeltaState = static_cast<const FNetFastTArrayBaseState*>(OldState.Get());
+		const SIZE_T Size = Container.GetAllocatedSize() + (DeltaState ? DeltaState->IDToCLMap.GetAllocatedSize() : 0);
+		PeakNum = FMath::Max(PeakNum, Container.Num());
+		if (Time < WarmupTime)
+		{
+			WarmupSize = FMath::Max(WarmupSize, Size);
+		}
+		else
+		{
+			PeakSize = FMath::Max(PeakSize, Size);
+		}
+	}
+
+	if (PeakNum > DefaultMaxMessages)
+	{
+		UE_LOG(LogGame, Warning, TEXT("OT.VerbMessages.Soak: %d entries, above the cap of %d"), PeakNum, DefaultMaxMessages);
+		NumErrors++;
+	}
+	if (PeakSize > WarmupSize)
+	{
+		UE_LOG(LogGame, Warning, TEXT("OT.VerbMessages.Soak: grew to %llu bytes after warmup (%llu during)"), (uint64)PeakSize, (uint64)WarmupSize);
+		NumErrors++;
+	}
+	if (bExpectExpiry)
+	{
+		// Expiry keeps one age window of messages, plus those of the current update
+		const int32 MaxExpected = FMath::CeilToInt((DefaultMaxMessageAge + NetUpdateInterval) * MessagesPerSecond) + 1;
+		if (PeakNum >= DefaultMaxMessages || PeakNum > MaxExpected)
+		{
+			UE_LOG(LogGame, Warning, TEXT("OT.VerbMessages.Soak: %d entries at %.2f msg/s, age expiry should keep at most %d"), PeakNum, MessagesPerSecond, MaxExpected);
+			NumErrors++;
+		}
+	}
+
+	UE_LOG(LogGame, Log, TEXT("OT.VerbMessages.Soak: %d messages over %d min at %.2f msg/s, peak %d entries, %llu bytes after warmup (%llu during), %.1f bytes/s sent, %d errors"),
+		NumMessages, Minutes, MessagesPerSecond, PeakNum, (uint64)PeakSize, (uint64)WarmupSize, TotalBytes / (Minutes * 60.0), NumErrors);
+
+	return NumErrors == 0;
 }
 
 void FGameVerbMessageReplication::PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize)
@@ -10,7 +10,9 @@
 
 #include "GameVerbMessageReplication.generated.h"
 
+class UNetDriver;
 class UObject;
+class UPackageMap;
 struct FGameVerbMessageReplication;
 struct FNetDeltaSerializeInfo;
 
@@ -25,8 +27,9 @@ struct FGameVerbMessageReplicationEntry : public FFastArraySerializerItem
 	FGameVerbMessageReplicationEntry()
 	{}
 
-	FGameVerbMessageReplicationEntry(const FGameVerbMessage& InMessage)
+	FGameVerbMessageReplicationEntry(const FGameVerbMessage& InMessage, double InAddTime)
 		: Message(InMessage)
+		, AddTime(InAddTime)
 	{
 	}
 
@@ -37,9 +40,24 @@ private:
 
 	UPROPERTY()
 	FGameVerbMessage Message;
+
+	// Server time the message was added at, for expiry
+	UPROPERTY(NotReplicated)
+	double AddTime = 0.0;
 };
 
-/** Container of verb messages to replicate */
+/**
+ * Container of verb messages to replicate.
+ * Bounded: the oldest messages are dropped beyond MaxMessages, and messages older than MaxMessageAge expire.
+ * Removals mark the array dirty so clients get the deletes, and late joiners only receive recent messages.
+ *
+ * NOTE: Not used by any actor yet, nothing in the game replicates verb messages at the moment.
+ * Expiry only runs when a message is added, so an owner must also call PruneExpiredMessages on a server timer
+ * (e.g. every MaxMessageAge / 2), otherwise the last messages of a quiet period replay to late joiners.
+ * An owner is expected to:
+ * - call SetOwner in its constructor, and SetLimits if the defaults don't fit,
+ * - replicate the container, and prune it on a timer as above.
+ */
 USTRUCT(BlueprintType)
 struct FGameVerbMessageReplication : public FFastArraySerializer
 {
@@ -52,23 +70,54 @@ struct FGameVerbMessageReplication : public FFastArraySerializer
 public:
 	void SetOwner(UObject* InOwner) { Owner = InOwner; }
 
+	// Set the bounds, MaxAge <= 0 disables expiry
+	void SetLimits(int32 InMaxMessages, double InMaxAge);
+
 	// Broadcasts a message from server to clients
 	void AddMessage(const FGameVerbMessage& Message);
 
+	// Same as AddMessage, with an explicit server time
+	void AddMessageAt(const FGameVerbMessage& Message, double Time);
+
+	// Remove messages older than MaxMessageAge. Owners must call this periodically on the server, see above.
+	void PruneExpiredMessages(double Time);
+
+	int32 Num() const { return CurrentMessages.Num(); }
+
+	// Entries and the fast array serializer maps
+	SIZE_T GetAllocatedSize() const
+	{
+		return CurrentMessages.GetAllocatedSize() + ItemMap.GetAllocatedSize() + GuidReferencesMap.GetAllocatedSize() + GuidReferencesMap_StructDelta.GetAllocatedSize();
+	}
+
 	//~FFastArraySerializer contract
 	void PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize);
 	void PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize);
 	void PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize);
 	//~End of FFastArraySerializer contract
 
-	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
-	{
-		return FFastArraySerializer::FastArrayDeltaSerialize<FGameVerbMessageReplicationEntry, FGameVerbMessageReplication>(CurrentMessages, DeltaParms, *this);
-	}
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+
+	// Defaults for SetLimits
+	static constexpr int32 DefaultMaxMessages = 32;
+	static constexpr double DefaultMaxMessageAge = 10.0;
+
+	/**
+	 * Simulate a match of verb messages on a standalone container, delta serialized for one connection
+	 * at 10 Hz, and check that its memory stays flat and its entries stay bounded.
+	 * With bExpectExpiry the rate must be low enough that age expiry bounds the container before the count cap.
+	 * Backs the OT.VerbMessages.Soak console command.
+	 */
+	static bool Soak(UNetDriver* NetDriver, UPackageMap* PackageMap, int32 Minutes, double MessagesPerSecond, bool bExpectExpiry);
 
 private:
 	void RebroadcastMessage(const FGameVerbMessage& Message);
 
+	// Remove the NumToRemove oldest messages
+	void RemoveOldest(int32 NumToRemove);
+
+	double GetServerTime() const;
+
 private:
 	// Replicated list of gameplay tag stacks
 	UPROPERTY()
@@ -77,6 +126,12 @@ private:
 	// Owner (for a route to a world)
 	UPROPERTY()
 	TObjectPtr<UObject> Owner = nullptr;
+
+	UPROPERTY(NotReplicated)
+	int32 MaxMessages = DefaultMaxMessages;
+
+	UPROPERTY(NotReplicated)
+	double MaxMessageAge = DefaultMaxMessageAge;
 };
 
 template<>
@@ -27,6 +27,7 @@ public class OpenTournament : ModuleRules
                 "GameplayTasks",
                 "MoviePlayer",
                 "NetCore",
+                "ReplicationGraph",
                 "Niagara",
                 "SoundFieldRendering", // Linux needs a symbold that it cannot find so we try to link this library by force.
                 "Paper2D",
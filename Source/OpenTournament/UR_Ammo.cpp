@@ -79,6 +79,12 @@ void AUR_Ammo::SetAmmoCount(int32 NewAmmoCount)
 		int32 OldAmmoCount = AmmoCount;
 		AmmoCount = NewAmmoCount;
 		OnRep_AmmoCount(OldAmmoCount);
+
+		auto Char = Cast<AUR_Character>(GetOwner());
+		if (Char && Char->InventoryComponent)
+		{
+			Char->InventoryComponent->NotifyAmmoCountChanged(this);
+		}
 	}
 }
 
@@ -89,6 +95,7 @@ void AUR_Ammo::OnRep_AmmoCount(int32 OldAmmoCount)
 		auto Char = Cast<AUR_Character>(GetOwner());
 		if (Char && Char->InventoryComponent)
 		{
+			Char->InventoryComponent->RefreshWeaponSwitchAmmo(this);
 			Char->InventoryComponent->OnAmmoUpdated.Broadcast(Char->InventoryComponent, this);
 
 			if (Char->InventoryComponent->ActiveWeapon && Char->InventoryComponent->ActiveWeapon->AmmoRefs.Contains(this))
@@ -19,6 +19,7 @@
 * Describes a type of ammo, and acts as a container when instanced.
 * Ammo types classes are referenced by ammo bases and weapons.
 * Ammo types are instanced and stored in their own array in InventoryComponent, independently from weapons.
+* With compact ammo storage, instances are local (not replicated) and counts are replicated by the inventory.
 * Weapons can make use of multiple ammo types.
 * An ammo type can be shared across multiple weapons.
 */
@@ -0,0 +1,84 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_AmmoState.h"
+
+#include "UR_Ammo.h"
+#include "UR_InventoryComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_AmmoState)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+int32 FUR_AmmoState::GetAmmoCount(TSubclassOf<AUR_Ammo> AmmoClass) const
+{
+    for (const FUR_AmmoSlot& Slot : Slots)
+    {
+        if (Slot.AmmoClass == AmmoClass)
+        {
+            return Slot.AmmoCount;
+        }
+    }
+    return 0;
+}
+
+void FUR_AmmoState::SetAmmoCount(TSubclassOf<AUR_Ammo> AmmoClass, int32 AmmoCount)
+{
+    for (FUR_AmmoSlot& Slot : Slots)
+    {
+        if (Slot.AmmoClass == AmmoClass)
+        {
+            if (Slot.AmmoCount != AmmoCount)
+            {
+                Slot.AmmoCount = static_cast<int16>(AmmoCount);
+                MarkItemDirty(Slot);
+            }
+            return;
+        }
+    }
+
+    MarkItemDirty(Slots.Emplace_GetRef(AmmoClass, AmmoCount));
+}
+
+void FUR_AmmoState::Reset()
+{
+    if (Slots.Num() > 0)
+    {
+        Slots.Empty();
+        MarkArrayDirty();
+    }
+}
+
+void FUR_AmmoState::PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize)
+{
+    if (Owner)
+    {
+        for (int32 Index : RemovedIndices)
+        {
+            Owner->OnRep_AmmoSlot(Slots[Index].AmmoClass, 0);
+        }
+    }
+}
+
+void FUR_AmmoState::PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize)
+{
+    if (Owner)
+    {
+        for (int32 Index : AddedIndices)
+        {
+            Owner->OnRep_AmmoSlot(Slots[Index].AmmoClass, Slots[Index].AmmoCount);
+        }
+    }
+}
+
+void FUR_AmmoState::PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize)
+{
+    if (Owner)
+    {
+        for (int32 Index : ChangedIndices)
+        {
+            Owner->OnRep_AmmoSlot(Slots[Index].AmmoClass, Slots[Index].AmmoCount);
+        }
+    }
+}
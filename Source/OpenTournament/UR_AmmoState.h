@@ -0,0 +1,94 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+
+#include "UR_AmmoState.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+class AUR_Ammo;
+class UUR_InventoryComponent;
+struct FUR_AmmoState;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Ammo count for one ammo type.
+ */
+USTRUCT()
+struct FUR_AmmoSlot : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    FUR_AmmoSlot()
+        : AmmoClass(nullptr)
+        , AmmoCount(0)
+    {}
+
+    FUR_AmmoSlot(TSubclassOf<AUR_Ammo> InAmmoClass, int32 InAmmoCount)
+        : AmmoClass(InAmmoClass)
+        , AmmoCount(static_cast<int16>(InAmmoCount))
+    {}
+
+    UPROPERTY()
+    TSubclassOf<AUR_Ammo> AmmoClass;
+
+    /** Ammo counts are capped to 999 (see AUR_Ammo::SetAmmoCount) */
+    UPROPERTY()
+    int16 AmmoCount;
+};
+
+/**
+ * Packed ammo counts of an inventory, replicated in one property.
+ * Only slots that changed are sent.
+ */
+USTRUCT()
+struct FUR_AmmoState : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    void SetOwner(UUR_InventoryComponent* InOwner) { Owner = InOwner; }
+
+    int32 GetAmmoCount(TSubclassOf<AUR_Ammo> AmmoClass) const;
+
+    /** Authority only. Add or update the slot of given ammo class. */
+    void SetAmmoCount(TSubclassOf<AUR_Ammo> AmmoClass, int32 AmmoCount);
+
+    /** Authority only. Remove all slots. */
+    void Reset();
+
+    int32 Num() const { return Slots.Num(); }
+
+    //~FFastArraySerializer contract
+    void PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize);
+    void PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize);
+    void PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize);
+    //~End of FFastArraySerializer contract
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+    {
+        return FFastArraySerializer::FastArrayDeltaSerialize<FUR_AmmoSlot, FUR_AmmoState>(Slots, DeltaParms, *this);
+    }
+
+private:
+
+    UPROPERTY()
+    TArray<FUR_AmmoSlot> Slots;
+
+    UPROPERTY(NotReplicated)
+    TObjectPtr<UUR_InventoryComponent> Owner = nullptr;
+};
+
+template<>
+struct TStructOpsTypeTraits<FUR_AmmoState> : public TStructOpsTypeTraitsBase2<FUR_AmmoState>
+{
+    enum
+    {
+        WithNetDeltaSerializer = true,
+    };
+};
@@ -38,10 +38,35 @@
 #include "UR_DamageType.h"
 #include "UR_PaniniUtils.h"
 #include "AI/AIPerceptionSourceNativeComp.h"
+#include "AI/UR_AISightSubsystem.h"
+#include "AI/UR_AITacticalSubsystem.h"
 #include "UR_CharacterCustomization.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+DECLARE_STATS_GROUP(TEXT("OT Damage Events"), STATGROUP_OTDamageEvents, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Routed RPCs"), STAT_DamageEventsRouted, STATGROUP_OTDamageEvents);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Multicast Equivalent RPCs"), STAT_DamageEventsBroadcastEquivalent, STATGROUP_OTDamageEvents);
+
+namespace OTConsoleVariables
+{
+    static bool bRouteDamageEvents = true;
+    static FAutoConsoleVariableRef CVarRouteDamageEvents(
+        TEXT("OT.Net.RouteDamageEvents"),
+        bRouteDamageEvents,
+        TEXT("Server only. Send damage events only to connections that can perceive them, instead of multicasting."),
+        ECVF_Default);
+
+    static float DamageEventRadius = 4000.f;
+    static FAutoConsoleVariableRef CVarDamageEventRadius(
+        TEXT("OT.Net.DamageEventRadius"),
+        DamageEventRadius,
+        TEXT("Server only. Viewers within this distance of a damaged character receive its damage events."),
+        ECVF_Default);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
 AUR_Character::AUR_Character(const FObjectInitializer& ObjectInitializer) :
     Super(ObjectInitializer.SetDefaultSubobjectClass<UUR_CharacterMovementComponent>(ACharacter::CharacterMovementComponentName)),
     FootstepTimestamp(0.f),
@@ -144,9 +169,14 @@ void AUR_Character::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLif
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    DOREPLIFETIME(ThisClass, DodgeDirection);
-    DOREPLIFETIME(ThisClass, InventoryComponent);
-    DOREPLIFETIME(ThisClass, AbilitySystemComponent);
+    FDoRepLifetimeParams Params;
+    Params.bIsPushBased = true;
+
+    DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, DodgeDirection, Params);
+
+    // Default subobjects, only sent with the initial bunch
+    DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, InventoryComponent, Params);
+    DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, AbilitySystemComponent, Params);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -165,6 +195,14 @@ void AUR_Character::BeginPlay()
 
     UUR_PaniniUtils::TogglePaniniProjection(GetMesh1P(), true, true);
 
+    if (HasAuthority())
+    {
+        if (auto SightSubsystem = GetWorld()->GetSubsystem<UUR_AISightSubsystem>())
+        {
+            SightSubsystem->RegisterPawn(this);
+        }
+    }
+
     if (GetNetMode() == NM_DedicatedServer)
     {
         // Server considers being never rendered, so it will never update anims/bones when optimization settings are enabled.
@@ -955,7 +993,17 @@ float AUR_Character::TakeDamage(float Damage, FDamageEvent const& DamageEvent, A
     }
     */
 
-    MulticastDamageEvent(RepDamageEvent);
+    SendDamageEvent(RepDamageEvent);
+
+    // Let bots know this area is dangerous, both where damage was taken and where it came from
+    if (auto TacticalSubsystem = GetWorld()->GetSubsystem<UUR_AITacticalSubsystem>())
+    {
+        TacticalSubsystem->AddDanger(GetActorLocation(), Damage);
+        if (RepDamageEvent.DamageInstigator && RepDamageEvent.DamageInstigator != this)
+        {
+            TacticalSubsystem->AddDanger(RepDamageEvent.DamageInstigator->GetActorLocation(), Damage);
+        }
+    }
 
     ////////////////////////////////////////////////////////////
     // Death
@@ -969,7 +1017,52 @@ float AUR_Character::TakeDamage(float Damage, FDamageEvent const& DamageEvent, A
     return Damage;
 }
 
+void AUR_Character::SendDamageEvent(const FReplicatedDamageEvent& RepDamageEvent)
+{
+    if (!OTConsoleVariables::bRouteDamageEvents)
+    {
+        MulticastDamageEvent(RepDamageEvent);
+        return;
+    }
+
+    // Server side listeners, including the local player of a listen server
+    BroadcastDamageEvent(RepDamageEvent);
+
+    const APawn* DamageInstigator = RepDamageEvent.DamageInstigator;
+    const float RadiusSquared = FMath::Square(OTConsoleVariables::DamageEventRadius);
+    int32 NumRemoteViewers = 0;
+
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+    {
+        AUR_PlayerController* PC = Cast<AUR_PlayerController>(It->Get());
+        if (!PC || PC->IsLocalController())
+        {
+            continue;
+        }
+        NumRemoteViewers++;
+
+        const APawn* Pawn = PC->GetPawn();
+        const AActor* ViewTarget = PC->GetViewTarget();
+        const bool bRelevant = Pawn == this || ViewTarget == this
+            || (DamageInstigator && (Pawn == DamageInstigator || ViewTarget == DamageInstigator))
+            || (ViewTarget && FVector::DistSquared(ViewTarget->GetActorLocation(), GetActorLocation()) <= RadiusSquared);
+
+        if (bRelevant)
+        {
+            PC->ClientDamageEvent(this, RepDamageEvent);
+            INC_DWORD_STAT(STAT_DamageEventsRouted);
+        }
+    }
+
+    INC_DWORD_STAT_BY(STAT_DamageEventsBroadcastEquivalent, NumRemoteViewers);
+}
+
 void AUR_Character::MulticastDamageEvent_Implementation(const FReplicatedDamageEvent RepDamageEvent)
+{
+    BroadcastDamageEvent(RepDamageEvent);
+}
+
+void AUR_Character::BroadcastDamageEvent(const FReplicatedDamageEvent& RepDamageEvent)
 {
     OnDamageReceived.Broadcast(this, RepDamageEvent);
 
@@ -1406,3 +1499,47 @@ void AUR_Character::SetTeamIndex_Implementation(int32 NewTeamIndex)
         IUR_TeamInterface::Execute_SetTeamIndex(PS, NewTeamIndex);
     }
 }
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// AI Sight
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+UAISense_Sight::EVisibilityResult AUR_Character::CanBeSeenFrom(const FCanBeSeenFromContext& Context, FVector& OutSeenLocation, int32& OutNumberOfLoSChecksPerformed, int32& OutNumberOfAsyncLosCheckRequested, float& OutSightStrength, int32* UserData, const FOnPendingVisibilityQueryProcessedDelegate* Delegate)
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    FVector EyeLocation;
+    FRotator EyeRotation;
+    GetActorEyesViewPoint(EyeLocation, EyeRotation);
+
+    OutSeenLocation = EyeLocation;
+    OutSightStrength = 1.f;
+    OutNumberOfLoSChecksPerformed = 0;
+    OutNumberOfAsyncLosCheckRequested = 0;
+
+    // IgnoreActor is the observer's body
+    const AActor* Observer = Context.IgnoreActor;
+    UUR_AISightSubsystem* SightSubsystem = Observer ? GetWorld()->GetSubsystem<UUR_AISightSubsystem>() : nullptr;
+
+    bool bVisible = false;
+    if (SightSubsystem && SightSubsystem->GetCachedVisibility(Observer, this, bVisible))
+    {
+        SightSubsystem->RecordSightQuery(FPlatformTime::Seconds() - StartTime, true);
+        return bVisible ? UAISense_Sight::EVisibilityResult::Visible : UAISense_Sight::EVisibilityResult::NotVisible;
+    }
+
+    // No fresh result for this pair (eg. just spawned), trace now and share the result
+    FCollisionQueryParams Params(SCENE_QUERY_STAT(AILineOfSight), true, Observer);
+    Params.AddIgnoredActor(this);
+    FHitResult Hit;
+    bVisible = !GetWorld()->LineTraceSingleByChannel(Hit, Context.ObserverLocation, EyeLocation, ECC_Visibility, Params);
+    OutNumberOfLoSChecksPerformed = 1;
+
+    if (SightSubsystem)
+    {
+        SightSubsystem->StoreVisibility(Observer, this, bVisible);
+        SightSubsystem->RecordSightQuery(FPlatformTime::Seconds() - StartTime, false);
+    }
+
+    return bVisible ? UAISense_Sight::EVisibilityResult::Visible : UAISense_Sight::EVisibilityResult::NotVisible;
+}
@@ -8,10 +8,12 @@
 #include "AbilitySystemInterface.h"
 #include "GameplayTagAssetInterface.h"
 #include "Interfaces/UR_TeamInterface.h"
+#include "Perception/AISightTargetInterface.h"
 #include "Components/InputComponent.h"  //struct FInputKeyBinding
 
 #include "GameplayAbilitySpec.h"
 #include "GameplayEffect.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "UR_Type_DodgeDirection.h"
 #include "Enums/UR_MovementAction.h"
 
@@ -161,6 +163,7 @@ class OPENTOURNAMENT_API AUR_Character : public ACharacter
     , public IAbilitySystemInterface
     , public IGameplayTagAssetInterface
     , public IUR_TeamInterface
+    , public IAISightTargetInterface
 {
     GENERATED_BODY()
 
@@ -594,6 +597,7 @@ public:
     virtual void ServerSetDodgeDirection_Implementation(const EDodgeDirection InDodgeDirection)
     {
         DodgeDirection = InDodgeDirection;
+        MARK_PROPERTY_DIRTY_FROM_NAME(AUR_Character, DodgeDirection, this);
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -724,9 +728,21 @@ public:
     */
     virtual float TakeDamage(float Damage, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
+    /**
+    * Authority only. Send a damage event to the connections that can perceive it:
+    * the victim, the instigator, players viewing either of them, and viewers within OT.Net.DamageEventRadius.
+    * Uses MulticastDamageEvent instead when OT.Net.RouteDamageEvents is 0.
+    */
+    void SendDamageEvent(const FReplicatedDamageEvent& RepDamageEvent);
+
     UFUNCTION(NetMulticast, Unreliable)
     void MulticastDamageEvent(const FReplicatedDamageEvent RepDamageEvent);
 
+    /**
+    * Dispatch a damage event to local listeners (OnDamageReceived, and OnDamageDealt of the instigator).
+    */
+    void BroadcastDamageEvent(const FReplicatedDamageEvent& RepDamageEvent);
+
     UPROPERTY(BlueprintAssignable, Category = "Character")
     FCharacterDamageEventSignature OnDamageReceived;
 
@@ -842,5 +858,14 @@ public:
     virtual int32 GetTeamIndex_Implementation() override;
     virtual void SetTeamIndex_Implementation(int32 NewTeamIndex) override;
     //~ End TeamInterface
+
+    //~ Begin AISightTargetInterface
+    /**
+    * Answer AI sight checks from the shared line-of-sight service (UUR_AISightSubsystem),
+    * only tracing ourselves when there is no fresh result for this observer.
+    * Since 5.3 the sight sense calls this context overload; the older one is deprecated and only reached through its default.
+    */
+    virtual UAISense_Sight::EVisibilityResult CanBeSeenFrom(const FCanBeSeenFromContext& Context, FVector& OutSeenLocation, int32& OutNumberOfLoSChecksPerformed, int32& OutNumberOfAsyncLosCheckRequested, float& OutSightStrength, int32* UserData = nullptr, const FOnPendingVisibilityQueryProcessedDelegate* Delegate = nullptr) override;
+    //~ End AISightTargetInterface
    
 };
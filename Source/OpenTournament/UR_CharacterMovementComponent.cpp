@@ -669,5 +669,6 @@ void UUR_CharacterMovementComponent::ClearDodgeInput()
     if (URCharacterOwner)
     {
         URCharacterOwner->DodgeDirection = EDodgeDirection::None;
+        MARK_PROPERTY_DIRTY_FROM_NAME(AUR_Character, DodgeDirection, URCharacterOwner);
     }
 }
@@ -55,7 +55,7 @@ void UUR_CheatManager::Cheat_AddScore(int32 InValue)
     {
         if (auto PS = Cast<AUR_PlayerState>(PC->PlayerState))
         {
-            PS->SetScore(PS->GetScore() + InValue);
+            PS->AddScore(InValue);
         }
     }
 }
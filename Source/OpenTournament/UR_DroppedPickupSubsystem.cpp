@@ -0,0 +1,176 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_DroppedPickupSubsystem.h"
+
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+
+#include "UR_Pickup_Dropped.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_DroppedPickupSubsystem)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT Dropped Pickups"), STATGROUP_OTDroppedPickups, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Dropped Pickups Update"), STAT_DroppedPickupsUpdate, STATGROUP_OTDroppedPickups);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Live Dropped Pickups"), STAT_DroppedPickupsLive, STATGROUP_OTDroppedPickups);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Dropped Pickups"), STAT_DroppedPickupsPooled, STATGROUP_OTDroppedPickups);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Expired Dropped Pickups"), STAT_DroppedPickupsExpired, STATGROUP_OTDroppedPickups);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Recycled Dropped Pickups"), STAT_DroppedPickupsRecycled, STATGROUP_OTDroppedPickups);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UUR_DroppedPickupSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UUR_DroppedPickupSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_DroppedPickupSubsystem, STATGROUP_Tickables);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+AUR_Pickup_Dropped* UUR_DroppedPickupSubsystem::AcquireDroppedPickup(TSubclassOf<AUR_Pickup_Dropped> PickupClass, const FTransform& Transform, AActor* Owner)
+{
+    if (!PickupClass)
+    {
+        return nullptr;
+    }
+
+    if (TArray<TWeakObjectPtr<AUR_Pickup_Dropped>>* Pool = Pools.Find(PickupClass.Get()))
+    {
+        while (Pool->Num() > 0)
+        {
+            AUR_Pickup_Dropped* Pickup = Pool->Pop(false).Get();
+            NumPooled--;
+
+            if (IsValid(Pickup))
+            {
+                Pickup->SetOwner(Owner);
+                Pickup->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+
+                SET_DWORD_STAT(STAT_DroppedPickupsPooled, NumPooled);
+                INC_DWORD_STAT(STAT_DroppedPickupsRecycled);
+                return Pickup;
+            }
+        }
+    }
+
+    SET_DWORD_STAT(STAT_DroppedPickupsPooled, NumPooled);
+
+    return GetWorld()->SpawnActorDeferred<AUR_Pickup_Dropped>(PickupClass, Transform, Owner, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+}
+
+void UUR_DroppedPickupSubsystem::FinishDroppedPickup(AUR_Pickup_Dropped* Pickup, const FTransform& Transform)
+{
+    if (!Pickup)
+    {
+        return;
+    }
+
+    if (Pickup->HasActorBegunPlay())
+    {
+        Pickup->StartDrop();
+    }
+    else
+    {
+        // BeginPlay starts the drop
+        UGameplayStatics::FinishSpawningActor(Pickup, Transform);
+    }
+}
+
+void UUR_DroppedPickupSubsystem::ReleaseDroppedPickup(AUR_Pickup_Dropped* Pickup)
+{
+    if (!IsValid(Pickup) || !Pickup->IsDropped())
+    {
+        return;
+    }
+
+    Pickup->ReturnToPool();
+
+    TArray<TWeakObjectPtr<AUR_Pickup_Dropped>>& Pool = Pools.FindOrAdd(Pickup->GetClass());
+    if (Pool.Num() < MaxPooledPerClass)
+    {
+        Pool.Add(Pickup);
+        NumPooled++;
+    }
+    else
+    {
+        Pickup->Destroy();
+    }
+
+    SET_DWORD_STAT(STAT_DroppedPickupsPooled, NumPooled);
+}
+
+void UUR_DroppedPickupSubsystem::RegisterDroppedPickup(AUR_Pickup_Dropped* Pickup)
+{
+    LivePickups.AddUnique(Pickup);
+    SET_DWORD_STAT(STAT_DroppedPickupsLive, LivePickups.Num());
+}
+
+void UUR_DroppedPickupSubsystem::UnregisterDroppedPickup(AUR_Pickup_Dropped* Pickup)
+{
+    LivePickups.RemoveSingleSwap(Pickup, false);
+    SET_DWORD_STAT(STAT_DroppedPickupsLive, LivePickups.Num());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_DroppedPickupSubsystem::Tick(float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_DroppedPickupsUpdate);
+
+    const bool bAnimate = !IsRunningDedicatedServer();
+
+    // Iterate backwards, releasing a pickup unregisters it
+    for (int32 i = LivePickups.Num() - 1; i >= 0; i--)
+    {
+        AUR_Pickup_Dropped* Pickup = LivePickups[i].Get();
+        if (!Pickup)
+        {
+            LivePickups.RemoveAtSwap(i, 1, false);
+            continue;
+        }
+
+        if (Pickup->DropState.LifeSpan <= 0.f)
+        {
+            continue;
+        }
+
+        const float Remaining = Pickup->GetRemainingLifeSpan();
+
+        if (Pickup->HasAuthority() && Remaining <= 0.f)
+        {
+            INC_DWORD_STAT(STAT_DroppedPickupsExpired);
+            ReleaseDroppedPickup(Pickup);
+            continue;
+        }
+
+        if (bAnimate)
+        {
+            UpdateExpireAnimation(Pickup, DeltaTime, Remaining);
+        }
+    }
+
+    SET_DWORD_STAT(STAT_DroppedPickupsLive, LivePickups.Num());
+}
+
+void UUR_DroppedPickupSubsystem::UpdateExpireAnimation(AUR_Pickup_Dropped* Pickup, float DeltaTime, float RemainingLifeSpan) const
+{
+    if (!Pickup->bExpiring)
+    {
+        if (Pickup->ExpireEffectDuration > 0.f && RemainingLifeSpan <= Pickup->ExpireEffectDuration)
+        {
+            Pickup->PlayExpire();
+        }
+        return;
+    }
+
+    Pickup->SetActorScale3D(FMath::VInterpConstantTo(Pickup->GetActorScale3D(), FVector::ZeroVector, DeltaTime, Pickup->OriginalScale.Size() / Pickup->ExpireDuration));
+    Pickup->RotationRate += DeltaTime * (720.f / Pickup->ExpireDuration);
+    Pickup->AddActorWorldRotation(DeltaTime * Pickup->RotationRate * FRotator(0.f, 1.f, 0.f));
+}
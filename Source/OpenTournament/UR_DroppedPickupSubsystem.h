@@ -0,0 +1,94 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UR_DroppedPickupSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+class AUR_Pickup_Dropped;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Manages dropped pickups (AUR_Pickup_Dropped).
+ *
+ * Server:
+ * - recycles dropped pickups through a per-class pool instead of spawning/destroying them all the time.
+ *   Pooled pickups stay relevant but net dormant, so clients keep their actors and channels for reuse too.
+ * - expires dropped pickups at the end of their lifespan
+ *
+ * Server & client:
+ * - plays the expire animation of all dropped pickups in a single loop
+ *
+ * Usage:
+ *   Pickup = AcquireDroppedPickup(Class, Transform, Owner);
+ *   (setup pickup)
+ *   FinishDroppedPickup(Pickup, Transform);
+ */
+UCLASS(Config = Game)
+class OPENTOURNAMENT_API UUR_DroppedPickupSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    //~UWorldSubsystem interface
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    //~End of UWorldSubsystem interface
+
+    //~FTickableGameObject interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    //~End of FTickableGameObject interface
+
+    /**
+    * Authority only.
+    * Get a pooled dropped pickup of given class, or begin spawning a new one.
+    * Must be followed by FinishDroppedPickup.
+    */
+    AUR_Pickup_Dropped* AcquireDroppedPickup(TSubclassOf<AUR_Pickup_Dropped> PickupClass, const FTransform& Transform, AActor* Owner);
+
+    template<class T>
+    T* AcquireDroppedPickup(const FTransform& Transform, AActor* Owner)
+    {
+        return Cast<T>(AcquireDroppedPickup(T::StaticClass(), Transform, Owner));
+    }
+
+    /**
+    * Authority only.
+    * Finish spawning a new dropped pickup, or start the drop of a recycled one.
+    */
+    void FinishDroppedPickup(AUR_Pickup_Dropped* Pickup, const FTransform& Transform);
+
+    /**
+    * Authority only.
+    * Take back a dropped pickup (picked up or expired) into its pool.
+    */
+    void ReleaseDroppedPickup(AUR_Pickup_Dropped* Pickup);
+
+    /** Called by dropped pickups when they start or stop being in the world */
+    void RegisterDroppedPickup(AUR_Pickup_Dropped* Pickup);
+    void UnregisterDroppedPickup(AUR_Pickup_Dropped* Pickup);
+
+    /** Max number of idle pickups kept per class. Released pickups beyond that are destroyed. */
+    UPROPERTY(Config)
+    int32 MaxPooledPerClass = 16;
+
+protected:
+
+    /** Dropped pickups currently in the world */
+    TArray<TWeakObjectPtr<AUR_Pickup_Dropped>> LivePickups;
+
+    /** Idle pickups per class */
+    TMap<TObjectKey<UClass>, TArray<TWeakObjectPtr<AUR_Pickup_Dropped>>> Pools;
+
+    int32 NumPooled = 0;
+
+    void UpdateExpireAnimation(AUR_Pickup_Dropped* Pickup, float DeltaTime, float RemainingLifeSpan) const;
+};
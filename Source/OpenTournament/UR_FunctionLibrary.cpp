@@ -9,6 +9,7 @@
 #include <UObject/UObjectIterator.h>
 
 #include "Engine/Engine.h"
+#include "Engine/NetDriver.h"
 #include "GameFramework/GameStateBase.h"
 #include "Internationalization/Regex.h"
 #include "Particles/ParticleSystemComponent.h"
@@ -179,6 +180,43 @@ bool UUR_FunctionLibrary::IsComponentLocallyControlled(const UActorComponent* Ot
     return Other && IsLocallyControlled(Other->GetOwner());
 }
 
+UWorld* UUR_FunctionLibrary::FindServerWorldInProcess(const UWorld* ClientWorld)
+{
+    if (!ClientWorld || ClientWorld->GetNetMode() != NM_Client || !ClientWorld->GetNetDriver())
+    {
+        return nullptr;
+    }
+    for (const FWorldContext& Context : GEngine->GetWorldContexts())
+    {
+        UWorld* Other = Context.World();
+        if (Other && Other != ClientWorld && Other->WorldType == ClientWorld->WorldType && Other->GetNetDriver()
+            && (Other->GetNetMode() == NM_ListenServer || Other->GetNetMode() == NM_DedicatedServer))
+        {
+            return Other;
+        }
+    }
+    return nullptr;
+}
+
+bool UUR_FunctionLibrary::SetPacketSimulation(UWorld* ClientWorld, UWorld* ServerWorld, float LatencyMs, float JitterMs)
+{
+#if DO_ENABLE_NET_TEST
+    FPacketSimulationSettings PacketSettings;
+    PacketSettings.PktLag = FMath::RoundToInt(0.5f * LatencyMs);
+    PacketSettings.PktLagVariance = FMath::RoundToInt(JitterMs);
+    for (UWorld* World : { ClientWorld, ServerWorld })
+    {
+        if (UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr)
+        {
+            NetDriver->SetPacketSimulationSettings(PacketSettings);
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
 
 FString UUR_FunctionLibrary::GetTimeString(const float TimeSeconds)
 {
@@ -215,6 +215,18 @@ public:
     UFUNCTION(BlueprintPure, BlueprintCosmetic, Category = "Game")
     static bool IsComponentLocallyControlled(const UActorComponent* Other);
 
+    /**
+    * Server world running in the same process as a client world (PIE with "Run Under One Process"), or null.
+    * For test commands comparing both sides.
+    */
+    static UWorld* FindServerWorldInProcess(const UWorld* ClientWorld);
+
+    /**
+    * Emulate latency and jitter on the net drivers of both worlds, the latency being split on both sides.
+    * Zero latency and jitter turn emulation off. Returns false when packet simulation is not available in this build.
+    */
+    static bool SetPacketSimulation(UWorld* ClientWorld, UWorld* ServerWorld, float LatencyMs, float JitterMs);
+
 
     /**
     * Get the Time as a String
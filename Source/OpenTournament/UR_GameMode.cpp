@@ -4,25 +4,56 @@
 
 #include "UR_GameMode.h"
 
-#include "EngineUtils.h"    // for TActorIterator<>
+#include "Engine/AssetManager.h"
 #include "Engine/DamageEvents.h"
+#include "Engine/StreamableManager.h"
+#include "EngineUtils.h"
 #include "GameFramework/Controller.h"
 #include "Kismet/GameplayStatics.h"
 #include "TimerManager.h"
 
 #include "UR_Character.h"
 #include "UR_GameState.h"
+#include "UR_GameplayActorRegistry.h"
 #include "UR_InventoryComponent.h"
 #include "UR_PlayerController.h"
 #include "UR_PlayerState.h"
-#include "UR_Projectile.h"
+#include "UR_SpawnSelectionSubsystem.h"
 #include "UR_Weapon.h"
 #include "UR_Ammo.h"
 #include "UR_TeamInfo.h"
+#include "AI/UR_AITacticalSubsystem.h"
 
 // Having to include these, only to set the default classes, makes me sad
 #include "UR_Widget_ScoreboardBase.h"
 #include "AI/UR_BotController.h"
+#include "UR_FunctionLibrary.h"
+
+DECLARE_STATS_GROUP(TEXT("OT Game Mode"), STATGROUP_OTGameMode, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("SetPlayerDefaults"), STAT_SetPlayerDefaults, STATGROUP_OTGameMode);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Max SetPlayerDefaults (ms)"), STAT_SetPlayerDefaultsMax, STATGROUP_OTGameMode);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Prepared Loadouts"), STAT_PreparedLoadouts, STATGROUP_OTGameMode);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Starting Loadout Sync Loads"), STAT_StartingLoadoutSyncLoads, STATGROUP_OTGameMode);
+
+namespace OTConsoleVariables
+{
+    static FAutoConsoleCommandWithWorldAndArgs CmdGameModeValidateLoadouts(
+        TEXT("OT.GameMode.ValidateLoadouts"),
+        TEXT("Check that starting weapons were preloaded and never loaded synchronously. Run after a few respawns."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            // From a PIE client, look for the server world of the same process
+            UWorld* ServerWorld = (World && !World->GetAuthGameMode()) ? UUR_FunctionLibrary::FindServerWorldInProcess(World) : World;
+            if (auto GameMode = ServerWorld ? ServerWorld->GetAuthGameMode<AUR_GameMode>() : nullptr)
+            {
+                GameMode->ValidateStartingLoadouts();
+            }
+            else
+            {
+                UE_LOG(LogTemp, Warning, TEXT("ValidateLoadouts: no AUR_GameMode in this process"));
+            }
+        }));
+}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // Initialization
@@ -44,6 +75,11 @@ AUR_GameMode::AUR_GameMode()
     SelfDamage = 1.f;
     TeamDamageDirect = 0.f;
     TeamDamageRetaliate = 0.f;
+
+    NumPreparedLoadouts = 2;
+    bStartingLoadoutLoaded = false;
+    MaxSetPlayerDefaultsMs = 0.f;
+    NumStartingLoadoutSyncLoads = 0;
 }
 
 void AUR_GameMode::InitGame(const FString& MapName, const FString& OptionsMeh, FString& ErrorMessage)
@@ -86,6 +122,8 @@ void AUR_GameMode::InitGame(const FString& MapName, const FString& OptionsMeh, F
         NumTeams = 0;
         DesiredTeamSize = 1;
     }
+
+    PreloadStartingLoadout();
 }
 
 void AUR_GameMode::InitGameState()
@@ -180,6 +218,19 @@ void AUR_GameMode::GenericPlayerInitialization(AController* C)
     }
 }
 
+AActor* AUR_GameMode::ChoosePlayerStart_Implementation(AController* Player)
+{
+    if (auto SpawnSelection = GetWorld()->GetSubsystem<UUR_SpawnSelectionSubsystem>())
+    {
+        UClass* PawnClass = GetDefaultPawnClassForController(Player);
+        if (AActor* Start = SpawnSelection->ChooseSpawnPoint(Player, PawnClass ? PawnClass->GetDefaultObject<APawn>() : nullptr))
+        {
+            return Start;
+        }
+    }
+    return Super::ChoosePlayerStart_Implementation(Player);
+}
+
 void AUR_GameMode::AssignDefaultTeam(AUR_PlayerState* PS)
 {
     if (NumTeams == 0)
@@ -355,6 +406,9 @@ void AUR_GameMode::OnMatchTimeUp_Implementation(AUR_GameState* GS)
 
 void AUR_GameMode::SetPlayerDefaults(APawn* PlayerPawn)
 {
+    SCOPE_CYCLE_COUNTER(STAT_SetPlayerDefaults);
+    const double StartTime = FPlatformTime::Seconds();
+
     if (AUR_Character* URCharacter = Cast<AUR_Character>(PlayerPawn))
     {
         //NOTE: Technically RestartPlayer() supports restarting a player that is not dead.
@@ -364,29 +418,162 @@ void AUR_GameMode::SetPlayerDefaults(APawn* PlayerPawn)
         {
             URCharacter->InventoryComponent->Clear();
 
-            FActorSpawnParameters SpawnParams;
-            SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-            SpawnParams.Owner = URCharacter;
-            SpawnParams.Instigator = URCharacter;
-            for (const FStartingWeaponEntry& Entry : StartingWeapons)
+            // Use a set spawned in advance if possible
+            FPreparedLoadout Loadout;
+            while (PreparedLoadouts.Num() > 0 && Loadout.Weapons.Num() == 0)
             {
-                if (UClass* Class = Entry.WeaponClass.LoadSynchronous())
+                Loadout = PreparedLoadouts.Pop(false);
+                if (Loadout.Weapons.Num() != StartingWeapons.Num())
                 {
-                    AUR_Weapon* StartingWeapon = GetWorld()->SpawnActor<AUR_Weapon>(Class, URCharacter->GetActorLocation(), URCharacter->GetActorRotation(), SpawnParams);
-                    if (StartingWeapon)
+                    // StartingWeapons changed since it was prepared
+                    for (AUR_Weapon* Weapon : Loadout.Weapons)
                     {
-                        StartingWeapon->GiveTo(URCharacter);
-                        //TODO: Weapons with multiple ammo classes
-                        if (StartingWeapon->AmmoRefs.Num() > 0 && StartingWeapon->AmmoRefs[0])
+                        if (IsValid(Weapon))
                         {
-                            StartingWeapon->AmmoRefs[0]->SetAmmoCount(Entry.Ammo);
+                            Weapon->Destroy();
                         }
                     }
+                    Loadout.Weapons.Reset();
                 }
             }
+            if (Loadout.Weapons.Num() == 0)
+            {
+                Loadout = SpawnStartingLoadout();
+            }
+
+            for (int32 i = 0; i < Loadout.Weapons.Num(); i++)
+            {
+                AUR_Weapon* StartingWeapon = Loadout.Weapons[i];
+                if (IsValid(StartingWeapon))
+                {
+                    StartingWeapon->SetActorLocationAndRotation(URCharacter->GetActorLocation(), URCharacter->GetActorRotation());
+                    StartingWeapon->GiveTo(URCharacter);
+                    //TODO: Weapons with multiple ammo classes
+                    if (StartingWeapon->AmmoRefs.Num() > 0 && StartingWeapon->AmmoRefs[0])
+                    {
+                        StartingWeapon->AmmoRefs[0]->SetAmmoCount(StartingWeapons[i].Ammo);
+                    }
+                }
+            }
+
+            SET_DWORD_STAT(STAT_PreparedLoadouts, PreparedLoadouts.Num());
+
+            // Refill outside of the respawn frame
+            GetWorldTimerManager().SetTimerForNextTick(this, &ThisClass::PrepareStartingLoadouts);
         }
     }
     Super::SetPlayerDefaults(PlayerPawn);
+
+    MaxSetPlayerDefaultsMs = FMath::Max(MaxSetPlayerDefaultsMs, static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0));
+    SET_FLOAT_STAT(STAT_SetPlayerDefaultsMax, MaxSetPlayerDefaultsMs);
+}
+
+void AUR_GameMode::PreloadStartingLoadout()
+{
+    TArray<FSoftObjectPath> Paths;
+    for (const FStartingWeaponEntry& Entry : StartingWeapons)
+    {
+        if (!Entry.WeaponClass.IsNull())
+        {
+            Paths.AddUnique(Entry.WeaponClass.ToSoftObjectPath());
+        }
+    }
+
+    if (Paths.Num() == 0)
+    {
+        bStartingLoadoutLoaded = true;
+        return;
+    }
+
+    FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
+    StartingLoadoutHandle = StreamableManager.RequestAsyncLoad(Paths, FStreamableDelegate::CreateUObject(this, &ThisClass::OnStartingLoadoutLoaded), FStreamableManager::AsyncLoadHighPriority);
+    if (!StartingLoadoutHandle.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s: failed to request starting loadout"), *GetName());
+        bStartingLoadoutLoaded = true;
+    }
+}
+
+void AUR_GameMode::OnStartingLoadoutLoaded()
+{
+    bStartingLoadoutLoaded = true;
+
+    // May complete immediately during InitGame, spawn a bit later
+    GetWorldTimerManager().SetTimerForNextTick(this, &ThisClass::PrepareStartingLoadouts);
+}
+
+void AUR_GameMode::PrepareStartingLoadouts()
+{
+    if (!bStartingLoadoutLoaded || PreparedLoadouts.Num() >= NumPreparedLoadouts || HasMatchEnded())
+    {
+        return;
+    }
+
+    PreparedLoadouts.Add(SpawnStartingLoadout());
+    SET_DWORD_STAT(STAT_PreparedLoadouts, PreparedLoadouts.Num());
+
+    // One set per frame
+    if (PreparedLoadouts.Num() < NumPreparedLoadouts)
+    {
+        GetWorldTimerManager().SetTimerForNextTick(this, &ThisClass::PrepareStartingLoadouts);
+    }
+}
+
+FPreparedLoadout AUR_GameMode::SpawnStartingLoadout()
+{
+    FPreparedLoadout Loadout;
+
+    // Unowned and hidden, weapons are not relevant to anyone until given
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+    for (const FStartingWeaponEntry& Entry : StartingWeapons)
+    {
+        UClass* Class = Entry.WeaponClass.Get();
+        if (!Class && !Entry.WeaponClass.IsNull())
+        {
+            // Should not happen once preloading completed
+            UE_LOG(LogTemp, Warning, TEXT("%s: starting weapon %s not loaded, loading synchronously"), *GetName(), *Entry.WeaponClass.ToString());
+            INC_DWORD_STAT(STAT_StartingLoadoutSyncLoads);
+            NumStartingLoadoutSyncLoads++;
+            ensureMsgf(!bStartingLoadoutLoaded, TEXT("%s: starting weapon %s unloaded after preload completed"), *GetName(), *Entry.WeaponClass.ToString());
+            Class = Entry.WeaponClass.LoadSynchronous();
+        }
+        Loadout.Weapons.Add(Class ? GetWorld()->SpawnActor<AUR_Weapon>(Class, FTransform::Identity, SpawnParams) : nullptr);
+    }
+
+    return Loadout;
+}
+
+bool AUR_GameMode::ValidateStartingLoadouts() const
+{
+    int32 NumErrors = 0;
+
+    if (!bStartingLoadoutLoaded)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ValidateLoadouts: preload has not completed"));
+        NumErrors++;
+    }
+
+    for (const FStartingWeaponEntry& Entry : StartingWeapons)
+    {
+        if (!Entry.WeaponClass.IsNull() && !Entry.WeaponClass.Get())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ValidateLoadouts: starting weapon %s is not loaded"), *Entry.WeaponClass.ToString());
+            NumErrors++;
+        }
+    }
+
+    if (NumStartingLoadoutSyncLoads > 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ValidateLoadouts: %i synchronous loads of starting weapons"), NumStartingLoadoutSyncLoads);
+        NumErrors++;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("ValidateLoadouts: %i starting weapons, %i/%i prepared loadouts, %i sync loads, %i errors"),
+        StartingWeapons.Num(), PreparedLoadouts.Num(), NumPreparedLoadouts, NumStartingLoadoutSyncLoads, NumErrors);
+
+    return NumErrors == 0;
 }
 
 
@@ -486,7 +673,15 @@ void AUR_GameMode::RegisterKill(AController* Victim, AController* Killer, const
 
         if (VictimPS || KillerPS)
         {
-            GetGameState<AUR_GameState>()->MulticastFragEvent(VictimPS, KillerPS, DamageEvent.DamageTypeClass, EventTags);
+            GetGameState<AUR_GameState>()->AddFragEvent(VictimPS, KillerPS, DamageEvent.DamageTypeClass, EventTags);
+        }
+
+        if (APawn* VictimPawn = Victim->GetPawn())
+        {
+            if (auto TacticalSubsystem = GetWorld()->GetSubsystem<UUR_AITacticalSubsystem>())
+            {
+                TacticalSubsystem->AddDeath(VictimPawn->GetActorLocation());
+            }
         }
     }
 }
@@ -551,26 +746,9 @@ AActor* AUR_GameMode::IsThereAWinner_Implementation()
                 return BestTeam;
             }
         }
-        else
+        else if (!GS->IsLeaderTied())
         {
-            APlayerState* BestPlayer = NULL;
-            bool bTie = false;
-            for (APlayerState* PS : GS->PlayerArray)
-            {
-                if (!BestPlayer || PS->GetScore() > BestPlayer->GetScore())
-                {
-                    BestPlayer = PS;
-                    bTie = false;
-                }
-                else if (PS->GetScore() == BestPlayer->GetScore())
-                {
-                    bTie = true;
-                }
-            }
-            if (!bTie)
-            {
-                return BestPlayer;
-            }
+            return GS->GetLeader();
         }
     }
 
@@ -624,6 +802,7 @@ void AUR_GameMode::TriggerEndMatch_Implementation(AActor* Winner, AActor* Focus)
         {
             GS->Winner = Winner;
         }
+        MARK_PROPERTY_DIRTY_FROM_NAME(AUR_GameState, Winner, GS);
         GS->EndGameFocus = Focus;
         GS->OnRep_Winner(); // trigger events on server side
     }
@@ -635,14 +814,9 @@ void AUR_GameMode::HandleMatchHasEnded()
     Super::HandleMatchHasEnded();
 
     // Freeze the game
-    //TODO: this is probably the wrong way to do it
-    for (TActorIterator<AActor> ActorIt(GetWorld()); ActorIt; ++ActorIt)
+    if (auto Registry = GetWorld()->GetSubsystem<UUR_GameplayActorRegistry>())
     {
-        AActor* Actor = *ActorIt;
-        if (Cast<APawn>(Actor) || Cast<AUR_Projectile>(Actor))
-        {
-            Actor->CustomTimeDilation = 0.01f;
-        }
+        Registry->SetCustomTimeDilation(UUR_GameplayActorRegistry::MatchEndFreezeTypes, 0.01f);
     }
 
     AUR_GameState* GS = GetGameState<AUR_GameState>();
@@ -15,6 +15,7 @@ class AUR_Weapon;
 class UUR_Widget_ScoreboardBase;
 class AUR_TeamInfo;
 class AUR_BotController;
+struct FStreamableHandle;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -32,6 +33,19 @@ struct FStartingWeaponEntry
     FStartingWeaponEntry() : Ammo(0) {}
 };
 
+/**
+* One set of starting weapons, spawned ahead of a respawn.
+* Weapons are indexed like StartingWeapons (NULL where class is unavailable).
+*/
+USTRUCT()
+struct FPreparedLoadout
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<AUR_Weapon*> Weapons;
+};
+
 namespace ETeamsFillMode
 {
     static const FString Even = TEXT("Even");
@@ -96,6 +110,13 @@ public:
     UPROPERTY(Config, BlueprintReadWrite, EditDefaultsOnly, Category = "Parameters")
     TArray<FStartingWeaponEntry> StartingWeapons;
 
+    /**
+    * Number of starting weapon sets spawned in advance, ready to be given on respawn.
+    * Sets are refilled over the following frames after each respawn.
+    */
+    UPROPERTY(Config, EditDefaultsOnly, Category = "Parameters")
+    int32 NumPreparedLoadouts;
+
     UPROPERTY(Config, BlueprintReadWrite, EditDefaultsOnly, Category = "Parameters")
     int32 MaxPlayers;
 
@@ -144,6 +165,9 @@ public:
 
     virtual void GenericPlayerInitialization(AController* C) override;
 
+    /** Pick the least threatened start using UUR_SpawnSelectionSubsystem, falls back to default behavior */
+    virtual AActor* ChoosePlayerStart_Implementation(AController* Player) override;
+
     UFUNCTION()
     virtual void AssignDefaultTeam(AUR_PlayerState* PS);
 
@@ -178,6 +202,45 @@ public:
 
     virtual void SetPlayerDefaults(APawn* PlayerPawn) override;
 
+    /**
+    * Check that the starting loadout was fully preloaded and never loaded synchronously this match.
+    * Logs every error, returns true when there is none.
+    * Backs the OT.GameMode.ValidateLoadouts console command.
+    */
+    bool ValidateStartingLoadouts() const;
+
+protected:
+
+    /**
+    * Start async loading starting weapon classes.
+    * They stay loaded for the whole match, respawns never wait on disk.
+    */
+    virtual void PreloadStartingLoadout();
+
+    virtual void OnStartingLoadoutLoaded();
+
+    /** Spawn one starting weapon set per call, until NumPreparedLoadouts are ready */
+    virtual void PrepareStartingLoadouts();
+
+    /** Spawn a set of unowned starting weapons */
+    FPreparedLoadout SpawnStartingLoadout();
+
+    /** Keeps starting weapon classes loaded */
+    TSharedPtr<FStreamableHandle> StartingLoadoutHandle;
+
+    bool bStartingLoadoutLoaded;
+
+    /** Starting weapon classes loaded synchronously this match, should stay 0 */
+    int32 NumStartingLoadoutSyncLoads;
+
+    UPROPERTY(Transient)
+    TArray<FPreparedLoadout> PreparedLoadouts;
+
+    /** Slowest SetPlayerDefaults of this match, for stat OTGameMode */
+    float MaxSetPlayerDefaultsMs;
+
+public:
+
     /////////////////////////////////////////////////////////////////////////////////////////////////
     // Damage & Kill
     /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -80,12 +80,10 @@ AActor* AUR_GameMode_DM::IsThereAWinner_Implementation()
     }
     else
     {
-        for (APlayerState* PS : GS->PlayerArray)
+        AUR_PlayerState* Leader = GS->GetLeader();
+        if (Leader && Leader->GetScore() >= GoalScore)
         {
-            if (PS->GetScore() >= GoalScore)
-            {
-                return PS;
-            }
+            return Leader;
         }
     }
 
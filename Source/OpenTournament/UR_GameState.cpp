@@ -4,10 +4,16 @@
 
 #include "UR_GameState.h"
 
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Containers/Ticker.h"
 #include "Net/UnrealNetwork.h"
 #include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Misc/App.h"
 #include "TimerManager.h"
 
+#include "UR_FunctionLibrary.h"
 #include "UR_GameMode.h"
 #include "UR_TeamInfo.h"
 #include "UR_LocalPlayer.h"
@@ -17,18 +23,159 @@
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+DECLARE_STATS_GROUP(TEXT("OT Game State"), STATGROUP_OTGameState, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Update Leaderboard"), STAT_UpdateLeaderboard, STATGROUP_OTGameState);
+
+namespace OTConsoleVariables
+{
+    static bool bReplicateKillFeed = true;
+    static FAutoConsoleVariableRef CVarReplicateKillFeed(
+        TEXT("OT.Net.KillFeed"),
+        bReplicateKillFeed,
+        TEXT("Server only. Send frags through the replicated kill feed instead of a reliable multicast per frag."),
+        ECVF_Default);
+
+    /**
+    * Measure the match clock of a client against the server, under emulated latency and jitter.
+    * Runs on the real derivation (engine server time sync, GetClockServerTime and PlayerState ping):
+    * both worlds must live in the same process (PIE client with "Run Under One Process").
+    * Latency is applied through packet simulation, half on each side.
+    */
+    static void SimulateClock(UWorld* ClientWorld, float LatencyMs, float JitterMs, float Duration)
+    {
+        UWorld* ServerWorld = UUR_FunctionLibrary::FindServerWorldInProcess(ClientWorld);
+        if (!ServerWorld)
+        {
+            UE_LOG(LogGameState, Warning, TEXT("OT.Clock.Simulate: run from a PIE client, with the server in the same process"));
+            return;
+        }
+
+        if (!UUR_FunctionLibrary::SetPacketSimulation(ClientWorld, ServerWorld, LatencyMs, JitterMs))
+        {
+            UE_LOG(LogGameState, Warning, TEXT("OT.Clock.Simulate: packet simulation is not available in this build, measuring without added latency"));
+        }
+
+        struct FClockSimulation
+        {
+            TWeakObjectPtr<UWorld> ClientWorld;
+            TWeakObjectPtr<UWorld> ServerWorld;
+            double SettleEndTime = 0.0;
+            double EndTime = 0.0;
+            double MaxError = 0.0;
+            double SumError = 0.0;
+            int32 NumSamples = 0;
+        };
+        TSharedRef<FClockSimulation> Simulation = MakeShared<FClockSimulation>();
+        Simulation->ClientWorld = ClientWorld;
+        Simulation->ServerWorld = ServerWorld;
+        // Let ping and server time sync settle on the new latency before measuring
+        Simulation->SettleEndTime = FPlatformTime::Seconds() + 5.0;
+        Simulation->EndTime = Simulation->SettleEndTime + Duration;
+
+        UE_LOG(LogGameState, Log, TEXT("OT.Clock.Simulate: latency %.0f ms, jitter %.0f ms, measuring %.0f s after 5 s settle"), LatencyMs, JitterMs, Duration);
+
+        FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Simulation, LatencyMs, JitterMs](float DeltaTime)
+        {
+            UWorld* Client = Simulation->ClientWorld.Get();
+            UWorld* Server = Simulation->ServerWorld.Get();
+            const AUR_GameState* ClientGS = Client ? Client->GetGameState<AUR_GameState>() : nullptr;
+            const AUR_GameState* ServerGS = Server ? Server->GetGameState<AUR_GameState>() : nullptr;
+            if (!ClientGS || !ServerGS)
+            {
+                UE_LOG(LogGameState, Warning, TEXT("OT.Clock.Simulate: world went away, aborted"));
+                return false;
+            }
+
+            const double Now = FPlatformTime::Seconds();
+            if (Now >= Simulation->SettleEndTime)
+            {
+                const double Error = FMath::Abs(ClientGS->GetPhaseElapsedTime() - ServerGS->GetPhaseElapsedTime());
+                Simulation->MaxError = FMath::Max(Simulation->MaxError, Error);
+                Simulation->SumError += Error;
+                Simulation->NumSamples++;
+            }
+            if (Now < Simulation->EndTime)
+            {
+                return true;
+            }
+
+            UUR_FunctionLibrary::SetPacketSimulation(Client, Server, 0.f, 0.f);
+
+            // Jitter is never compensated, allow a frame on top
+            const double Tolerance = JitterMs / 1000.0 + FApp::GetDeltaTime();
+            const bool bPass = Simulation->NumSamples > 0 && Simulation->MaxError <= Tolerance;
+
+            UE_LOG(LogGameState, Log, TEXT("  avg error %.1f ms, max %.1f ms over %d frames (tolerance %.1f ms) -> %s"),
+                1000.0 * Simulation->SumError / FMath::Max(Simulation->NumSamples, 1), 1000.0 * Simulation->MaxError, Simulation->NumSamples, 1000.0 * Tolerance, bPass ? TEXT("PASS") : TEXT("FAIL"));
+            return false;
+        }));
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs CmdClockSimulate(
+        TEXT("OT.Clock.Simulate"),
+        TEXT("PIE client only, server in the same process. Check match clock accuracy under emulated latency. Optional args: latency ms (default 100), jitter ms (default 20), duration s (default 60)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            SimulateClock(World,
+                Args.Num() > 0 ? FCString::Atof(*Args[0]) : 100.f,
+                Args.Num() > 1 ? FCString::Atof(*Args[1]) : 20.f,
+                Args.Num() > 2 ? FCString::Atof(*Args[2]) : 60.f);
+        }));
+
+    static FAutoConsoleCommandWithWorldAndArgs CmdLeaderboardValidate(
+        TEXT("OT.Leaderboard.Validate"),
+        TEXT("Compare the incremental leaderboard (order, ties and ranks) against a full sort."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (auto GS = World ? World->GetGameState<AUR_GameState>() : nullptr)
+            {
+                GS->ValidateLeaderboard();
+            }
+        }));
+
+    static FAutoConsoleCommandWithWorldAndArgs CmdLeaderboardBenchmark(
+        TEXT("OT.Leaderboard.Benchmark"),
+        TEXT("Server only. Apply and revert random score changes, timing incremental updates against a full sort. Optional arg: iterations (default 1000)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (auto GS = World ? World->GetGameState<AUR_GameState>() : nullptr)
+            {
+                GS->BenchmarkLeaderboard(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000);
+            }
+        }));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
 AUR_GameState::AUR_GameState()
 {
+    KillFeed.SetOwner(this);
+}
+
+void AUR_GameState::PostInitializeComponents()
+{
+    Super::PostInitializeComponents();
+
+    if (HasAuthority())
+    {
+        MatchTimeline.MatchStartTime = GetWorld()->GetTimeSeconds();
+        MatchTimeline.PhaseStartTime = MatchTimeline.MatchStartTime;
+        MARK_PROPERTY_DIRTY_FROM_NAME(AUR_GameState, MatchTimeline, this);
+    }
 }
 
 void AUR_GameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    DOREPLIFETIME(ThisClass, TimeLimit);
-    DOREPLIFETIME(ThisClass, ClockReferencePoint);
-    DOREPLIFETIME(ThisClass, MatchStateTag);
-    DOREPLIFETIME(ThisClass, Winner);
+    FDoRepLifetimeParams Params;
+    Params.bIsPushBased = true;
+
+    DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, MatchTimeline, Params);
+    DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, MatchStateTag, Params);
+    DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, Winner, Params);
+
+    DOREPLIFETIME(ThisClass, KillFeed);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -45,6 +192,7 @@ void AUR_GameState::SetMatchStateTag(const FGameplayTag& NewTag)
         else
         {
             MatchStateTag = NewTag;
+            MARK_PROPERTY_DIRTY_FROM_NAME(AUR_GameState, MatchStateTag, this);
             OnRep_MatchStateTag();
         }
     }
@@ -72,34 +220,118 @@ void AUR_GameState::OnRep_MatchStateTag()
 
 void AUR_GameState::DefaultTimer()
 {
-    Super::DefaultTimer();
+    // Super counts ElapsedTime during match in progress only, and keeps the timer going.
+    // We derive it from the timeline instead, in all states, so we can benefit from clock in warmup and endgame.
+    // Skip Super so ElapsedTime isn't incremented (and OnRep_ElapsedTime called) before being overwritten, only keep the timer going.
+    GetWorldTimerManager().SetTimer(TimerHandle_DefaultTimer, this, &ThisClass::DefaultTimer, GetWorldSettings()->GetEffectiveTimeDilation() / GetWorldSettings()->DemoPlayTimeDilation, true);
+
+    UpdateClocks();
 
-    //NOTE: Super only counts elapsed time during match in progress.
-    // We want to count during other states as well, so we can benefit from clock in warmup and endgame.
-    if ( !IsMatchInProgress() )
+    // TimeUp delegate
+    if (TimeLimit > 0 && RemainingTime == 0 && !bTriggeredTimeUp)
+    {
+        bTriggeredTimeUp = true;    //set this before as a delegate might reset with SetTimeLimit()
+        OnTimeUp.Broadcast(this);
+    }
+}
+
+void AUR_GameState::UpdateClocks()
+{
+    const int32 NewElapsedTime = FMath::FloorToInt(MatchTimeline.GetClockTime(GetClockServerTime()) - MatchTimeline.MatchStartTime);
+    if (NewElapsedTime != ElapsedTime)
     {
-        ++ElapsedTime;
+        ElapsedTime = NewElapsedTime;
         if (GetNetMode() != NM_DedicatedServer)
         {
             OnRep_ElapsedTime();
         }
     }
 
-    // Clock sync
-    if (HasAuthority() && (ElapsedTime % 30) == 0)
+    RemainingTime = FMath::CeilToInt(GetPhaseRemainingTime());
+}
+
+float AUR_GameState::GetPhaseElapsedTime() const
+{
+    return static_cast<float>(FMath::Max(0.0, MatchTimeline.GetClockTime(GetClockServerTime()) - MatchTimeline.PhaseStartTime));
+}
+
+float AUR_GameState::GetPhaseRemainingTime() const
+{
+    return (MatchTimeline.TimeLimit > 0) ? FMath::Max(0.f, MatchTimeline.TimeLimit - GetPhaseElapsedTime()) : 0.f;
+}
+
+double AUR_GameState::GetClockServerTime() const
+{
+    double ServerTime = GetServerWorldTimeSeconds();
+    if (!HasAuthority())
     {
-        MulticastElapsedTime(ElapsedTime);
+        // Replicated server time is already late by the trip from server to client
+        const APlayerController* PC = GetWorld()->GetFirstPlayerController();
+        if (PC && PC->PlayerState)
+        {
+            ServerTime += 0.0005 * PC->PlayerState->GetPingInMilliseconds();
+        }
     }
+    return ServerTime;
+}
+
+void AUR_GameState::SetTimeLimit(int32 NewTimeLimit)
+{
+    StartClockPhase(NewTimeLimit);
 
-    // Remaining time
-    RemainingTime = FMath::Max(0, ClockReferencePoint + TimeLimit - ElapsedTime);
+    RemainingTime = FMath::Max(0, TimeLimit);
+    bTriggeredTimeUp = false;
+}
 
-    // TimeUp delegate
-    if (RemainingTime == 0 && !bTriggeredTimeUp)
+void AUR_GameState::ResetClock()
+{
+    StartClockPhase(0);
+}
+
+void AUR_GameState::StartClockPhase(int32 NewTimeLimit)
+{
+    TimeLimit = NewTimeLimit;
+
+    MatchTimeline.TimeLimit = NewTimeLimit;
+    MatchTimeline.PhaseStartTime = MatchTimeline.GetClockTime(GetWorld()->GetTimeSeconds());
+    MatchTimeline.PhaseId++;
+    LastPhaseId = MatchTimeline.PhaseId;
+    MARK_PROPERTY_DIRTY_FROM_NAME(AUR_GameState, MatchTimeline, this);
+    ForceNetUpdate();
+}
+
+void AUR_GameState::PauseClock()
+{
+    if (!MatchTimeline.IsPaused())
     {
-        bTriggeredTimeUp = true;    //set this before as a delegate might reset with SetTimeLimit()
-        OnTimeUp.Broadcast(this);
+        MatchTimeline.PauseStartTime = GetWorld()->GetTimeSeconds();
+        MARK_PROPERTY_DIRTY_FROM_NAME(AUR_GameState, MatchTimeline, this);
+        ForceNetUpdate();
+    }
+}
+
+void AUR_GameState::ResumeClock()
+{
+    if (MatchTimeline.IsPaused())
+    {
+        MatchTimeline.PausedDuration += GetWorld()->GetTimeSeconds() - MatchTimeline.PauseStartTime;
+        MatchTimeline.PauseStartTime = -1.0;
+        MARK_PROPERTY_DIRTY_FROM_NAME(AUR_GameState, MatchTimeline, this);
+        ForceNetUpdate();
+    }
+}
+
+void AUR_GameState::OnRep_MatchTimeline()
+{
+    TimeLimit = MatchTimeline.TimeLimit;
+
+    if (MatchTimeline.PhaseId != LastPhaseId)
+    {
+        LastPhaseId = MatchTimeline.PhaseId;
+        bTriggeredTimeUp = false;
     }
+
+    UpdateClocks();
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -160,6 +392,226 @@ void AUR_GameState::GetSpectators(TArray<APlayerState*>& OutSpectators)
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+void AUR_GameState::AddPlayerState(APlayerState* PlayerState)
+{
+    Super::AddPlayerState(PlayerState);
+
+    AUR_PlayerState* PS = Cast<AUR_PlayerState>(PlayerState);
+    if (PS && PS->LeaderboardIndex == INDEX_NONE)
+    {
+        PS->LeaderboardSerial = ++LeaderboardSerial;
+
+        const int32 Index = Algo::LowerBound(Leaderboard, PS, &LeaderboardPredicate);
+        Leaderboard.Insert(PS, Index);
+        for (int32 i = Index; i < Leaderboard.Num(); i++)
+        {
+            Leaderboard[i]->LeaderboardIndex = i;
+        }
+        OnLeaderboardChanged.Broadcast(this, Index, UpdateLeaderboardRanks(Index, Leaderboard.Num() - 1));
+    }
+}
+
+void AUR_GameState::RemovePlayerState(APlayerState* PlayerState)
+{
+    AUR_PlayerState* PS = Cast<AUR_PlayerState>(PlayerState);
+    if (PS && Leaderboard.IsValidIndex(PS->LeaderboardIndex) && Leaderboard[PS->LeaderboardIndex] == PS)
+    {
+        const int32 Index = PS->LeaderboardIndex;
+        Leaderboard.RemoveAt(Index);
+        PS->LeaderboardIndex = INDEX_NONE;
+        PS->LeaderboardRank = 0;
+        for (int32 i = Index; i < Leaderboard.Num(); i++)
+        {
+            Leaderboard[i]->LeaderboardIndex = i;
+        }
+        if (Index < Leaderboard.Num())
+        {
+            UpdateLeaderboardRanks(Index, Leaderboard.Num() - 1);
+        }
+        // Rows from Index to the previous end moved
+        OnLeaderboardChanged.Broadcast(this, Index, Leaderboard.Num());
+    }
+
+    Super::RemovePlayerState(PlayerState);
+}
+
+bool AUR_GameState::LeaderboardPredicate(const AUR_PlayerState* A, const AUR_PlayerState* B)
+{
+    const float ScoreA = A->GetScore();
+    const float ScoreB = B->GetScore();
+    return (ScoreA > ScoreB) || (ScoreA == ScoreB && A->LeaderboardSerial < B->LeaderboardSerial);
+}
+
+bool AUR_GameState::IsLeaderTied() const
+{
+    return Leaderboard.Num() > 1 && Leaderboard[1]->GetScore() == Leaderboard[0]->GetScore();
+}
+
+int32 AUR_GameState::GetLeaderboardRank(const AUR_PlayerState* PS) const
+{
+    return (PS && Leaderboard.IsValidIndex(PS->LeaderboardIndex) && Leaderboard[PS->LeaderboardIndex] == PS) ? PS->LeaderboardRank : 0;
+}
+
+void AUR_GameState::UpdateLeaderboard(AUR_PlayerState* PS)
+{
+    SCOPE_CYCLE_COUNTER(STAT_UpdateLeaderboard);
+
+    if (!PS || !Leaderboard.IsValidIndex(PS->LeaderboardIndex) || Leaderboard[PS->LeaderboardIndex] != PS)
+    {
+        return;
+    }
+
+    // Score changes are small, so the player usually moves by a few rows at most
+    const int32 OldIndex = PS->LeaderboardIndex;
+    int32 Index = OldIndex;
+    while (Index > 0 && LeaderboardPredicate(PS, Leaderboard[Index - 1]))
+    {
+        Leaderboard[Index] = Leaderboard[Index - 1];
+        Leaderboard[Index]->LeaderboardIndex = Index;
+        Index--;
+    }
+    while (Index < Leaderboard.Num() - 1 && LeaderboardPredicate(Leaderboard[Index + 1], PS))
+    {
+        Leaderboard[Index] = Leaderboard[Index + 1];
+        Leaderboard[Index]->LeaderboardIndex = Index;
+        Index++;
+    }
+    Leaderboard[Index] = PS;
+    PS->LeaderboardIndex = Index;
+
+    const int32 FirstIndex = FMath::Min(OldIndex, Index);
+    const int32 LastIndex = UpdateLeaderboardRanks(FirstIndex, FMath::Max(OldIndex, Index));
+    OnLeaderboardChanged.Broadcast(this, FirstIndex, LastIndex);
+}
+
+int32 AUR_GameState::UpdateLeaderboardRanks(int32 FirstIndex, int32 MinLastIndex)
+{
+    // A rank only depends on the previous row, so past the moved rows we can stop at the first unchanged rank
+    int32 i = FirstIndex;
+    for (; i < Leaderboard.Num(); i++)
+    {
+        AUR_PlayerState* PS = Leaderboard[i];
+        const int32 NewRank = (i > 0 && Leaderboard[i - 1]->GetScore() == PS->GetScore()) ? Leaderboard[i - 1]->LeaderboardRank : i + 1;
+        if (i > MinLastIndex && NewRank == PS->LeaderboardRank)
+        {
+            break;
+        }
+        PS->LeaderboardRank = NewRank;
+    }
+    return i - 1;
+}
+
+bool AUR_GameState::ValidateLeaderboard() const
+{
+    TArray<AUR_PlayerState*> Expected;
+    for (APlayerState* PlayerState : PlayerArray)
+    {
+        if (AUR_PlayerState* PS = Cast<AUR_PlayerState>(PlayerState))
+        {
+            Expected.Add(PS);
+        }
+    }
+    Algo::Sort(Expected, &LeaderboardPredicate);
+
+    int32 NumErrors = 0;
+    if (Expected.Num() != Leaderboard.Num())
+    {
+        UE_LOG(LogGameState, Warning, TEXT("Leaderboard: %i entries, expected %i"), Leaderboard.Num(), Expected.Num());
+        NumErrors++;
+    }
+    for (int32 i = 0; i < FMath::Min(Expected.Num(), Leaderboard.Num()); i++)
+    {
+        const AUR_PlayerState* PS = Leaderboard[i];
+        if (PS != Expected[i])
+        {
+            UE_LOG(LogGameState, Warning, TEXT("Leaderboard: row %i is %s, expected %s"), i, *PS->GetPlayerName(), *Expected[i]->GetPlayerName());
+            NumErrors++;
+        }
+        if (PS->LeaderboardIndex != i)
+        {
+            UE_LOG(LogGameState, Warning, TEXT("Leaderboard: row %i has index %i"), i, PS->LeaderboardIndex);
+            NumErrors++;
+        }
+        // Tied players share the rank of the first of them
+        const int32 ExpectedRank = (i > 0 && Expected[i - 1]->GetScore() == Expected[i]->GetScore()) ? Expected[i - 1]->LeaderboardRank : i + 1;
+        if (PS->LeaderboardRank != ExpectedRank)
+        {
+            UE_LOG(LogGameState, Warning, TEXT("Leaderboard: row %i has rank %i, expected %i"), i, PS->LeaderboardRank, ExpectedRank);
+            NumErrors++;
+        }
+    }
+
+    UE_LOG(LogGameState, Log, TEXT("Leaderboard: validated %i rows, %i errors"), Leaderboard.Num(), NumErrors);
+    return NumErrors == 0;
+}
+
+void AUR_GameState::BenchmarkLeaderboard(int32 Iterations)
+{
+    if (!HasAuthority() || Iterations <= 0 || Leaderboard.Num() == 0)
+    {
+        return;
+    }
+
+    // Deterministic sequence of score changes, reverted afterwards
+    FRandomStream Random(0);
+    TArray<AUR_PlayerState*> Changed;
+    Changed.Reserve(Iterations);
+
+    const double IncrementalStart = FPlatformTime::Seconds();
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        AUR_PlayerState* PS = Leaderboard[Random.RandHelper(Leaderboard.Num())];
+        PS->SetPlayerScore(PS->GetScore() + 1);
+        Changed.Add(PS);
+    }
+    const double IncrementalTime = FPlatformTime::Seconds() - IncrementalStart;
+
+    // What scanning or re-sorting on every change costs
+    TArray<AUR_PlayerState*> Sorted;
+    const double SortStart = FPlatformTime::Seconds();
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        Sorted.Reset();
+        for (APlayerState* PlayerState : PlayerArray)
+        {
+            if (AUR_PlayerState* PS = Cast<AUR_PlayerState>(PlayerState))
+            {
+                Sorted.Add(PS);
+            }
+        }
+        Algo::Sort(Sorted, &LeaderboardPredicate);
+    }
+    const double SortTime = FPlatformTime::Seconds() - SortStart;
+
+    const bool bValid = ValidateLeaderboard();
+
+    for (AUR_PlayerState* PS : Changed)
+    {
+        PS->SetPlayerScore(PS->GetScore() - 1);
+    }
+
+    UE_LOG(LogGameState, Log, TEXT("Leaderboard: %i players, %i changes: incremental %.4f ms, full sort %.4f ms per change (%s)"),
+        Leaderboard.Num(), Iterations, IncrementalTime * 1000.0 / Iterations, SortTime * 1000.0 / Iterations, bValid ? TEXT("valid") : TEXT("INVALID"));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AUR_GameState::AddFragEvent(AUR_PlayerState* Victim, AUR_PlayerState* Killer, TSubclassOf<UDamageType> DamType, const FGameplayTagContainer& EventTags)
+{
+    if (!OTConsoleVariables::bReplicateKillFeed)
+    {
+        MulticastFragEvent(Victim, Killer, DamType, EventTags);
+        return;
+    }
+
+    KillFeed.AddEntry(Victim, Killer, DamType, EventTags);
+
+    // Server side listeners (listen server HUD)
+    FragEvent.Broadcast(Victim, Killer, DamType, EventTags);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
 void AUR_GameState::OnRep_Winner()
 {
     OnWinnerAssigned.Broadcast(this);
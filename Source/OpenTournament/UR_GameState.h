@@ -7,6 +7,9 @@
 #include "CoreMinimal.h"
 #include "GameFramework/GameState.h"
 #include "GameplayTagContainer.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+#include "UR_KillFeed.h"
 
 #include "UR_GameState.generated.h"
 
@@ -14,6 +17,7 @@
 
 class AUR_TeamInfo;
 class AUR_Pickup;
+class AUR_PlayerState;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // Delegates
@@ -28,8 +32,54 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FGlobalPickupEventSignature, TSubcl
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FWinnerAssignedSignature, AUR_GameState*, GS);
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FLeaderboardChangedSignature, AUR_GameState*, GS, int32, FirstIndex, int32, LastIndex);
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * Replicated description of the match clock.
+ *
+ * Times are in "clock time": server world time minus the total time the clock was paused.
+ * A phase is a match/round/stage clock started by SetTimeLimit or ResetClock.
+ */
+USTRUCT()
+struct FUR_MatchTimeline
+{
+    GENERATED_BODY()
+
+    /** Clock time the match clock (ElapsedTime) started at */
+    UPROPERTY()
+    double MatchStartTime = 0.0;
+
+    /** Clock time the current phase started at */
+    UPROPERTY()
+    double PhaseStartTime = 0.0;
+
+    /** Total server time the clock was paused for */
+    UPROPERTY()
+    double PausedDuration = 0.0;
+
+    /** Server world time the clock was paused at, negative while running */
+    UPROPERTY()
+    double PauseStartTime = -1.0;
+
+    /** Time limit of the current phase, 0 for none */
+    UPROPERTY()
+    int32 TimeLimit = 0;
+
+    /** Incremented on every phase start, so restarting an identical phase is still seen by clients */
+    UPROPERTY()
+    uint8 PhaseId = 0;
+
+    bool IsPaused() const { return PauseStartTime >= 0.0; }
+
+    double GetClockTime(double ServerTime) const
+    {
+        return (IsPaused() ? PauseStartTime : ServerTime) - PausedDuration;
+    }
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
 
 /**
  * 
@@ -43,6 +93,8 @@ protected:
 
     AUR_GameState();
 
+    virtual void PostInitializeComponents() override;
+
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
     /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -101,41 +153,17 @@ protected:
     // Clock Management
     /////////////////////////////////////////////////////////////////////////////////////////////////
 
-protected:
-
-    /**
-    * Engine framework provides ElapsedTime, with replication InitialOnly.
-    * We need to sync up the clock every now and then, otherwise it will derive.
-    */
-    UFUNCTION(NetMulticast, Reliable)
-    void MulticastElapsedTime(float ServerElapsedTime);
-    virtual void MulticastElapsedTime_Implementation(float ServerElapsedTime)
-    {
-        ElapsedTime = ServerElapsedTime;
-    }
-
-    /**
-    * Now we can use ElapsedTime as an internal clock.
-    * Most of the time however, we are more interested in remaining time from a time limit.
-    */
-
 public:
 
     /**
     * Current match/round/stage time limit.
     * Use 0 for no time limit.
     */
-    UPROPERTY(Replicated, BlueprintReadOnly)
+    UPROPERTY(BlueprintReadOnly)
     int32 TimeLimit;
 
     /**
-    * Reference point to calculate the current match/round/stage elapsed time or remaining time.
-    */
-    UPROPERTY(ReplicatedUsing = OnRep_ClockReferencePoint)
-    int32 ClockReferencePoint;
-
-    /**
-    * Calculated remaining time based on the current reference point, assuming TimeLimit is set.
+    * Calculated remaining time based on the current clock phase, assuming TimeLimit is set.
     */
     UPROPERTY(BlueprintReadOnly)
     int32 RemainingTime;
@@ -144,26 +172,25 @@ public:
     * Define a new time limit and update the clock.
     */
     UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable)
-    virtual void SetTimeLimit(int32 NewTimeLimit)
-    {
-        TimeLimit = NewTimeLimit;
-        ClockReferencePoint = ElapsedTime;
-        ForceNetUpdate();
-
-        RemainingTime = FMath::Max(0, TimeLimit);
-        bTriggeredTimeUp = false;
-    }
+    virtual void SetTimeLimit(int32 NewTimeLimit);
 
     /**
     * When there is no time limit, use this to restart the clock.
     */
     UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable)
-    virtual void ResetClock()
-    {
-        TimeLimit = 0;
-        ClockReferencePoint = ElapsedTime;
-        ForceNetUpdate();
-    }
+    virtual void ResetClock();
+
+    /**
+    * Freeze the clock, eg. while waiting for players to get ready.
+    */
+    UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable)
+    void PauseClock();
+
+    UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable)
+    void ResumeClock();
+
+    UFUNCTION(BlueprintPure)
+    bool IsClockPaused() const { return MatchTimeline.IsPaused(); }
 
     /**
     * Get elapsed time according to the last clock reset.
@@ -171,9 +198,27 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure)
     virtual int32 GetCurrentElapsedTime()
     {
-        return ElapsedTime - ClockReferencePoint;
+        return FMath::FloorToInt(GetPhaseElapsedTime());
     }
 
+    /**
+    * Exact elapsed time of the current clock phase, derived from server time.
+    */
+    UFUNCTION(BlueprintPure)
+    float GetPhaseElapsedTime() const;
+
+    /**
+    * Exact remaining time of the current clock phase, 0 when there is no time limit.
+    */
+    UFUNCTION(BlueprintPure)
+    float GetPhaseRemainingTime() const;
+
+    /**
+    * Server world time, as best known locally.
+    * On clients, compensates the replicated server time for the one-way trip.
+    */
+    double GetClockServerTime() const;
+
     virtual void DefaultTimer() override;
 
     /**
@@ -195,11 +240,24 @@ public:
 
 protected:
 
+    /**
+    * Everything clients need to derive the clocks.
+    * Only replicates when a phase starts or the clock is paused/resumed, clocks are never synced periodically.
+    * ElapsedTime, TimeLimit and RemainingTime are local values computed from it.
+    */
+    UPROPERTY(ReplicatedUsing = OnRep_MatchTimeline)
+    FUR_MatchTimeline MatchTimeline;
+
     UFUNCTION()
-    virtual void OnRep_ClockReferencePoint()
-    {
-        bTriggeredTimeUp = false;
-    }
+    virtual void OnRep_MatchTimeline();
+
+    void StartClockPhase(int32 NewTimeLimit);
+
+    /** Recompute ElapsedTime and RemainingTime from the timeline */
+    void UpdateClocks();
+
+    /** Last phase seen, to reset bTriggeredTimeUp on new phases */
+    uint8 LastPhaseId = 0;
 
     /////////////////////////////////////////////////////////////////////////////////////////////////
     // Teams
@@ -229,6 +287,69 @@ public:
     UFUNCTION(BlueprintCallable)
     virtual void GetSpectators(TArray<APlayerState*>& OutSpectators);
 
+    /////////////////////////////////////////////////////////////////////////////////////////////////
+    // Leaderboard
+    /////////////////////////////////////////////////////////////////////////////////////////////////
+
+public:
+
+    virtual void AddPlayerState(APlayerState* PlayerState) override;
+    virtual void RemovePlayerState(APlayerState* PlayerState) override;
+
+    /**
+    * Player states ordered by score (highest first), ties ordered by arrival.
+    * Maintained incrementally on both server and clients, do not modify.
+    */
+    UPROPERTY(Transient, BlueprintReadOnly, Category = "Leaderboard")
+    TArray<AUR_PlayerState*> Leaderboard;
+
+    /**
+    * Rows of the leaderboard that changed (position, score or rank), from FirstIndex to LastIndex included.
+    * Scoreboards can redraw only these rows.
+    */
+    UPROPERTY(BlueprintAssignable)
+    FLeaderboardChangedSignature OnLeaderboardChanged;
+
+    /** Highest scoring player, null if there are no players */
+    UFUNCTION(BlueprintPure, Category = "Leaderboard")
+    AUR_PlayerState* GetLeader() const { return Leaderboard.Num() > 0 ? Leaderboard[0] : nullptr; }
+
+    /** True if another player has the same score as the leader */
+    UFUNCTION(BlueprintPure, Category = "Leaderboard")
+    bool IsLeaderTied() const;
+
+    /** Rank of a player, starting at 1. Tied players share the same rank. 0 if not found. */
+    UFUNCTION(BlueprintPure, Category = "Leaderboard")
+    int32 GetLeaderboardRank(const AUR_PlayerState* PS) const;
+
+    /** Called when the score of a player changed, moves it to its new position */
+    virtual void UpdateLeaderboard(AUR_PlayerState* PS);
+
+    /**
+    * Compare the leaderboard against a full sort of PlayerArray.
+    * Backs the OT.Leaderboard.Validate console command.
+    */
+    bool ValidateLeaderboard() const;
+
+    /**
+    * Time incremental updates against re-sorting for a sequence of score changes, then revert them.
+    * Backs the OT.Leaderboard.Benchmark console command.
+    */
+    void BenchmarkLeaderboard(int32 Iterations);
+
+protected:
+
+    static bool LeaderboardPredicate(const AUR_PlayerState* A, const AUR_PlayerState* B);
+
+    /**
+    * Recompute ranks from FirstIndex, at least until MinLastIndex.
+    * Returns the last index that was updated.
+    */
+    int32 UpdateLeaderboardRanks(int32 FirstIndex, int32 MinLastIndex);
+
+    /** Stamped on player states when they enter the leaderboard, orders ties */
+    int32 LeaderboardSerial = 0;
+
     /////////////////////////////////////////////////////////////////////////////////////////////////
     // Game Events
     /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -238,6 +359,12 @@ public:
     UPROPERTY(BlueprintAssignable)
     FFragEventSignature FragEvent;
 
+    /**
+    * Authority only. Notify a frag to everyone.
+    * Goes through the replicated kill feed, or the legacy multicast when OT.Net.KillFeed is 0.
+    */
+    void AddFragEvent(AUR_PlayerState* Victim, AUR_PlayerState* Killer, TSubclassOf<UDamageType> DamType, const FGameplayTagContainer& EventTags);
+
     UFUNCTION(NetMulticast, Reliable)
     void MulticastFragEvent(AUR_PlayerState* Victim, AUR_PlayerState* Killer, TSubclassOf<UDamageType> DamType, const FGameplayTagContainer& EventTags);
     virtual void MulticastFragEvent_Implementation(AUR_PlayerState* Victim, AUR_PlayerState* Killer, TSubclassOf<UDamageType> DamType, const FGameplayTagContainer& EventTags)
@@ -245,6 +372,14 @@ public:
         FragEvent.Broadcast(Victim, Killer, DamType, EventTags);
     }
 
+protected:
+
+    /** Recent frags, clients broadcast FragEvent as entries arrive */
+    UPROPERTY(Replicated)
+    FUR_KillFeed KillFeed;
+
+public:
+
     /**
     * Global pickup event for major items.
     * We pass a PickupClass here because the pickup may not always be relevant to players.
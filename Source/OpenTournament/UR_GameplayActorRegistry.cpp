@@ -0,0 +1,242 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_GameplayActorRegistry.h"
+
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+
+#include "UR_LogChannels.h"
+#include "UR_Projectile.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_GameplayActorRegistry)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT Actor Registry"), STATGROUP_OTActorRegistry, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Registered Actors"), STAT_RegisteredGameplayActors, STATGROUP_OTActorRegistry);
+
+namespace OTConsoleVariables
+{
+    static FAutoConsoleCommandWithWorldAndArgs CmdActorRegistryBenchmark(
+        TEXT("OT.ActorRegistry.Benchmark"),
+        TEXT("Time a match-end style sweep over all actors against the gameplay actor registry. Optional arg: iterations (default 100)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (auto Registry = World ? World->GetSubsystem<UUR_GameplayActorRegistry>() : nullptr)
+            {
+                Registry->Benchmark(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100);
+            }
+        }));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UUR_GameplayActorRegistry::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UUR_GameplayActorRegistry::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    ActorSpawnedHandle = GetWorld()->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ThisClass::OnActorSpawned));
+    LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &ThisClass::OnLevelAdded);
+}
+
+void UUR_GameplayActorRegistry::Deinitialize()
+{
+    GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+    FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+
+    Super::Deinitialize();
+}
+
+void UUR_GameplayActorRegistry::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    // Pawns placed in the persistent level
+    for (TActorIterator<APawn> PawnIt(&InWorld); PawnIt; ++PawnIt)
+    {
+        RegisterPawn(*PawnIt);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_GameplayActorRegistry::RegisterPawn(APawn* Pawn)
+{
+    if (IsValid(Pawn) && !EntryIndices.Contains(Pawn))
+    {
+        AddEntry(Pawn, EGameplayActorType::Pawn);
+        Pawn->OnEndPlay.AddUniqueDynamic(this, &ThisClass::OnPawnEndPlay);
+    }
+}
+
+void UUR_GameplayActorRegistry::OnActorSpawned(AActor* Actor)
+{
+    if (APawn* Pawn = Cast<APawn>(Actor))
+    {
+        RegisterPawn(Pawn);
+    }
+}
+
+void UUR_GameplayActorRegistry::OnLevelAdded(ULevel* Level, UWorld* InWorld)
+{
+    if (Level && InWorld == GetWorld())
+    {
+        for (AActor* Actor : Level->Actors)
+        {
+            if (APawn* Pawn = Cast<APawn>(Actor))
+            {
+                RegisterPawn(Pawn);
+            }
+        }
+    }
+}
+
+void UUR_GameplayActorRegistry::OnPawnEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+    RemoveEntry(Actor);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_GameplayActorRegistry::Register(AActor* Actor, EGameplayActorType Type)
+{
+    UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+    if (auto Registry = World ? World->GetSubsystem<UUR_GameplayActorRegistry>() : nullptr)
+    {
+        Registry->AddEntry(Actor, Type);
+    }
+}
+
+void UUR_GameplayActorRegistry::Unregister(AActor* Actor)
+{
+    UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+    if (auto Registry = World ? World->GetSubsystem<UUR_GameplayActorRegistry>() : nullptr)
+    {
+        Registry->RemoveEntry(Actor);
+    }
+}
+
+void UUR_GameplayActorRegistry::AddEntry(AActor* Actor, EGameplayActorType Type)
+{
+    if (int32* Index = EntryIndices.Find(Actor))
+    {
+        Entries[*Index].Type = Type;
+        return;
+    }
+
+    EntryIndices.Add(Actor, Entries.Add({ Actor, Actor, Type }));
+    SET_DWORD_STAT(STAT_RegisteredGameplayActors, Entries.Num());
+}
+
+void UUR_GameplayActorRegistry::RemoveEntry(AActor* Actor)
+{
+    int32 Index;
+    if (EntryIndices.RemoveAndCopyValue(Actor, Index))
+    {
+        Entries.RemoveAtSwap(Index, 1, false);
+        if (Entries.IsValidIndex(Index))
+        {
+            EntryIndices.Add(Entries[Index].Key, Index);
+        }
+        SET_DWORD_STAT(STAT_RegisteredGameplayActors, Entries.Num());
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_GameplayActorRegistry::ForEachActor(EGameplayActorType TypeMask, TFunctionRef<void(AActor*)> Func) const
+{
+    for (const FEntry& Entry : Entries)
+    {
+        if (EnumHasAnyFlags(Entry.Type, TypeMask))
+        {
+            if (AActor* Actor = Entry.Actor.Get())
+            {
+                Func(Actor);
+            }
+        }
+    }
+}
+
+void UUR_GameplayActorRegistry::SetCustomTimeDilation(EGameplayActorType TypeMask, float TimeDilation) const
+{
+    ForEachActor(TypeMask, [TimeDilation](AActor* Actor)
+    {
+        Actor->CustomTimeDilation = TimeDilation;
+    });
+}
+
+void UUR_GameplayActorRegistry::Benchmark(int32 Iterations) const
+{
+    if (Iterations <= 0)
+    {
+        return;
+    }
+
+    // Previous match-end freeze, full actor sweep
+    int32 NumWorldActors = 0;
+    int32 SweepMatches = 0;
+    const double SweepStart = FPlatformTime::Seconds();
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        NumWorldActors = 0;
+        SweepMatches = 0;
+        for (TActorIterator<AActor> ActorIt(GetWorld()); ActorIt; ++ActorIt)
+        {
+            NumWorldActors++;
+            if (Cast<APawn>(*ActorIt) || Cast<AUR_Projectile>(*ActorIt))
+            {
+                SweepMatches++;
+            }
+        }
+    }
+    const double SweepTime = FPlatformTime::Seconds() - SweepStart;
+
+    // Class iterators, only visit pawns and projectiles
+    int32 ClassMatches = 0;
+    const double ClassStart = FPlatformTime::Seconds();
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        ClassMatches = 0;
+        for (TActorIterator<APawn> PawnIt(GetWorld()); PawnIt; ++PawnIt)
+        {
+            ClassMatches++;
+        }
+        for (TActorIterator<AUR_Projectile> ProjectileIt(GetWorld()); ProjectileIt; ++ProjectileIt)
+        {
+            ClassMatches++;
+        }
+    }
+    const double ClassTime = FPlatformTime::Seconds() - ClassStart;
+
+    // Shipping loop, see AUR_GameMode::HandleMatchHasEnded. Writes the current value back so nothing changes.
+    int32 RegistryMatches = 0;
+    const double RegistryStart = FPlatformTime::Seconds();
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        RegistryMatches = 0;
+        ForEachActor(MatchEndFreezeTypes, [&RegistryMatches](AActor* Actor)
+        {
+            Actor->CustomTimeDilation = Actor->CustomTimeDilation;
+            RegistryMatches++;
+        });
+    }
+    const double RegistryTime = FPlatformTime::Seconds() - RegistryStart;
+
+    UE_LOG(LogGame, Log, TEXT("ActorRegistry: %i world actors, %i registered, %i iterations: sweep %.3f ms, class iterators %.3f ms, registry %.3f ms"),
+        NumWorldActors, Entries.Num(), Iterations, SweepTime * 1000.0 / Iterations, ClassTime * 1000.0 / Iterations, RegistryTime * 1000.0 / Iterations);
+
+    if (RegistryMatches != SweepMatches || RegistryMatches != ClassMatches)
+    {
+        UE_LOG(LogGame, Warning, TEXT("ActorRegistry: registry found %i pawns/projectiles, sweep found %i, class iterators found %i"), RegistryMatches, SweepMatches, ClassMatches);
+    }
+}
@@ -0,0 +1,109 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UR_GameplayActorRegistry.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Kinds of gameplay-dynamic actors, usable as a bitmask.
+ */
+UENUM(meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EGameplayActorType : uint8
+{
+    None = 0,
+    Pawn = 1 << 0,
+    Projectile = 1 << 1,
+    Pickup = 1 << 2,
+
+    All = Pawn | Projectile | Pickup,
+};
+ENUM_CLASS_FLAGS(EGameplayActorType);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Registry of gameplay-dynamic actors (pawns, projectiles, pickups).
+ *
+ * Projectiles and pickups register themselves on BeginPlay and unregister on EndPlay.
+ * Every pawn is registered by the registry itself (spawned, placed or streamed in),
+ * so vehicles, spectators and pawns from plugins are included without cooperation.
+ * Match-wide operations (slow motion, freezing, resets) iterate this set
+ * instead of sweeping every actor of the world, most of which are static level actors.
+ *
+ * Exists on server and clients.
+ */
+UCLASS()
+class OPENTOURNAMENT_API UUR_GameplayActorRegistry : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    //~UWorldSubsystem interface
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    //~End of UWorldSubsystem interface
+
+    /** Actors frozen by AUR_GameMode::HandleMatchHasEnded */
+    static constexpr EGameplayActorType MatchEndFreezeTypes = EGameplayActorType::Pawn | EGameplayActorType::Projectile;
+
+    static void Register(AActor* Actor, EGameplayActorType Type);
+
+    static void Unregister(AActor* Actor);
+
+    /** Call Func on every registered actor whose type matches the mask */
+    void ForEachActor(EGameplayActorType TypeMask, TFunctionRef<void(AActor*)> Func) const;
+
+    /** Apply CustomTimeDilation to every registered actor whose type matches the mask */
+    void SetCustomTimeDilation(EGameplayActorType TypeMask, float TimeDilation) const;
+
+    int32 Num() const { return Entries.Num(); }
+
+    /**
+    * Time the match-end freeze loop over the registry against a full actor sweep and class iterators,
+    * and check that the registry found every pawn and projectile.
+    * Backs the OT.ActorRegistry.Benchmark console command.
+    */
+    void Benchmark(int32 Iterations) const;
+
+protected:
+
+    struct FEntry
+    {
+        TWeakObjectPtr<AActor> Actor;
+        /** Kept so the index map stays consistent even if the actor was garbage collected */
+        TObjectKey<AActor> Key;
+        EGameplayActorType Type;
+    };
+
+    /** Packed, removal swaps with last */
+    TArray<FEntry> Entries;
+
+    TMap<TObjectKey<AActor>, int32> EntryIndices;
+
+    void AddEntry(AActor* Actor, EGameplayActorType Type);
+
+    void RemoveEntry(AActor* Actor);
+
+    void RegisterPawn(APawn* Pawn);
+
+    void OnActorSpawned(AActor* Actor);
+
+    void OnLevelAdded(ULevel* Level, UWorld* InWorld);
+
+    UFUNCTION()
+    void OnPawnEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+
+    FDelegateHandle ActorSpawnedHandle;
+
+    FDelegateHandle LevelAddedHandle;
+};
@@ -28,6 +28,9 @@ namespace URGameplayTags
     UE_DEFINE_GAMEPLAY_TAG(TAG_Character_States_Physics_Swimming, "Character.States.Movement.Swimming");
     UE_DEFINE_GAMEPLAY_TAG(TAG_Character_States_Physics_Flying,   "Character.States.Movement.Flying");
 
+    UE_DEFINE_GAMEPLAY_TAG(TAG_Pickup_Health, "Pickup.Health");
+    UE_DEFINE_GAMEPLAY_TAG(TAG_Pickup_Weapon, "Pickup.Weapon");
+
     UE_DEFINE_GAMEPLAY_TAG_COMMENT(Cheat_GodMode, "Cheat.GodMode", "GodMode cheat is active on the owner.");
 	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Cheat_UnlimitedHealth, "Cheat.UnlimitedHealth", "UnlimitedHealth cheat is active on the owner.");
 
@@ -27,6 +27,9 @@ namespace URGameplayTags
     OPENTOURNAMENT_API  UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Character_States_Physics_Swimming);
     OPENTOURNAMENT_API  UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Character_States_Physics_Flying);
 
+    OPENTOURNAMENT_API  UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Pickup_Health);
+    OPENTOURNAMENT_API  UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Pickup_Weapon);
+
     //
 
     OPENTOURNAMENT_API	UE_DECLARE_GAMEPLAY_TAG_EXTERN(Cheat_GodMode);
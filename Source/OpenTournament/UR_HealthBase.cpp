@@ -3,8 +3,34 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "UR_HealthBase.h"
+
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+
 #include "UR_Character.h"
 #include "UR_AttributeSet.h"
+#include "UR_FunctionLibrary.h"
+#include "UR_GameplayTags.h"
+#include "UR_LogChannels.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace OTConsoleVariables
+{
+    static FAutoConsoleCommandWithWorldAndArgs CmdPickupPredictionTest(
+        TEXT("OT.Pickup.PredictionTest"),
+        TEXT("PIE client only, server in the same process. Check predicted health pickups are confirmed or rolled back under emulated latency. Optional args: latency ms (default 150), jitter ms (default 30), rounds (default 3)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            AUR_HealthBase::RunPredictionTest(World,
+                Args.Num() > 0 ? FCString::Atof(*Args[0]) : 150.f,
+                Args.Num() > 1 ? FCString::Atof(*Args[1]) : 30.f,
+                Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 3);
+        }));
+}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -12,6 +38,10 @@ AUR_HealthBase::AUR_HealthBase()
 {
     HealAmount = 25;
     bSuperHeal = false;
+    PrePredictionHealth = 0.f;
+    PredictedHealth = 0.f;
+
+    GameplayTags.AddTag(URGameplayTags::TAG_Pickup_Health);
 }
 
 bool AUR_HealthBase::AllowPickupBy_Implementation(class AActor* Other)
@@ -38,7 +68,7 @@ void AUR_HealthBase::GiveTo_Implementation(class AActor* Other)
     {
         // @! TODO : This is Temporary. Healing should be done via GameplayEffect.
         const int32 CurrentHealth = static_cast<int32>(Char->AttributeSet->GetHealth());
-        const int32 FinalHealth = FMath::Min<int32>(CurrentHealth + HealAmount, Char->AttributeSet->GetHealthMax() + (bSuperHeal ? Char->AttributeSet->GetOverHealthMax() : 0));
+        const int32 FinalHealth = GetHealthAfterPickup(Char->AttributeSet);
         if (FinalHealth > CurrentHealth)
         {
             GAME_LOG(Game, Log, "Health Pickup: %d + %d -> %d", CurrentHealth, FinalHealth - CurrentHealth, FinalHealth);
@@ -49,7 +79,265 @@ void AUR_HealthBase::GiveTo_Implementation(class AActor* Other)
     Super::GiveTo_Implementation(Other);
 }
 
+int32 AUR_HealthBase::GetHealthAfterPickup(const UUR_AttributeSet* AttributeSet) const
+{
+    const int32 CurrentHealth = static_cast<int32>(AttributeSet->GetHealth());
+    return FMath::Max<int32>(CurrentHealth, FMath::Min<int32>(CurrentHealth + HealAmount, AttributeSet->GetHealthMax() + (bSuperHeal ? AttributeSet->GetOverHealthMax() : 0)));
+}
+
+void AUR_HealthBase::ApplyPredictedEffects_Implementation(AActor* LocalClientActor)
+{
+    AUR_Character* Char = Cast<AUR_Character>(LocalClientActor);
+    if (Char && Char->AttributeSet)
+    {
+        PrePredictionHealth = Char->AttributeSet->GetHealth();
+        PredictedHealth = GetHealthAfterPickup(Char->AttributeSet);
+        Char->AttributeSet->SetHealth(PredictedHealth);
+    }
+}
+
+void AUR_HealthBase::RollbackPredictedEffects_Implementation(AActor* LocalClientActor)
+{
+    AUR_Character* Char = Cast<AUR_Character>(LocalClientActor);
+    // Only undo if nothing (replication, damage) changed health in the meantime
+    if (Char && Char->AttributeSet && Char->AttributeSet->GetHealth() == PredictedHealth)
+    {
+        Char->AttributeSet->SetHealth(PrePredictionHealth);
+    }
+}
+
 FText AUR_HealthBase::GetItemName_Implementation()
 {
     return FText::FromString(FString::Printf(TEXT("%i Health"), HealAmount));
 }
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AUR_HealthBase::RunPredictionTest(UWorld* ClientWorld, float LatencyMs, float JitterMs, int32 Rounds)
+{
+    UWorld* ServerWorld = UUR_FunctionLibrary::FindServerWorldInProcess(ClientWorld);
+    if (!ServerWorld)
+    {
+        UE_LOG(LogGame, Warning, TEXT("PickupPrediction: run from a PIE client, with the server in the same process"));
+        return;
+    }
+    const IConsoleVariable* CVarPredictEffects = IConsoleManager::Get().FindConsoleVariable(TEXT("OT.PredictPickupEffects"));
+    if (CVarPredictEffects && !CVarPredictEffects->GetBool())
+    {
+        UE_LOG(LogGame, Warning, TEXT("PickupPrediction: OT.PredictPickupEffects is off"));
+        return;
+    }
+
+    // Local character and its server counterpart
+    APlayerController* ClientPC = ClientWorld->GetFirstPlayerController();
+    AUR_Character* ClientChar = ClientPC ? ClientPC->GetPawn<AUR_Character>() : nullptr;
+    AUR_Character* ServerChar = nullptr;
+    for (FConstPlayerControllerIterator It = ServerWorld->GetPlayerControllerIterator(); It && ClientChar; ++It)
+    {
+        const APlayerController* PC = It->Get();
+        if (PC && PC->PlayerState && ClientPC->PlayerState && PC->PlayerState->GetPlayerId() == ClientPC->PlayerState->GetPlayerId())
+        {
+            ServerChar = PC->GetPawn<AUR_Character>();
+        }
+    }
+
+    // Any placed health pickup, found by name in both worlds
+    AUR_HealthBase* ClientPickup = nullptr;
+    AUR_HealthBase* ServerPickup = nullptr;
+    for (TActorIterator<AUR_HealthBase> It(ClientWorld); It && !ServerPickup; ++It)
+    {
+        if (It->IsNetStartupActor() && It->HealAmount > 0)
+        {
+            for (TActorIterator<AUR_HealthBase> ServerIt(ServerWorld); ServerIt; ++ServerIt)
+            {
+                if (ServerIt->GetFName() == It->GetFName())
+                {
+                    ClientPickup = *It;
+                    ServerPickup = *ServerIt;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!ClientChar || !ServerChar || !ClientChar->AttributeSet || !ServerChar->AttributeSet || !ClientPickup)
+    {
+        UE_LOG(LogGame, Warning, TEXT("PickupPrediction: needs a live local character and a health pickup placed in the map"));
+        return;
+    }
+
+    if (!UUR_FunctionLibrary::SetPacketSimulation(ClientWorld, ServerWorld, LatencyMs, JitterMs))
+    {
+        UE_LOG(LogGame, Warning, TEXT("PickupPrediction: packet simulation is not available in this build, testing without added latency"));
+    }
+
+    enum class EScenario : uint8 { Confirm, Reject, Timeout, MAX };
+    enum class EPhase : uint8 { Setup, Predict, ServerAct, Wait };
+
+    struct FPredictionTest
+    {
+        TWeakObjectPtr<AUR_Character> ClientChar;
+        TWeakObjectPtr<AUR_Character> ServerChar;
+        TWeakObjectPtr<AUR_HealthBase> ClientPickup;
+        TWeakObjectPtr<AUR_HealthBase> ServerPickup;
+        int32 Step = 0;
+        int32 NumSteps = 0;
+        EPhase Phase = EPhase::Setup;
+        double PhaseStartTime = 0.0;
+        double PredictTime = 0.0;
+        double ResolveTime = 0.0;
+        float StartHealth = 0.f;
+        float PredictedHealth = 0.f;
+        bool bRolledBackEarly = false;
+        int32 NumErrors = 0;
+    };
+    TSharedRef<FPredictionTest> Test = MakeShared<FPredictionTest>();
+    Test->ClientChar = ClientChar;
+    Test->ServerChar = ServerChar;
+    Test->ClientPickup = ClientPickup;
+    Test->ServerPickup = ServerPickup;
+    Test->NumSteps = FMath::Max(Rounds, 1) * static_cast<int32>(EScenario::MAX);
+    Test->PhaseStartTime = FPlatformTime::Seconds();
+
+    UE_LOG(LogGame, Log, TEXT("PickupPrediction: latency %.0f ms, jitter %.0f ms, %i predictions on %s"), LatencyMs, JitterMs, Test->NumSteps, *ClientPickup->GetName());
+
+    // Everything the server sends has arrived by then
+    const double SettleTime = (LatencyMs + 2.f * JitterMs) / 1000.0 + 0.25;
+    // Rejections must come from the server, well before the prediction check delay
+    const double CheckDelay = 1.5;
+
+    TWeakObjectPtr<UWorld> WeakClientWorld(ClientWorld);
+    TWeakObjectPtr<UWorld> WeakServerWorld(ServerWorld);
+    FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Test, WeakClientWorld, WeakServerWorld, LatencyMs, SettleTime, CheckDelay](float DeltaTime)
+    {
+        AUR_Character* ClientChar = Test->ClientChar.Get();
+        AUR_Character* ServerChar = Test->ServerChar.Get();
+        AUR_HealthBase* ClientPickup = Test->ClientPickup.Get();
+        AUR_HealthBase* ServerPickup = Test->ServerPickup.Get();
+        if (!ClientChar || !ServerChar || !ClientPickup || !ServerPickup || !ClientChar->IsAlive())
+        {
+            UE_LOG(LogGame, Warning, TEXT("PickupPrediction: character or pickup went away, aborted"));
+            UUR_FunctionLibrary::SetPacketSimulation(WeakClientWorld.Get(), WeakServerWorld.Get(), 0.f, 0.f);
+            return false;
+        }
+
+        const double Now = FPlatformTime::Seconds();
+        const double PhaseTime = Now - Test->PhaseStartTime;
+        const EScenario Scenario = static_cast<EScenario>(Test->Step % static_cast<int32>(EScenario::MAX));
+        const TCHAR* ScenarioName = Scenario == EScenario::Confirm ? TEXT("confirm") : Scenario == EScenario::Reject ? TEXT("reject") : TEXT("timeout");
+        const float ClientHealth = ClientChar->AttributeSet->GetHealth();
+        const float ServerHealth = ServerChar->AttributeSet->GetHealth();
+
+        const auto SetPhase = [&](EPhase NewPhase)
+        {
+            Test->Phase = NewPhase;
+            Test->PhaseStartTime = Now;
+        };
+        const auto Fail = [&](const FString& Error)
+        {
+            UE_LOG(LogGame, Warning, TEXT("PickupPrediction: %i %s: %s"), Test->Step, ScenarioName, *Error);
+            Test->NumErrors++;
+        };
+
+        switch (Test->Phase)
+        {
+        case EPhase::Setup:
+            // Leave room for the heal, and wait for the client to agree on the starting health
+            if (Test->StartHealth == 0.f)
+            {
+                Test->StartHealth = FMath::Max(1.f, ServerChar->AttributeSet->GetHealthMax() - ClientPickup->HealAmount);
+                ServerChar->AttributeSet->SetHealth(Test->StartHealth);
+            }
+            if (ClientHealth == Test->StartHealth && !ClientPickup->ActivePrediction.IsActive() && PhaseTime >= SettleTime)
+            {
+                SetPhase(EPhase::Predict);
+            }
+            else if (PhaseTime > CheckDelay + 2.0 * SettleTime)
+            {
+                Fail(FString::Printf(TEXT("client health %.0f never replicated, expected %.0f"), ClientHealth, Test->StartHealth));
+                SetPhase(EPhase::Predict);
+            }
+            break;
+
+        case EPhase::Predict:
+            ClientPickup->SimulateGiveTo(ClientChar);
+            Test->PredictedHealth = ClientPickup->PredictedHealth;
+            Test->PredictTime = Now;
+            Test->ResolveTime = 0.0;
+            Test->bRolledBackEarly = false;
+            if (!ClientPickup->ActivePrediction.IsActive() || ClientChar->AttributeSet->GetHealth() != Test->PredictedHealth || Test->PredictedHealth <= Test->StartHealth)
+            {
+                Fail(FString::Printf(TEXT("prediction not applied, health %.0f, predicted %.0f"), ClientChar->AttributeSet->GetHealth(), Test->PredictedHealth));
+            }
+            SetPhase(EPhase::ServerAct);
+            break;
+
+        case EPhase::ServerAct:
+            // The server sees the overlap about half a round trip after the client
+            if (PhaseTime < 0.5 * LatencyMs / 1000.0)
+            {
+                break;
+            }
+            if (Scenario == EScenario::Confirm)
+            {
+                ServerPickup->GiveTo(ServerChar);
+            }
+            else if (Scenario == EScenario::Reject)
+            {
+                // Taken by someone else, as far as the client can tell
+                ServerPickup->GiveTo(nullptr);
+            }
+            SetPhase(EPhase::Wait);
+            break;
+
+        case EPhase::Wait:
+            if (Test->ResolveTime == 0.0 && !ClientPickup->ActivePrediction.IsActive())
+            {
+                Test->ResolveTime = Now;
+            }
+            // A confirmed prediction must never flicker back to the old value
+            if (Scenario == EScenario::Confirm && ClientHealth < Test->PredictedHealth)
+            {
+                Test->bRolledBackEarly = true;
+            }
+            if (Test->ResolveTime == 0.0 ? PhaseTime < CheckDelay + SettleTime : Now - Test->ResolveTime < SettleTime)
+            {
+                break;
+            }
+
+            {
+                const float ExpectedHealth = Scenario == EScenario::Confirm ? Test->PredictedHealth : Test->StartHealth;
+                const double ResolveDelay = Test->ResolveTime - Test->PredictTime;
+                if (Test->ResolveTime == 0.0)
+                {
+                    Fail(TEXT("prediction never resolved"));
+                }
+                else if (Scenario == EScenario::Timeout ? ResolveDelay < CheckDelay : ResolveDelay >= CheckDelay)
+                {
+                    Fail(FString::Printf(TEXT("resolved after %.0f ms"), 1000.0 * ResolveDelay));
+                }
+                if (Test->bRolledBackEarly)
+                {
+                    Fail(TEXT("predicted health was rolled back before confirmation"));
+                }
+                if (ClientHealth != ExpectedHealth || ServerHealth != ExpectedHealth)
+                {
+                    Fail(FString::Printf(TEXT("health client %.0f server %.0f, expected %.0f"), ClientHealth, ServerHealth, ExpectedHealth));
+                }
+                UE_LOG(LogGame, Log, TEXT("  %i %s: resolved after %.0f ms, health %.0f -> %.0f"), Test->Step, ScenarioName, 1000.0 * ResolveDelay, Test->StartHealth, ClientHealth);
+            }
+
+            if (++Test->Step < Test->NumSteps)
+            {
+                Test->StartHealth = 0.f;
+                SetPhase(EPhase::Setup);
+                break;
+            }
+
+            UUR_FunctionLibrary::SetPacketSimulation(WeakClientWorld.Get(), WeakServerWorld.Get(), 0.f, 0.f);
+            UE_LOG(LogGame, Log, TEXT("PickupPrediction: %i predictions, %i errors -> %s"), Test->NumSteps, Test->NumErrors, Test->NumErrors == 0 ? TEXT("PASS") : TEXT("FAIL"));
+            return false;
+        }
+        return true;
+    }));
+}
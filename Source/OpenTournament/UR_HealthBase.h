@@ -32,4 +32,22 @@ public:
 	virtual void GiveTo_Implementation(class AActor* Other) override;
 	virtual FText GetItemName_Implementation() override;
 
+	/**
+	* Run health pickup predictions under emulated latency and jitter, and check that the predicted health is
+	* confirmed when the server gives us the pickup, and rolled back when it gives it to someone else or never answers.
+	* PIE client only, with the server in the same process. Backs the OT.Pickup.PredictionTest console command.
+	*/
+	static void RunPredictionTest(UWorld* ClientWorld, float LatencyMs, float JitterMs, int32 Rounds);
+
+protected:
+	virtual void ApplyPredictedEffects_Implementation(AActor* LocalClientActor) override;
+	virtual void RollbackPredictedEffects_Implementation(AActor* LocalClientActor) override;
+
+	/** Health the character would have after picking this up */
+	int32 GetHealthAfterPickup(const class UUR_AttributeSet* AttributeSet) const;
+
+	/** Health before and after the predicted pickup, for rollback */
+	float PrePredictionHealth;
+	float PredictedHealth;
+
 };
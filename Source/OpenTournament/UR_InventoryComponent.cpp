@@ -13,12 +13,96 @@
 #include "UR_Ammo.h"
 #include "UR_UserSettings.h"
 #include "UR_Pickup_DroppedWeapon.h"
+#include "UR_DroppedPickupSubsystem.h"
+#include "UR_Character.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT Inventory"), STATGROUP_OTInventory, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Replicated Ammo Actors Spawned"), STAT_ReplicatedAmmoSpawned, STATGROUP_OTInventory);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Local Ammo Actors Spawned"), STAT_LocalAmmoSpawned, STATGROUP_OTInventory);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ammo Slot Updates"), STAT_AmmoSlotUpdates, STATGROUP_OTInventory);
+DECLARE_CYCLE_STAT(TEXT("Update Weapon Groups"), STAT_UpdateWeaponGroups, STATGROUP_OTInventory);
+DECLARE_CYCLE_STAT(TEXT("Rebuild Weapon Switch Table"), STAT_RebuildWeaponSwitchTable, STATGROUP_OTInventory);
+
+namespace OTConsoleVariables
+{
+    static FAutoConsoleCommandWithWorldAndArgs CmdInventoryAmmoReport(
+        TEXT("OT.Inventory.AmmoReport"),
+        TEXT("Log ammo storage of every pawn: ammo actors, how many replicate, and packed slots."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (!World)
+            {
+                return;
+            }
+            for (TActorIterator<AUR_Character> It(World); It; ++It)
+            {
+                if (UUR_InventoryComponent* Inv = It->InventoryComponent)
+                {
+                    int32 NumReplicated = 0;
+                    for (AUR_Ammo* Ammo : Inv->AmmoArray)
+                    {
+                        NumReplicated += (Ammo && Ammo->GetIsReplicated()) ? 1 : 0;
+                    }
+                    UE_LOG(LogTemp, Log, TEXT("%s: %s ammo storage, %d ammo actors (%d replicated), %d packed slots, %d weapons"),
+                        *It->GetName(), Inv->bCompactAmmoStorage ? TEXT("compact") : TEXT("actor"),
+                        Inv->AmmoArray.Num(), NumReplicated, Inv->AmmoState.Num(), Inv->WeaponArray.Num());
+                }
+            }
+        }));
+
+    static FAutoConsoleCommandWithWorldAndArgs CmdInventoryValidateWeaponGroups(
+        TEXT("OT.Inventory.ValidateWeaponGroups"),
+        TEXT("Check that incremental weapon group updates of local players match a full rebuild, and time both. Optional arg: iterations (default 1000)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (!World)
+            {
+                return;
+            }
+            const int32 Iterations = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000;
+            for (TActorIterator<AUR_Character> It(World); It; ++It)
+            {
+                if (It->IsLocallyControlled() && It->InventoryComponent)
+                {
+                    It->InventoryComponent->ValidateWeaponGroups(Iterations);
+                }
+            }
+        }));
+
+    static FAutoConsoleCommandWithWorldAndArgs CmdInventoryValidateWeaponSwitch(
+        TEXT("OT.Inventory.ValidateWeaponSwitch"),
+        TEXT("Check next/prev/preferred weapon lookups of local players against evaluating weapon groups on demand, from every weapon."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (!World)
+            {
+                return;
+            }
+            for (TActorIterator<AUR_Character> It(World); It; ++It)
+            {
+                if (It->IsLocallyControlled() && It->InventoryComponent)
+                {
+                    It->InventoryComponent->ValidateWeaponSwitchTable();
+                }
+            }
+        }));
+}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 UUR_InventoryComponent::UUR_InventoryComponent()
 {
     SetIsReplicatedByDefault(true);
+    bWantsInitializeComponent = true;
+}
+
+void UUR_InventoryComponent::InitializeComponent()
+{
+    Super::InitializeComponent();
+
+    AmmoState.SetOwner(this);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -28,7 +112,17 @@ void UUR_InventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
     DOREPLIFETIME_CONDITION(ThisClass, WeaponArray, COND_OwnerOnly);
-    DOREPLIFETIME_CONDITION(ThisClass, AmmoArray, COND_OwnerOnly);
+    // Config, so this is the same for all instances (and the CDO building the layout)
+    if (bCompactAmmoStorage)
+    {
+        DOREPLIFETIME_CONDITION(ThisClass, AmmoState, COND_OwnerOnly);
+        DISABLE_REPLICATED_PROPERTY(ThisClass, AmmoArray);
+    }
+    else
+    {
+        DOREPLIFETIME_CONDITION(ThisClass, AmmoArray, COND_OwnerOnly);
+        DISABLE_REPLICATED_PROPERTY(ThisClass, AmmoState);
+    }
     DOREPLIFETIME_CONDITION(ThisClass, DesiredWeapon, COND_SkipOwner);
 }
 
@@ -89,11 +183,7 @@ void UUR_InventoryComponent::AddWeapon(AUR_Weapon* InWeapon)
     */
 
     // Set ammo refs
-    InWeapon->AmmoRefs.SetNumZeroed(InWeapon->AmmoDefinitions.Num());
-    for (int32 i = 0; i < InWeapon->AmmoDefinitions.Num(); i++)
-    {
-        InWeapon->AmmoRefs[i] = GetAmmoByClass(InWeapon->AmmoDefinitions[i].AmmoClass);
-    }
+    ResolveAmmoRefs(InWeapon);
 
     // In standalone or listen host, call OnRep next tick so we can pick amongst new weapons what to swap to.
     if (IsLocallyControlled())
@@ -122,14 +212,22 @@ AUR_Ammo* UUR_InventoryComponent::GetAmmoByClass(TSubclassOf<AUR_Ammo> InAmmoCla
             }
         }
 
-        if (bAutoCreate && GetOwnerRole() == ROLE_Authority)
+        // In compact mode, owning client creates its own local instances
+        if (bAutoCreate && (GetOwnerRole() == ROLE_Authority || bCompactAmmoStorage))
         {
-            FActorSpawnParameters SpawnParams;
-            SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-            SpawnParams.Owner = GetOwner();
-            AUR_Ammo* NewAmmo = GetWorld()->SpawnActor<AUR_Ammo>(InAmmoClass, SpawnParams);
+            AUR_Ammo* NewAmmo = GetWorld()->SpawnActorDeferred<AUR_Ammo>(InAmmoClass, FTransform::Identity, GetOwner(), nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
             if (NewAmmo)
             {
+                if (bCompactAmmoStorage)
+                {
+                    NewAmmo->SetReplicates(false);
+                    INC_DWORD_STAT(STAT_LocalAmmoSpawned);
+                }
+                else
+                {
+                    INC_DWORD_STAT(STAT_ReplicatedAmmoSpawned);
+                }
+                NewAmmo->FinishSpawning(FTransform::Identity);
                 AmmoArray.Add(NewAmmo);
                 return NewAmmo;
             }
@@ -139,6 +237,33 @@ AUR_Ammo* UUR_InventoryComponent::GetAmmoByClass(TSubclassOf<AUR_Ammo> InAmmoCla
     return NULL;
 }
 
+void UUR_InventoryComponent::NotifyAmmoCountChanged(AUR_Ammo* Ammo)
+{
+    if (bCompactAmmoStorage && Ammo && GetOwnerRole() == ROLE_Authority)
+    {
+        AmmoState.SetAmmoCount(Ammo->GetClass(), Ammo->AmmoCount);
+        INC_DWORD_STAT(STAT_AmmoSlotUpdates);
+    }
+}
+
+void UUR_InventoryComponent::OnRep_AmmoSlot(TSubclassOf<AUR_Ammo> InAmmoClass, int32 AmmoCount)
+{
+    if (AUR_Ammo* Ammo = GetAmmoByClass(InAmmoClass, AmmoCount > 0))
+    {
+        // Overrides any local prediction
+        Ammo->SetAmmoCount(AmmoCount);
+    }
+}
+
+void UUR_InventoryComponent::ResolveAmmoRefs(AUR_Weapon* InWeapon)
+{
+    InWeapon->AmmoRefs.SetNumZeroed(InWeapon->AmmoDefinitions.Num());
+    for (int32 i = 0; i < InWeapon->AmmoDefinitions.Num(); i++)
+    {
+        InWeapon->AmmoRefs[i] = GetAmmoByClass(InWeapon->AmmoDefinitions[i].AmmoClass, bCompactAmmoStorage);
+    }
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 void UUR_InventoryComponent::SelectWeapon(int32 Index)
@@ -177,88 +302,237 @@ bool UUR_InventoryComponent::NextWeapon()
 
     // Option 2 : build an array of weapons from visible groups, remove duplicates, then work with that.
 
-    TArray<AUR_Weapon*> WorkArray;
-    for (auto& Group : WeaponGroups)
+    // We go with option 2, precomputed in WeaponSwitchTable.
+
+    if (AUR_Weapon* Weapon = GetSwitchWeapon(true))
     {
-        if (Group.Visibility != EWeaponGroupVisibility::Hidden)
-        {
-            for (auto Weapon : Group.Weapons)
-            {
-                // Only include weappons with ammo, and also current weapon for reference
-                if (Weapon && (Weapon->HasAnyAmmo() || Weapon == DesiredWeapon))
-                {
-                    WorkArray.AddUnique(Weapon);
-                }
-            }
-        }
+        SetDesiredWeapon(Weapon);
+        return true;
     }
-    if (WorkArray.Num() > 0)
+    return false;
+}
+
+bool UUR_InventoryComponent::PrevWeapon()
+{
+    if (AUR_Weapon* Weapon = GetSwitchWeapon(false))
     {
-        int32 SelectedIndex = WorkArray.Find(DesiredWeapon);
-        int32 DesiredIndex = (SelectedIndex + 1) % WorkArray.Num();
-        if (DesiredIndex != SelectedIndex)
-        {
-            SetDesiredWeapon(WorkArray[DesiredIndex]);
-            return true;
-        }
+        SetDesiredWeapon(Weapon);
+        return true;
     }
     return false;
 }
 
-bool UUR_InventoryComponent::PrevWeapon()
+void UUR_InventoryComponent::SelectPreferredWeapon()
+{
+    if (!IsLocallyControlled())
+    {
+        return;
+    }
+
+    //TODO: proper implementation
+    SetDesiredWeapon(WeaponSwitchTable.Preferred.Get());
+}
+
+AUR_Weapon* UUR_InventoryComponent::GetSwitchWeapon(bool bForward) const
+{
+    const FWeaponSwitchTable& Table = WeaponSwitchTable;
+
+    // Only weapons with ammo are candidates, current weapon is the reference
+    int32 Index;
+    if (const int32* Current = DesiredWeapon ? Table.OrderIndices.Find(DesiredWeapon) : nullptr)
+    {
+        Index = bForward ? Table.NextWithAmmo[*Current] : Table.PrevWithAmmo[*Current];
+    }
+    else
+    {
+        Index = bForward ? Table.FirstWithAmmo : Table.LastWithAmmo;
+    }
+    return (Index != INDEX_NONE) ? Table.Weapons[Table.Order[Index]].Get() : nullptr;
+}
+
+UUR_InventoryComponent::FWeaponSwitchTable UUR_InventoryComponent::BuildWeaponSwitchTable() const
 {
-    TArray<AUR_Weapon*> WorkArray;
+    FWeaponSwitchTable Table;
+
+    Table.Weapons.Reserve(WeaponArray.Num());
+    Table.HasAmmo.Reserve(WeaponArray.Num());
+    for (AUR_Weapon* Weapon : WeaponArray)
+    {
+        Table.Weapons.Add(Weapon);
+        Table.HasAmmo.Add(Weapon && Weapon->HasAnyAmmo());
+    }
+
+    // Preferred weapon, by inventory order
+    const int32 FirstWithAmmo = Table.HasAmmo.Find(true);
+    if (FirstWithAmmo != INDEX_NONE)
+    {
+        Table.Preferred = WeaponArray[FirstWithAmmo];
+    }
+    else if (AUR_Weapon* const* FirstWeapon = WeaponArray.FindByPredicate([](AUR_Weapon* W) { return W != nullptr; }))
+    {
+        Table.Preferred = *FirstWeapon;
+    }
+
+    // Weapon bar order
     for (const auto& Group : WeaponGroups)
     {
-        if (Group.Visibility != EWeaponGroupVisibility::Hidden)
+        if (Group.Visibility == EWeaponGroupVisibility::Hidden)
         {
-            for (auto Weapon : Group.Weapons)
+            continue;
+        }
+        for (AUR_Weapon* Weapon : Group.Weapons)
+        {
+            const int32 WeaponIndex = Weapon ? WeaponArray.Find(Weapon) : INDEX_NONE;
+            if (WeaponIndex != INDEX_NONE && !Table.OrderIndices.Contains(Weapon))
             {
-                if (Weapon && (Weapon->HasAnyAmmo() || Weapon == DesiredWeapon))
-                {
-                    WorkArray.AddUnique(Weapon);
-                }
+                Table.OrderIndices.Add(Weapon, Table.Order.Add(WeaponIndex));
             }
         }
     }
-    if (WorkArray.Num() > 0)
+
+    // Closest other entry with ammo in each direction, wrapping around
+    const int32 Num = Table.Order.Num();
+    Table.NextWithAmmo.Init(INDEX_NONE, Num);
+    Table.PrevWithAmmo.Init(INDEX_NONE, Num);
+    for (int32 i = 0; i < Num; i++)
     {
-        int32 SelectedIndex = WorkArray.Find(DesiredWeapon);
-        int32 DesiredIndex = (WorkArray.Num() + (SelectedIndex != INDEX_NONE ? SelectedIndex : 0) - 1) % WorkArray.Num();
-        if (DesiredIndex != SelectedIndex)
+        if (Table.HasAmmo[Table.Order[i]])
         {
-            SetDesiredWeapon(WorkArray[DesiredIndex]);
-            return true;
+            if (Table.FirstWithAmmo == INDEX_NONE)
+            {
+                Table.FirstWithAmmo = i;
+            }
+            Table.LastWithAmmo = i;
         }
     }
-    return false;
+    for (int32 i = 0; i < Num; i++)
+    {
+        for (int32 Step = 1; Step < Num; Step++)
+        {
+            const int32 Next = (i + Step) % Num;
+            if (Table.HasAmmo[Table.Order[Next]])
+            {
+                Table.NextWithAmmo[i] = Next;
+                break;
+            }
+        }
+        for (int32 Step = 1; Step < Num; Step++)
+        {
+            const int32 Prev = (i - Step + Num) % Num;
+            if (Table.HasAmmo[Table.Order[Prev]])
+            {
+                Table.PrevWithAmmo[i] = Prev;
+                break;
+            }
+        }
+    }
+
+    return Table;
 }
 
-void UUR_InventoryComponent::SelectPreferredWeapon()
+void UUR_InventoryComponent::RebuildWeaponSwitchTable()
 {
-    if (!IsLocallyControlled())
-    {
-        return;
-    }
+    SCOPE_CYCLE_COUNTER(STAT_RebuildWeaponSwitchTable);
 
-    //TODO: proper implementation
-    for (AUR_Weapon* Weapon : WeaponArray)
+    WeaponSwitchTable = BuildWeaponSwitchTable();
+}
+
+void UUR_InventoryComponent::RefreshWeaponSwitchAmmo(AUR_Ammo* Ammo)
+{
+    const FWeaponSwitchTable& Table = WeaponSwitchTable;
+    for (int32 i = 0; i < Table.Weapons.Num(); i++)
     {
-        if (Weapon && Weapon->HasAnyAmmo())     //prefer weapon with ammo
+        AUR_Weapon* Weapon = Table.Weapons[i].Get();
+        if (Weapon && (!Ammo || Weapon->AmmoRefs.Contains(Ammo)) && Weapon->HasAnyAmmo() != Table.HasAmmo[i])
         {
-            SetDesiredWeapon(Weapon);
+            RebuildWeaponSwitchTable();
             return;
         }
     }
-    for (AUR_Weapon* Weapon : WeaponArray)
+}
+
+void UUR_InventoryComponent::ValidateWeaponSwitchTable()
+{
+    // Former on-demand evaluation, for reference
+    const auto EvaluateSwitch = [this](bool bForward, AUR_Weapon* From) -> AUR_Weapon*
     {
-        if (Weapon)
+        TArray<AUR_Weapon*> WorkArray;
+        for (const auto& Group : WeaponGroups)
         {
-            SetDesiredWeapon(Weapon);
-            return;
+            if (Group.Visibility != EWeaponGroupVisibility::Hidden)
+            {
+                for (auto Weapon : Group.Weapons)
+                {
+                    if (Weapon && (Weapon->HasAnyAmmo() || Weapon == From))
+                    {
+                        WorkArray.AddUnique(Weapon);
+                    }
+                }
+            }
         }
+        if (WorkArray.Num() > 0)
+        {
+            int32 SelectedIndex = WorkArray.Find(From);
+            int32 DesiredIndex = bForward ? (SelectedIndex + 1) % WorkArray.Num() : (WorkArray.Num() + (SelectedIndex != INDEX_NONE ? SelectedIndex : 0) - 1) % WorkArray.Num();
+            if (DesiredIndex != SelectedIndex)
+            {
+                return WorkArray[DesiredIndex];
+            }
+        }
+        return nullptr;
+    };
+    const auto EvaluatePreferred = [this]() -> AUR_Weapon*
+    {
+        for (AUR_Weapon* Weapon : WeaponArray)
+        {
+            if (Weapon && Weapon->HasAnyAmmo())
+            {
+                return Weapon;
+            }
+        }
+        for (AUR_Weapon* Weapon : WeaponArray)
+        {
+            if (Weapon)
+            {
+                return Weapon;
+            }
+        }
+        return nullptr;
+    };
+
+    // Every weapon as current, plus no current weapon
+    TArray<AUR_Weapon*> Candidates = WeaponArray;
+    Candidates.Add(nullptr);
+
+    int32 NumMismatches = 0;
+    int32 NumEmpty = 0;
+    AUR_Weapon* SavedDesired = DesiredWeapon;
+    for (AUR_Weapon* From : Candidates)
+    {
+        NumEmpty += (From && !From->HasAnyAmmo()) ? 1 : 0;
+        DesiredWeapon = From;
+        for (bool bForward : { true, false })
+        {
+            AUR_Weapon* Expected = EvaluateSwitch(bForward, From);
+            AUR_Weapon* Actual = GetSwitchWeapon(bForward);
+            if (Expected != Actual)
+            {
+                NumMismatches++;
+                UE_LOG(LogTemp, Warning, TEXT("WeaponSwitch: %s from %s: expected %s, got %s"), bForward ? TEXT("next") : TEXT("prev"),
+                    *GetNameSafe(From), *GetNameSafe(Expected), *GetNameSafe(Actual));
+            }
+        }
+    }
+    DesiredWeapon = SavedDesired;
+
+    if (EvaluatePreferred() != WeaponSwitchTable.Preferred.Get())
+    {
+        NumMismatches++;
+        UE_LOG(LogTemp, Warning, TEXT("WeaponSwitch: preferred: expected %s, got %s"), *GetNameSafe(EvaluatePreferred()), *GetNameSafe(WeaponSwitchTable.Preferred.Get()));
     }
-    SetDesiredWeapon(NULL);
+
+    UE_LOG(LogTemp, Log, TEXT("WeaponSwitch: %i weapons (%i without ammo), %i in weapon bar, %i mismatches"),
+        WeaponArray.Num(), NumEmpty, WeaponSwitchTable.Order.Num(), NumMismatches);
 }
 
 void UUR_InventoryComponent::SetDesiredWeapon(AUR_Weapon* InWeapon)
@@ -271,6 +545,8 @@ void UUR_InventoryComponent::SetDesiredWeapon(AUR_Weapon* InWeapon)
     AUR_Weapon* OldDesired = DesiredWeapon;
     DesiredWeapon = InWeapon;
 
+    UpdateWeaponNetRelevancy(OldDesired, DesiredWeapon);
+
     OnDesiredWeaponChanged.Broadcast(this, DesiredWeapon, OldDesired);
 
     if (ActiveWeapon && ActiveWeapon->WeaponState > EWeaponState::Holstered)
@@ -357,13 +633,50 @@ void UUR_InventoryComponent::SetActiveWeapon(AUR_Weapon* InWeapon)
     // We need to replicate to remote clients via DesiredWeapon.
     if (GetNetMode() != NM_Client)
     {
+        AUR_Weapon* OldDesired = DesiredWeapon;
         DesiredWeapon = ActiveWeapon;
+        UpdateWeaponNetRelevancy(OldDesired, DesiredWeapon);
+    }
+    UpdateWeaponNetRelevancy(OldActive, ActiveWeapon);
+}
+
+void UUR_InventoryComponent::UpdateWeaponNetRelevancy(AUR_Weapon* OldWeapon, AUR_Weapon* NewWeapon)
+{
+    if (GetOwnerRole() != ROLE_Authority || OldWeapon == NewWeapon)
+    {
+        return;
+    }
+
+    // Wake the new one first, so it is relevant in the same update as the inventory change
+    if (IsValid(NewWeapon))
+    {
+        NewWeapon->UpdateNetRelevancy();
+    }
+    if (IsValid(OldWeapon))
+    {
+        OldWeapon->UpdateNetRelevancy();
     }
 }
 
 void UUR_InventoryComponent::OnRep_WeaponArray()
 {
-    RefillWeaponGroups();
+    // AmmoRefs are not replicated in compact mode.
+    // Always resolve, weapons may come back from a previous owner with stale refs.
+    if (bCompactAmmoStorage && GetOwnerRole() != ROLE_Authority)
+    {
+        for (AUR_Weapon* Weapon : WeaponArray)
+        {
+            if (Weapon)
+            {
+                ResolveAmmoRefs(Weapon);
+            }
+        }
+    }
+
+    if (UpdateWeaponGroups())
+    {
+        OnWeaponGroupsUpdated.Broadcast(this);
+    }
 
     // Check if active weapon might have been removed from inventory
     if (!WeaponArray.Contains(ActiveWeapon))
@@ -385,24 +698,161 @@ void UUR_InventoryComponent::OnRep_WeaponArray()
 
 void UUR_InventoryComponent::RefillWeaponGroups()
 {
+    WeaponGroupMappings.Reset();
+
     if (auto Settings = UUR_UserSettings::Get(this))
     {
         WeaponGroups = Settings->WeaponGroups;
+        bWeaponGroupsInitialized = true;
     }
     else
     {
         WeaponGroups.Empty();
+        bWeaponGroupsInitialized = false;
+        RebuildWeaponSwitchTable();
         return;
     }
 
+    for (auto& Group : WeaponGroups)
+    {
+        Group.Weapons.Reset();
+    }
+    for (auto Weapon : WeaponArray)
+    {
+        InsertIntoWeaponGroups(Weapon);
+    }
+
+    RebuildWeaponSwitchTable();
+
+    OnWeaponGroupsUpdated.Broadcast(this);
+}
+
+bool UUR_InventoryComponent::UpdateWeaponGroups()
+{
+    SCOPE_CYCLE_COUNTER(STAT_UpdateWeaponGroups);
+
+    if (!bWeaponGroupsInitialized)
+    {
+        RefillWeaponGroups();
+        return false;   // Already broadcasted
+    }
+
+    bool bChanged = false;
+
+    // Remove weapons that left the inventory (or got destroyed)
+    for (auto& Group : WeaponGroups)
+    {
+        bChanged |= Group.Weapons.RemoveAll([this](AUR_Weapon* W) {
+            return !W || !WeaponArray.Contains(W);
+        }) > 0;
+    }
+
+    // Insert new ones. Already grouped weapons are skipped.
+    for (auto Weapon : WeaponArray)
+    {
+        bChanged |= InsertIntoWeaponGroups(Weapon);
+    }
+
+    // Inventory changed even if groups did not, preferred weapon may differ
+    RebuildWeaponSwitchTable();
+
+    return bChanged;
+}
+
+const UUR_InventoryComponent::FWeaponGroupMapping& UUR_InventoryComponent::GetWeaponGroupMapping(UClass* WeaponClass)
+{
+    if (const FWeaponGroupMapping* Cached = WeaponGroupMappings.Find(WeaponClass))
+    {
+        return *Cached;
+    }
+
+    FWeaponGroupMapping& Mapping = WeaponGroupMappings.Add(WeaponClass);
+
+    // Walk up fallbacks until a level matches in any group.
+    // One weapon class in a group can serve as a match for multiple weapon instances, due to fallbacks.
+    bool bFound = false;
+    for (UClass* TestClass = WeaponClass; !bFound && TestClass; TestClass = AUR_Weapon::GetNextFallbackConfigWeapon(TestClass))
+    {
+        for (int32 GroupIndex = 0; GroupIndex < WeaponGroups.Num(); GroupIndex++)
+        {
+            int32 ClassIndex = WeaponGroups[GroupIndex].WeaponClasses.Find(TestClass);
+            if (ClassIndex != INDEX_NONE)
+            {
+                Mapping.Slots.Emplace(GroupIndex, ClassIndex);
+                Mapping.bDirectMatch = (TestClass == WeaponClass);
+                bFound = true;
+            }
+        }
+    }
+
+    return Mapping;
+}
+
+bool UUR_InventoryComponent::InsertIntoWeaponGroups(AUR_Weapon* Weapon)
+{
+    if (!Weapon)    // object not replicated yet
+    {
+        return false;
+    }
+
+    // Copy, finding mappings of other weapons below may grow the map
+    const FWeaponGroupMapping Mapping = GetWeaponGroupMapping(Weapon->GetClass());
+    const int32 WeaponIndex = WeaponArray.Find(Weapon);
+
+    // Order within a group is by matched class index.
+    // For a same class, immediate match comes first, then fallbacks in pickup order.
+    const auto IsBefore = [&](int32 ClassIndex, bool bDirect, int32 ArrayIndex, int32 OtherClassIndex, bool bOtherDirect, int32 OtherArrayIndex)
+    {
+        if (ClassIndex != OtherClassIndex)
+        {
+            return ClassIndex < OtherClassIndex;
+        }
+        if (bDirect != bOtherDirect)
+        {
+            return bDirect;
+        }
+        return ArrayIndex < OtherArrayIndex;
+    };
+
+    bool bInserted = false;
+    for (const FIntPoint& Slot : Mapping.Slots)
+    {
+        TArray<AUR_Weapon*>& GroupWeapons = WeaponGroups[Slot.X].Weapons;
+        if (GroupWeapons.Contains(Weapon))
+        {
+            continue;
+        }
+
+        int32 InsertIndex = 0;
+        for (; InsertIndex < GroupWeapons.Num(); InsertIndex++)
+        {
+            AUR_Weapon* Other = GroupWeapons[InsertIndex];
+            const FWeaponGroupMapping& OtherMapping = GetWeaponGroupMapping(Other->GetClass());
+            const FIntPoint* OtherSlot = OtherMapping.Slots.FindByPredicate([&Slot](const FIntPoint& S) { return S.X == Slot.X; });
+            const int32 OtherClassIndex = OtherSlot ? OtherSlot->Y : MAX_int32;
+            if (IsBefore(Slot.Y, Mapping.bDirectMatch, WeaponIndex, OtherClassIndex, OtherMapping.bDirectMatch, WeaponArray.Find(Other)))
+            {
+                break;
+            }
+        }
+        GroupWeapons.Insert(Weapon, InsertIndex);
+        bInserted = true;
+    }
+    return bInserted;
+}
+
+void UUR_InventoryComponent::BuildWeaponGroups(const TArray<FWeaponGroup>& SettingsGroups, const TArray<AUR_Weapon*>& Weapons, TArray<FWeaponGroup>& OutGroups)
+{
+    OutGroups = SettingsGroups;
+
     // Need an array of array for each group.
     // Because one weapon class in a group can serve as a match for multiple weapon instances, due to fallbacks.
     // We want to keep the order of grouped weapons, by the order of matched weapon classes.
     // 1st index weapon group, 2nd index weapon class
     TArray<TArray<TArray<AUR_Weapon*>>> Temp;
-    Temp.SetNumZeroed(WeaponGroups.Num());
+    Temp.SetNumZeroed(OutGroups.Num());
 
-    for (auto Weapon : WeaponArray)
+    for (auto Weapon : Weapons)
     {
         if (!Weapon)    // object not replicated yet
             continue;
@@ -410,9 +860,9 @@ void UUR_InventoryComponent::RefillWeaponGroups()
         bool bFound = false;
         for (UClass* TestClass = Weapon->GetClass(); !bFound && TestClass; TestClass = AUR_Weapon::GetNextFallbackConfigWeapon(TestClass))
         {
-            for (int32 GroupIndex = 0; GroupIndex < WeaponGroups.Num(); GroupIndex++)
+            for (int32 GroupIndex = 0; GroupIndex < OutGroups.Num(); GroupIndex++)
             {
-                int32 ClassIndex = WeaponGroups[GroupIndex].WeaponClasses.Find(TestClass);
+                int32 ClassIndex = OutGroups[GroupIndex].WeaponClasses.Find(TestClass);
                 if (ClassIndex != INDEX_NONE)
                 {
                     if (Temp[GroupIndex].Num() <= ClassIndex)
@@ -436,16 +886,77 @@ void UUR_InventoryComponent::RefillWeaponGroups()
     }
 
     // Concatenate arrays
-    for (int32 GroupIndex = 0; GroupIndex < WeaponGroups.Num(); GroupIndex++)
+    for (int32 GroupIndex = 0; GroupIndex < OutGroups.Num(); GroupIndex++)
     {
-        WeaponGroups[GroupIndex].Weapons.Empty();
-        for (auto& Weapons : Temp[GroupIndex])
+        OutGroups[GroupIndex].Weapons.Empty();
+        for (auto& GroupWeapons : Temp[GroupIndex])
         {
-            WeaponGroups[GroupIndex].Weapons.Append(Weapons);
+            OutGroups[GroupIndex].Weapons.Append(GroupWeapons);
         }
     }
+}
 
-    OnWeaponGroupsUpdated.Broadcast(this);
+void UUR_InventoryComponent::ValidateWeaponGroups(int32 Iterations)
+{
+    auto Settings = UUR_UserSettings::Get(this);
+    if (!Settings || WeaponArray.Num() == 0 || Iterations <= 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("WeaponGroups: nothing to validate (%i weapons)"), WeaponArray.Num());
+        return;
+    }
+
+    if (!bWeaponGroupsInitialized)
+    {
+        RefillWeaponGroups();
+    }
+
+    TArray<FWeaponGroup> Reference;
+    int32 NumMismatches = 0;
+    const auto Compare = [&]()
+    {
+        BuildWeaponGroups(Settings->WeaponGroups, WeaponArray, Reference);
+        bool bMatch = (Reference.Num() == WeaponGroups.Num());
+        for (int32 i = 0; bMatch && i < Reference.Num(); i++)
+        {
+            bMatch = (Reference[i].Weapons == WeaponGroups[i].Weapons);
+        }
+        NumMismatches += bMatch ? 0 : 1;
+    };
+
+    Compare();
+
+    // Churn: take out one weapon and put it back, like a drop and pickup
+    const TArray<AUR_Weapon*> OriginalWeapons = WeaponArray;
+    double IncrementalTime = 0.0;
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        const int32 Index = FMath::RandRange(0, WeaponArray.Num() - 1);
+        AUR_Weapon* Weapon = WeaponArray[Index];
+
+        const double Start = FPlatformTime::Seconds();
+        WeaponArray.RemoveAt(Index);
+        UpdateWeaponGroups();
+        WeaponArray.Add(Weapon);
+        UpdateWeaponGroups();
+        IncrementalTime += FPlatformTime::Seconds() - Start;
+
+        Compare();
+    }
+
+    const double FullStart = FPlatformTime::Seconds();
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        BuildWeaponGroups(Settings->WeaponGroups, WeaponArray, Reference);
+        BuildWeaponGroups(Settings->WeaponGroups, WeaponArray, Reference);
+    }
+    const double FullTime = FPlatformTime::Seconds() - FullStart;
+
+    // Restore pickup order
+    WeaponArray = OriginalWeapons;
+    RefillWeaponGroups();
+
+    UE_LOG(LogTemp, Log, TEXT("WeaponGroups: %i weapons, %i groups, %i iterations: incremental %.3f ms, full rebuild %.3f ms, %i mismatches"),
+        WeaponArray.Num(), WeaponGroups.Num(), Iterations, IncrementalTime * 1000.0, FullTime * 1000.0, NumMismatches);
 }
 
 void UUR_InventoryComponent::ServerDropActiveWeapon_Implementation()
@@ -501,8 +1012,13 @@ AUR_Pickup_DroppedWeapon* UUR_InventoryComponent::DropWeapon(AUR_Weapon* WeaponT
 
     FTransform SpawnTransform(SpawnRot, SpawnLoc);
 
-    // Spawn dropped pickup
-    auto DroppedWeapon = Cast<AUR_Pickup_DroppedWeapon>(UGameplayStatics::BeginDeferredActorSpawnFromClass(this, AUR_Pickup_DroppedWeapon::StaticClass(), SpawnTransform, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn, GetOwner()));
+    // Spawn dropped pickup, or recycle one
+    auto DroppedPickupSubsystem = GetWorld()->GetSubsystem<UUR_DroppedPickupSubsystem>();
+    if (!DroppedPickupSubsystem)
+    {
+        return NULL;
+    }
+    auto DroppedWeapon = DroppedPickupSubsystem->AcquireDroppedPickup<AUR_Pickup_DroppedWeapon>(SpawnTransform, GetOwner());
     if (!DroppedWeapon)
     {
         return NULL;
@@ -535,7 +1051,7 @@ AUR_Pickup_DroppedWeapon* UUR_InventoryComponent::DropWeapon(AUR_Weapon* WeaponT
 
     // Finish setting up dropped pickup
     DroppedWeapon->SetWeapon(WeaponToDrop);
-    UGameplayStatics::FinishSpawningActor(DroppedWeapon, SpawnTransform);
+    DroppedPickupSubsystem->FinishDroppedPickup(DroppedWeapon, SpawnTransform);
 
     // Standalone trigger
     if (IsLocallyControlled())
@@ -569,6 +1085,18 @@ void UUR_InventoryComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
     {
         Clear();
     }
+    else if (bCompactAmmoStorage)
+    {
+        // Local ammo instances
+        for (AUR_Ammo* IterAmmo : AmmoArray)
+        {
+            if (IterAmmo)
+            {
+                IterAmmo->Destroy();
+            }
+        }
+        AmmoArray.Empty();
+    }
 
     Super::OnComponentDestroyed(bDestroyingHierarchy);
 }
@@ -590,4 +1118,5 @@ void UUR_InventoryComponent::Clear_Implementation()
         }
     }
     AmmoArray.Empty();
+    AmmoState.Reset();
 }
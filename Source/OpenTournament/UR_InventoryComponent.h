@@ -10,6 +10,7 @@
 //TODO: move enum EWeaponState to a shared header
 #include "UR_Weapon.h"
 #include "UR_Type_WeaponGroup.h"
+#include "UR_AmmoState.h"
 
 #include "UR_InventoryComponent.generated.h"
 
@@ -30,7 +31,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FWeaponGroupsUpdatedSignature, UUR_I
 /**
  * InventoryComponent is the base component for use by actors to have an inventory.
  */
-UCLASS(DefaultToInstanced, BlueprintType, meta = (Tooltip = "A InventoryComponent is a reusable component that can be added to any actor to give it an Inventory.", ShortTooltip = "A InventoryComponent is a reusable component that can be added to any actor to give it an Inventory."), hideCategories = (UR, Character, Collision, Cooking))
+UCLASS(Config = Game, DefaultToInstanced, BlueprintType, meta = (Tooltip = "A InventoryComponent is a reusable component that can be added to any actor to give it an Inventory.", ShortTooltip = "A InventoryComponent is a reusable component that can be added to any actor to give it an Inventory."), hideCategories = (UR, Character, Collision, Cooking))
 class OPENTOURNAMENT_API UUR_InventoryComponent : public UActorComponent
 {
     GENERATED_BODY()
@@ -38,6 +39,7 @@ class OPENTOURNAMENT_API UUR_InventoryComponent : public UActorComponent
 protected:
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
     virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
+    virtual void InitializeComponent() override;
 
 public:
 
@@ -51,9 +53,27 @@ public:
     UPROPERTY(BlueprintReadOnly)
     TArray<FWeaponGroup> WeaponGroups;
 
+    /**
+    * Rebuild weapon groups from user settings.
+    * Call when weapon group settings change.
+    * Otherwise groups are maintained incrementally by UpdateWeaponGroups.
+    */
     UFUNCTION(BlueprintCallable, BlueprintCosmetic)
     virtual void RefillWeaponGroups();
 
+    /**
+    * Remove weapons that left WeaponArray from groups, and insert new ones.
+    * Resulting order is the same as a full rebuild.
+    * @return whether groups changed.
+    */
+    bool UpdateWeaponGroups();
+
+    /**
+    * Compare incremental updates against full rebuilds, and time both.
+    * Backs the OT.Inventory.ValidateWeaponGroups console command.
+    */
+    void ValidateWeaponGroups(int32 Iterations);
+
     /**
     * Ammo types are instanced and stored in this array, independently from weapons.
     * Ammo array is initially empty.
@@ -63,6 +83,23 @@ public:
     UPROPERTY(Replicated, BlueprintReadOnly, Category = "InventoryComponent")
     TArray<AUR_Ammo*> AmmoArray;
 
+    /**
+    * Compact ammo storage.
+    * Ammo actors are not replicated, they exist locally on server and owning client.
+    * Ammo counts of all types are replicated (OwnerOnly) in the packed AmmoState, only changed slots are sent.
+    * Weapons resolve their AmmoRefs locally.
+    *
+    * Must be the same on server and clients, as it changes the replicated properties layout.
+    */
+    UPROPERTY(Config)
+    bool bCompactAmmoStorage = true;
+
+    /**
+    * Packed ammo counts, used in compact ammo storage mode.
+    */
+    UPROPERTY(Replicated)
+    FUR_AmmoState AmmoState;
+
     UPROPERTY(BlueprintReadOnly, Category = "InventoryComponent")
     AUR_Weapon* ActiveWeapon;
 
@@ -85,6 +122,15 @@ public:
     UFUNCTION(BlueprintCallable)
     virtual AUR_Ammo* GetAmmoByClass(TSubclassOf<AUR_Ammo> InAmmoClass, bool bAutoCreate = false);
 
+    /** Called by ammo when its count changes, to update the compact AmmoState */
+    virtual void NotifyAmmoCountChanged(AUR_Ammo* Ammo);
+
+    /** Called by AmmoState when a slot is received */
+    virtual void OnRep_AmmoSlot(TSubclassOf<AUR_Ammo> InAmmoClass, int32 AmmoCount);
+
+    /** Point weapon AmmoRefs to our ammo instances */
+    void ResolveAmmoRefs(AUR_Weapon* InWeapon);
+
     /////////////////////////////////////////////////////////////////////////////////////////////////
 
     UFUNCTION()
@@ -105,6 +151,24 @@ public:
     UFUNCTION()
     void SetDesiredWeapon(AUR_Weapon* InWeapon);
 
+    /**
+    * Rebuild the weapon switch table.
+    * Called when weapon groups change.
+    */
+    void RebuildWeaponSwitchTable();
+
+    /**
+    * Called when an ammo count changed, or when a weapon's ammo refs replicated (Ammo NULL).
+    * Rebuilds the weapon switch table if a weapon ran out of ammo, or got ammo back.
+    */
+    void RefreshWeaponSwitchAmmo(AUR_Ammo* Ammo);
+
+    /**
+    * Compare weapon switch table lookups against evaluating groups on demand.
+    * Backs the OT.Inventory.ValidateWeaponSwitch console command.
+    */
+    void ValidateWeaponSwitchTable();
+
     UFUNCTION(Server, Reliable)
     void ServerSetDesiredWeapon(AUR_Weapon* InWeapon);
 
@@ -118,6 +182,9 @@ public:
     UFUNCTION()
     void SetActiveWeapon(AUR_Weapon* InWeapon);
 
+    /** Authority only. Refresh dormancy and relevancy of weapons whose equipped status changed. */
+    void UpdateWeaponNetRelevancy(AUR_Weapon* OldWeapon, AUR_Weapon* NewWeapon);
+
     /////////////////////////////////////////////////////////////////////////////////////////////////
 
     UFUNCTION(Server, Reliable)
@@ -136,6 +203,64 @@ public:
 
 protected:
 
+    /** Groups and class indices a weapon class falls into, after fallbacks */
+    struct FWeaponGroupMapping
+    {
+        /** Pairs of group index, class index in group */
+        TArray<FIntPoint, TInlineAllocator<4>> Slots;
+        bool bDirectMatch = false;
+    };
+
+    /** Cached per weapon class. Invalidated by RefillWeaponGroups. */
+    TMap<TObjectKey<UClass>, FWeaponGroupMapping> WeaponGroupMappings;
+
+    bool bWeaponGroupsInitialized = false;
+
+    const FWeaponGroupMapping& GetWeaponGroupMapping(UClass* WeaponClass);
+
+    /** Insert weapon in all its groups, at the position a full rebuild would give it */
+    bool InsertIntoWeaponGroups(AUR_Weapon* Weapon);
+
+    /**
+    * Weapon switching order, precomputed so next/prev/preferred weapon are direct lookups.
+    * Built from scratch when weapon groups or ammo availability change, never modified in place.
+    */
+    struct FWeaponSwitchTable
+    {
+        /** Snapshot of WeaponArray */
+        TArray<TWeakObjectPtr<AUR_Weapon>> Weapons;
+
+        /** For each of Weapons, whether it has ammo */
+        TBitArray<> HasAmmo;
+
+        /** Unique weapons of visible groups in weapon bar order, as indices into Weapons */
+        TArray<int32> Order;
+
+        /** Position in Order of each weapon */
+        TMap<TObjectKey<AUR_Weapon>, int32> OrderIndices;
+
+        /** For each entry of Order, position of the closest other entry with ammo, forward and backward. INDEX_NONE if none. */
+        TArray<int32> NextWithAmmo;
+        TArray<int32> PrevWithAmmo;
+
+        /** Position in Order of first and last entries with ammo */
+        int32 FirstWithAmmo = INDEX_NONE;
+        int32 LastWithAmmo = INDEX_NONE;
+
+        /** First weapon with ammo in inventory, or first weapon if none has ammo */
+        TWeakObjectPtr<AUR_Weapon> Preferred;
+    };
+
+    FWeaponSwitchTable WeaponSwitchTable;
+
+    FWeaponSwitchTable BuildWeaponSwitchTable() const;
+
+    /** Weapon that next/prev should switch to from DesiredWeapon, NULL if none */
+    AUR_Weapon* GetSwitchWeapon(bool bForward) const;
+
+    /** Reference implementation, rebuilding all groups from scratch */
+    static void BuildWeaponGroups(const TArray<FWeaponGroup>& SettingsGroups, const TArray<AUR_Weapon*>& Weapons, TArray<FWeaponGroup>& OutGroups);
+
     UFUNCTION()
     virtual void OnRep_WeaponArray();
 
@@ -0,0 +1,43 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_KillFeed.h"
+
+#include "UR_GameState.h"
+#include "UR_PlayerState.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_KillFeed)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FUR_KillFeed::AddEntry(AUR_PlayerState* Victim, AUR_PlayerState* Killer, TSubclassOf<UDamageType> DamType, const FGameplayTagContainer& EventTags)
+{
+    if (Entries.Num() >= MaxEntries)
+    {
+        Entries.RemoveAt(0, Entries.Num() - MaxEntries + 1, false);
+        MarkArrayDirty();
+    }
+
+    FUR_KillFeedEntry& Entry = Entries.AddDefaulted_GetRef();
+    Entry.Victim = Victim;
+    Entry.Killer = Killer;
+    Entry.DamType = DamType;
+    Entry.EventTags = EventTags;
+    MarkItemDirty(Entry);
+}
+
+void FUR_KillFeed::PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize)
+{
+    // Entries received with the initial game state happened before we joined
+    if (!Owner || !Owner->HasActorBegunPlay())
+    {
+        return;
+    }
+
+    for (int32 Index : AddedIndices)
+    {
+        const FUR_KillFeedEntry& Entry = Entries[Index];
+        Owner->FragEvent.Broadcast(Entry.Victim, Entry.Killer, Entry.DamType, Entry.EventTags);
+    }
+}
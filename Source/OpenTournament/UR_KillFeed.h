@@ -0,0 +1,94 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Net/Serialization/FastArraySerializer.h"
+
+#include "UR_KillFeed.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+class AUR_GameState;
+class AUR_PlayerState;
+class UDamageType;
+struct FUR_KillFeed;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * One frag of the kill feed.
+ */
+USTRUCT()
+struct FUR_KillFeedEntry : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    FUR_KillFeedEntry()
+        : Victim(nullptr)
+        , Killer(nullptr)
+        , DamType(nullptr)
+    {}
+
+    UPROPERTY()
+    TObjectPtr<AUR_PlayerState> Victim;
+
+    UPROPERTY()
+    TObjectPtr<AUR_PlayerState> Killer;
+
+    UPROPERTY()
+    TSubclassOf<UDamageType> DamType;
+
+    UPROPERTY()
+    FGameplayTagContainer EventTags;
+};
+
+/**
+ * Recent frags, replicated as a bounded ring through the game state.
+ * Replaces a reliable multicast per frag: entries only go to connections the game state replicates to,
+ * and a late joiner receives the current entries without replaying them as new events.
+ */
+USTRUCT()
+struct FUR_KillFeed : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    void SetOwner(AUR_GameState* InOwner) { Owner = InOwner; }
+
+    /** Authority only. Add a frag, dropping the oldest entry beyond MaxEntries. */
+    void AddEntry(AUR_PlayerState* Victim, AUR_PlayerState* Killer, TSubclassOf<UDamageType> DamType, const FGameplayTagContainer& EventTags);
+
+    int32 Num() const { return Entries.Num(); }
+
+    /** Entries kept on the server, also bounds what a joining client receives */
+    static constexpr int32 MaxEntries = 8;
+
+    //~FFastArraySerializer contract
+    void PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize);
+    //~End of FFastArraySerializer contract
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+    {
+        return FFastArraySerializer::FastArrayDeltaSerialize<FUR_KillFeedEntry, FUR_KillFeed>(Entries, DeltaParms, *this);
+    }
+
+private:
+
+    UPROPERTY()
+    TArray<FUR_KillFeedEntry> Entries;
+
+    UPROPERTY(NotReplicated)
+    TObjectPtr<AUR_GameState> Owner = nullptr;
+};
+
+template<>
+struct TStructOpsTypeTraits<FUR_KillFeed> : public TStructOpsTypeTraitsBase2<FUR_KillFeed>
+{
+    enum
+    {
+        WithNetDeltaSerializer = true,
+    };
+};
@@ -0,0 +1,397 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_NetProfiler.h"
+
+#include "Engine/ActorChannel.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMisc.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "UR_Ammo.h"
+#include "UR_Character.h"
+#include "UR_LogChannels.h"
+#include "UR_Pickup.h"
+#include "UR_PickupBase.h"
+#include "UR_PickupFactory.h"
+#include "UR_Projectile.h"
+#include "UR_Weapon.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_NetProfiler)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT Net Profiler"), STATGROUP_OTNetProfiler, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Sample Channels"), STAT_NetProfilerSampleChannels, STATGROUP_OTNetProfiler);
+
+namespace OTConsoleVariables
+{
+    static FAutoConsoleCommandWithWorldAndArgs CmdNetProfileRun(
+        TEXT("OT.NetProfile.Run"),
+        TEXT("Server only. Capture a per class and per RPC net profile, then check it against the configured budgets. Optional arg: duration in seconds (default 60)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (auto NetProfiler = World ? World->GetSubsystem<UUR_NetProfiler>() : nullptr)
+            {
+                NetProfiler->StartCapture(Args.Num() > 0 ? FCString::Atof(*Args[0]) : 60.f);
+            }
+        }));
+
+    static FAutoConsoleCommandWithWorldAndArgs CmdNetProfileStop(
+        TEXT("OT.NetProfile.Stop"),
+        TEXT("Server only. Stop the current net profile capture and report it."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (auto NetProfiler = World ? World->GetSubsystem<UUR_NetProfiler>() : nullptr)
+            {
+                NetProfiler->StopCapture();
+            }
+        }));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UUR_NetProfiler::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // Measures what the server sends
+    return !IsRunningClientOnly() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UUR_NetProfiler::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UUR_NetProfiler::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_NetProfiler, STATGROUP_Tickables);
+}
+
+void UUR_NetProfiler::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    float Duration = 0.f;
+    if (FParse::Value(FCommandLine::Get(), TEXT("NetProfile="), Duration) && Duration > 0.f)
+    {
+        float Warmup = 30.f;
+        FParse::Value(FCommandLine::Get(), TEXT("NetProfileWarmup="), Warmup);
+        FParse::Value(FCommandLine::Get(), TEXT("NetProfileClients="), ExpectedClients);
+        bExitWhenDone = FParse::Param(FCommandLine::Get(), TEXT("NetProfileExit"));
+
+        StartCapture(Duration, Warmup);
+    }
+}
+
+void UUR_NetProfiler::StartCapture(float Duration, float Delay)
+{
+    const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+    if (!NetDriver || !NetDriver->IsServer())
+    {
+        UE_LOG(LogNetOT, Warning, TEXT("NetProfile: not a server"));
+        return;
+    }
+
+    for (FCategoryStats& Category : Categories)
+    {
+        Category = FCategoryStats();
+    }
+    Rpcs.Reset();
+    ReplicateActorsBits = 0;
+    ReplicateActorsSeconds = 0.0;
+    MaxReplicateActorsSeconds = 0.0;
+    ReplicateActorsFrames = 0;
+    ConnectionFrames = 0;
+    OutBytesPerSecondFrames = 0;
+    SampledFrames = 0;
+
+    CaptureStartTime = FPlatformTime::Seconds() + FMath::Max(Delay, 0.f);
+    CaptureEndTime = CaptureStartTime + FMath::Max(Duration, 1.f);
+    bCapturing = false;
+    bPending = true;
+
+    UE_LOG(LogNetOT, Log, TEXT("NetProfile: capturing %.0f s in %.0f s"), FMath::Max(Duration, 1.f), FMath::Max(Delay, 0.f));
+}
+
+bool UUR_NetProfiler::StopCapture()
+{
+    if (!bCapturing)
+    {
+        bPending = false;
+        return true;
+    }
+
+    bCapturing = false;
+    CaptureEndTime = FPlatformTime::Seconds();
+
+    const bool bPassed = Report();
+
+    if (bExitWhenDone)
+    {
+        FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+    }
+    return bPassed;
+}
+
+void UUR_NetProfiler::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    const double Now = FPlatformTime::Seconds();
+
+    if (bPending && Now >= CaptureStartTime)
+    {
+        bPending = false;
+        bCapturing = true;
+        CaptureStartTime = Now;
+
+        const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+        LastSampleNetTime = NetDriver ? NetDriver->GetElapsedTime() : 0.0;
+
+        UE_LOG(LogNetOT, Log, TEXT("NetProfile: capture started with %d clients"), NetDriver ? NetDriver->ClientConnections.Num() : 0);
+    }
+
+    if (!bCapturing)
+    {
+        return;
+    }
+
+    SampleChannels();
+
+    if (Now >= CaptureEndTime)
+    {
+        StopCapture();
+    }
+}
+
+void UUR_NetProfiler::SampleChannels()
+{
+    SCOPE_CYCLE_COUNTER(STAT_NetProfilerSampleChannels);
+
+    const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+    if (!NetDriver)
+    {
+        return;
+    }
+
+    // World tick runs between the driver's dispatch and flush, so channels replicated during
+    // the previous flush carry the elapsed time of the previous sample.
+    const double NetTime = NetDriver->GetElapsedTime();
+
+    for (UNetConnection* Connection : NetDriver->ClientConnections)
+    {
+        if (!Connection)
+        {
+            continue;
+        }
+        for (const auto& Pair : Connection->ActorChannelMap())
+        {
+            const UActorChannel* Channel = Pair.Value;
+            if (Channel && Channel->LastUpdateTime >= LastSampleNetTime)
+            {
+                Categories[static_cast<int32>(GetCategory(Pair.Key.Get()))].Updates++;
+            }
+        }
+        OutBytesPerSecondFrames += Connection->OutBytesPerSecond;
+    }
+
+    ConnectionFrames += NetDriver->ClientConnections.Num();
+    SampledFrames++;
+    LastSampleNetTime = NetTime;
+}
+
+void UUR_NetProfiler::RecordReplicateActors(int64 Bits, double Seconds)
+{
+    ReplicateActorsBits += Bits;
+    ReplicateActorsSeconds += Seconds;
+    MaxReplicateActorsSeconds = FMath::Max(MaxReplicateActorsSeconds, Seconds);
+    ReplicateActorsFrames++;
+}
+
+void UUR_NetProfiler::RecordReplicateActor(const AActor* Actor, int64 Bits, double Seconds, bool bOpenedChannel)
+{
+    FCategoryStats& Stats = Categories[static_cast<int32>(GetCategory(Actor))];
+    Stats.PropertyBits += Bits;
+    Stats.ReplicateSeconds += Seconds;
+    if (bOpenedChannel)
+    {
+        Stats.OpenBits += Bits;
+        Stats.Opens++;
+    }
+}
+
+void UUR_NetProfiler::RecordRemoteFunction(const AActor* Actor, const UFunction* Function, int64 Bits, double Seconds)
+{
+    const EUR_NetProfileCategory Category = GetCategory(Actor);
+
+    FRpcStats& Rpc = Rpcs.FindOrAdd(Function->GetFName());
+    Rpc.Category = Category;
+    Rpc.Bits += Bits;
+    Rpc.Calls++;
+    Rpc.Seconds += Seconds;
+
+    Categories[static_cast<int32>(Category)].RpcBits += Bits;
+    Categories[static_cast<int32>(Category)].RpcCalls++;
+}
+
+int64 UUR_NetProfiler::GetSentBits(const UNetDriver* NetDriver)
+{
+    int64 Bits = 0;
+    for (const UNetConnection* Connection : NetDriver->ClientConnections)
+    {
+        if (Connection)
+        {
+            Bits += 8 * static_cast<int64>(Connection->OutBytes) + Connection->SendBuffer.GetNumBits();
+        }
+    }
+    return Bits;
+}
+
+EUR_NetProfileCategory UUR_NetProfiler::GetCategory(const AActor* Actor)
+{
+    if (Actor)
+    {
+        if (Actor->IsA<AUR_Character>())
+        {
+            return EUR_NetProfileCategory::Character;
+        }
+        if (Actor->IsA<AUR_Weapon>())
+        {
+            return EUR_NetProfileCategory::Weapon;
+        }
+        if (Actor->IsA<AUR_Projectile>())
+        {
+            return EUR_NetProfileCategory::Projectile;
+        }
+        if (Actor->IsA<AUR_PickupBase>() || Actor->IsA<AUR_PickupFactory>() || Actor->IsA<AUR_Pickup>())
+        {
+            return EUR_NetProfileCategory::Pickup;
+        }
+        if (Actor->IsA<AUR_Ammo>())
+        {
+            return EUR_NetProfileCategory::Ammo;
+        }
+    }
+    return EUR_NetProfileCategory::Other;
+}
+
+bool UUR_NetProfiler::Report()
+{
+    const double Duration = FMath::Max(CaptureEndTime - CaptureStartTime, 0.001);
+    const double AvgClients = SampledFrames > 0 ? static_cast<double>(ConnectionFrames) / SampledFrames : 0.0;
+    // Everything below is per client connection and per second
+    const double Scale = 1.0 / (Duration * FMath::Max(AvgClients, 1.0));
+
+    bool bPassed = true;
+    TArray<FString> Failures;
+    const auto Check = [&](const FString& What, double Value, float Budget)
+    {
+        if (Budget > 0.f && Value > Budget)
+        {
+            bPassed = false;
+            Failures.Add(FString::Printf(TEXT("%s: %.1f > %.1f"), *What, Value, Budget));
+        }
+    };
+
+    FString Csv = TEXT("Type,Name,Category,UpdatesPerSec,PropertyBytesPerSec,ReplicateActorsMs,RpcCallsPerSec,RpcBytesPerSec,RpcAvgBytes,RpcAvgMicroseconds\n");
+
+    UE_LOG(LogNetOT, Log, TEXT("NetProfile: %.1f s, %.1f clients on average, %d frames"), Duration, AvgClients, SampledFrames);
+
+    const double OutBytesPerSecond = ConnectionFrames > 0 ? static_cast<double>(OutBytesPerSecondFrames) / ConnectionFrames : 0.0;
+    const double PropertyBytesPerSecond = ReplicateActorsBits / 8.0 * Scale;
+    const double AvgReplicateActorsMs = ReplicateActorsFrames > 0 ? ReplicateActorsSeconds * 1000.0 / ReplicateActorsFrames : 0.0;
+    UE_LOG(LogNetOT, Log, TEXT("  Out %.0f B/s, property replication %.0f B/s, replicate actors avg %.3f ms max %.3f ms"),
+        OutBytesPerSecond, PropertyBytesPerSecond, AvgReplicateActorsMs, MaxReplicateActorsSeconds * 1000.0);
+    if (ReplicateActorsFrames == 0)
+    {
+        // RPCs and property bytes are only measured through the replication graph, a capture without them is meaningless
+        bPassed = false;
+        Failures.Add(TEXT("No replication graph data, RPCs and property bytes were not measured (is the replication graph enabled?)"));
+    }
+    Check(TEXT("Out B/s"), OutBytesPerSecond, MaxOutBytesPerSecond);
+    Check(TEXT("Replicate actors ms"), AvgReplicateActorsMs, MaxReplicateActorsMs);
+
+    const UEnum* CategoryEnum = StaticEnum<EUR_NetProfileCategory>();
+    for (int32 i = 0; i < static_cast<int32>(EUR_NetProfileCategory::MAX); i++)
+    {
+        const FCategoryStats& Stats = Categories[i];
+        const FString Name = CategoryEnum->GetNameStringByIndex(i);
+        const double UpdatesPerSecond = Stats.Updates * Scale;
+        const double PropertyBytesPerSecond = Stats.PropertyBits / 8.0 * Scale;
+        // CPU is for all connections, like the replicate actors total
+        const double ReplicateMs = ReplicateActorsFrames > 0 ? Stats.ReplicateSeconds * 1000.0 / ReplicateActorsFrames : 0.0;
+        const double RpcBytesPerSecond = Stats.RpcBits / 8.0 * Scale;
+
+        UE_LOG(LogNetOT, Log, TEXT("  %-12s %8.1f updates/s  %8.0f prop B/s  %6.3f ms  %8.1f RPC/s  %8.0f RPC B/s"),
+            *Name, UpdatesPerSecond, PropertyBytesPerSecond, ReplicateMs, Stats.RpcCalls * Scale, RpcBytesPerSecond);
+        Csv += FString::Printf(TEXT("Category,%s,%s,%.2f,%.1f,%.4f,%.2f,%.1f,,\n"), *Name, *Name, UpdatesPerSecond, PropertyBytesPerSecond, ReplicateMs, Stats.RpcCalls * Scale, RpcBytesPerSecond);
+
+        if (const FUR_NetProfileBudget* Budget = CategoryBudgets.FindByPredicate([&Name](const FUR_NetProfileBudget& B) { return B.Name == *Name; }))
+        {
+            Check(Name + TEXT(" updates/s"), UpdatesPerSecond, Budget->MaxUpdatesPerSecond);
+            Check(Name + TEXT(" property B/s"), PropertyBytesPerSecond, Budget->MaxPropertyBytesPerSecond);
+            Check(Name + TEXT(" replicate actors ms"), ReplicateMs, Budget->MaxReplicateActorsMs);
+            Check(Name + TEXT(" RPC B/s"), RpcBytesPerSecond, Budget->MaxRpcBytesPerSecond);
+        }
+    }
+
+    // Initial bunches of a character and its inventory, per character channel open.
+    // With compact ammo storage, ammo counts are part of the character's inventory component instead of ammo actors.
+    {
+        const FCategoryStats& CharacterStats = Categories[static_cast<int32>(EUR_NetProfileCategory::Character)];
+        const FCategoryStats& WeaponStats = Categories[static_cast<int32>(EUR_NetProfileCategory::Weapon)];
+        const FCategoryStats& AmmoStats = Categories[static_cast<int32>(EUR_NetProfileCategory::Ammo)];
+        const int32 Opens = FMath::Max(CharacterStats.Opens, 1);
+        const double CharacterBytes = CharacterStats.OpenBits / 8.0 / Opens;
+        const double WeaponBytes = WeaponStats.OpenBits / 8.0 / Opens;
+        const double AmmoBytes = AmmoStats.OpenBits / 8.0 / Opens;
+        UE_LOG(LogNetOT, Log, TEXT("  Spawn payload over %d character channel opens: %.0f B (character %.0f, weapons %.0f, ammo actors %.0f)"),
+            CharacterStats.Opens, CharacterBytes + WeaponBytes + AmmoBytes, CharacterBytes, WeaponBytes, AmmoBytes);
+    }
+
+    Rpcs.ValueSort([](const FRpcStats& A, const FRpcStats& B) { return A.Bits > B.Bits; });
+    for (const auto& Pair : Rpcs)
+    {
+        const FString Name = Pair.Key.ToString();
+        const FRpcStats& Stats = Pair.Value;
+        const double BytesPerSecond = Stats.Bits / 8.0 * Scale;
+        const double AvgBytes = Stats.Bits / 8.0 / FMath::Max(Stats.Calls, 1);
+        const double AvgMicroseconds = Stats.Seconds * 1000000.0 / FMath::Max(Stats.Calls, 1);
+        const FString Category = CategoryEnum->GetNameStringByValue(static_cast<int64>(Stats.Category));
+
+        UE_LOG(LogNetOT, Log, TEXT("  %-12s %-32s %8.1f calls/s  %8.0f B/s  %6.1f B/call  %6.1f us/call"),
+            *Category, *Name, Stats.Calls * Scale, BytesPerSecond, AvgBytes, AvgMicroseconds);
+        Csv += FString::Printf(TEXT("Rpc,%s,%s,,,,%.2f,%.1f,%.1f,%.1f\n"), *Name, *Category, Stats.Calls * Scale, BytesPerSecond, AvgBytes, AvgMicroseconds);
+
+        if (const FUR_NetProfileBudget* Budget = RpcBudgets.FindByPredicate([&Pair](const FUR_NetProfileBudget& B) { return B.Name == Pair.Key; }))
+        {
+            Check(Name + TEXT(" B/s"), BytesPerSecond, Budget->MaxRpcBytesPerSecond);
+            Check(Name + TEXT(" us/call"), AvgMicroseconds, Budget->MaxRpcMicroseconds);
+        }
+    }
+
+    if (AvgClients < FMath::Max(ExpectedClients, 1) - 0.5)
+    {
+        bPassed = false;
+        Failures.Add(FString::Printf(TEXT("Clients: %.1f < %d"), AvgClients, FMath::Max(ExpectedClients, 1)));
+    }
+
+    const FString CsvPath = FPaths::ProfilingDir() / FString::Printf(TEXT("NetProfile-%s.csv"), *FDateTime::Now().ToString());
+    if (FFileHelper::SaveStringToFile(Csv, *CsvPath))
+    {
+        UE_LOG(LogNetOT, Log, TEXT("NetProfile: saved %s"), *CsvPath);
+    }
+
+    for (const FString& Failure : Failures)
+    {
+        UE_LOG(LogNetOT, Error, TEXT("NetProfile: over budget, %s"), *Failure);
+    }
+    UE_LOG(LogNetOT, Log, TEXT("NetProfile: %s"), bPassed ? TEXT("PASS") : TEXT("FAIL"));
+
+    return bPassed;
+}
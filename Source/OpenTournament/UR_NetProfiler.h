@@ -0,0 +1,194 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UR_NetProfiler.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+class UFunction;
+class UNetDriver;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Classes the net profile is broken down by.
+ */
+UENUM()
+enum class EUR_NetProfileCategory : uint8
+{
+    Character,
+    Weapon,
+    Projectile,
+    Pickup,
+    Ammo,
+    Other,
+    MAX UMETA(Hidden),
+};
+
+/**
+ * Budget for a category or an RPC, per client connection. Zero leaves a value unchecked.
+ */
+USTRUCT()
+struct FUR_NetProfileBudget
+{
+    GENERATED_BODY()
+
+    /** Category name (Character, Weapon...) or RPC function name */
+    UPROPERTY(Config)
+    FName Name;
+
+    /** Actor channel updates per second */
+    UPROPERTY(Config)
+    float MaxUpdatesPerSecond = 0.f;
+
+    /** RPC bytes per second */
+    UPROPERTY(Config)
+    float MaxRpcBytesPerSecond = 0.f;
+
+    /** Category only. Property replication bytes per second. */
+    UPROPERTY(Config)
+    float MaxPropertyBytesPerSecond = 0.f;
+
+    /** Category only. Average server CPU replicating actors of the category per frame, all connections, in milliseconds. */
+    UPROPERTY(Config)
+    float MaxReplicateActorsMs = 0.f;
+
+    /** Average server CPU per RPC call, in microseconds */
+    UPROPERTY(Config)
+    float MaxRpcMicroseconds = 0.f;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Server side net profile of a running match. Server only.
+ *
+ * Over a capture window, measures per client connection:
+ * - Actor channel updates of each category, sampled from the channels every frame.
+ * - Property replication bytes and server CPU of each category, measured around the replication graph's ReplicateSingleActor.
+ * - Bytes, calls and server CPU of each RPC, measured around the replication graph's RPC path.
+ * - Total outgoing bandwidth, property replication bytes and replication CPU.
+ * - Bytes sent per character channel open (respawns mostly) for the character and its inventory (weapons, ammo),
+ *   compare runs with UUR_InventoryComponent::bCompactAmmoStorage on and off to measure the ammo storage modes.
+ *
+ * The report is logged and saved as CSV under Saved/Profiling, then checked against the configured budgets.
+ * RPCs and property bytes are recorded by the replication graph, the capture fails if it is not enabled.
+ *
+ * Meant to be driven by a bot match on a dedicated server with headless clients (see otscripts/OTNetProfile.bat):
+ *   -NetProfile=<seconds>       Start a capture once the world begins play, after -NetProfileWarmup=<seconds> (default 30).
+ *   -NetProfileClients=<count>  Fail the capture if fewer clients were connected on average.
+ *   -NetProfileExit             Exit when the capture is done, with a nonzero exit code if a budget was exceeded.
+ */
+UCLASS(Config = Game)
+class OPENTOURNAMENT_API UUR_NetProfiler : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    //~UWorldSubsystem interface
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    //~End of UWorldSubsystem interface
+
+    //~FTickableGameObject interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    //~End of FTickableGameObject interface
+
+    /** Start a capture after Delay seconds, stopping by itself after Duration seconds */
+    void StartCapture(float Duration, float Delay = 0.f);
+
+    /** Stop the current capture and report it. Returns false if a budget was exceeded. */
+    bool StopCapture();
+
+    bool IsCapturing() const { return bCapturing; }
+
+    /** Called by the replication graph around ServerReplicateActors while capturing */
+    void RecordReplicateActors(int64 Bits, double Seconds);
+
+    /**
+    * Called by the replication graph for each actor replicated to a connection while capturing.
+    * bOpenedChannel is set when this replication opened the actor channel (initial bunch).
+    */
+    void RecordReplicateActor(const AActor* Actor, int64 Bits, double Seconds, bool bOpenedChannel);
+
+    /** Called by the replication graph around each RPC while capturing */
+    void RecordRemoteFunction(const AActor* Actor, const UFunction* Function, int64 Bits, double Seconds);
+
+    /** Bits sent so far to all client connections of the driver, including the pending packets */
+    static int64 GetSentBits(const UNetDriver* NetDriver);
+
+    static EUR_NetProfileCategory GetCategory(const AActor* Actor);
+
+    UPROPERTY(Config)
+    TArray<FUR_NetProfileBudget> CategoryBudgets;
+
+    UPROPERTY(Config)
+    TArray<FUR_NetProfileBudget> RpcBudgets;
+
+    /** Max replication graph CPU per frame, in milliseconds. Zero leaves it unchecked. */
+    UPROPERTY(Config)
+    float MaxReplicateActorsMs = 0.f;
+
+    /** Max outgoing bytes per second per connection. Zero leaves it unchecked. */
+    UPROPERTY(Config)
+    float MaxOutBytesPerSecond = 0.f;
+
+protected:
+
+    void SampleChannels();
+
+    bool Report();
+
+    struct FCategoryStats
+    {
+        int64 Updates = 0;
+        int64 PropertyBits = 0;
+        double ReplicateSeconds = 0.0;
+        /** Channel opens and the bits of their initial bunch */
+        int64 OpenBits = 0;
+        int32 Opens = 0;
+        int64 RpcBits = 0;
+        int32 RpcCalls = 0;
+    };
+
+    struct FRpcStats
+    {
+        EUR_NetProfileCategory Category = EUR_NetProfileCategory::Other;
+        int64 Bits = 0;
+        int32 Calls = 0;
+        double Seconds = 0.0;
+    };
+
+    FCategoryStats Categories[static_cast<int32>(EUR_NetProfileCategory::MAX)];
+
+    TMap<FName, FRpcStats> Rpcs;
+
+    double CaptureStartTime = 0.0;
+    double CaptureEndTime = 0.0;
+    double LastSampleNetTime = 0.0;
+
+    int64 ReplicateActorsBits = 0;
+    double ReplicateActorsSeconds = 0.0;
+    double MaxReplicateActorsSeconds = 0.0;
+    int32 ReplicateActorsFrames = 0;
+
+    /** Sums over sampled frames, for the averages */
+    int64 ConnectionFrames = 0;
+    int64 OutBytesPerSecondFrames = 0;
+    int32 SampledFrames = 0;
+
+    int32 ExpectedClients = 0;
+
+    bool bPending = false;
+    bool bCapturing = false;
+    bool bExitWhenDone = false;
+};
@@ -15,7 +15,9 @@
 #include "OpenTournament.h"
 #include "UR_Character.h"
 #include "UR_FunctionLibrary.h"
+#include "UR_GameplayActorRegistry.h"
 #include "UR_GameState.h"
+#include "UR_PickupAnimationSubsystem.h"
 #include "UR_PlayerState.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -45,6 +47,39 @@ AUR_Pickup::AUR_Pickup(const FObjectInitializer& ObjectInitializer) :
     SetReplicatingMovement(false);
 }
 
+void AUR_Pickup::BeginPlay()
+{
+    Super::BeginPlay();
+
+    UUR_GameplayActorRegistry::Register(this, EGameplayActorType::Pickup);
+}
+
+void AUR_Pickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    UUR_GameplayActorRegistry::Unregister(this);
+
+    if (auto AnimationSubsystem = GetWorld()->GetSubsystem<UUR_PickupAnimationSubsystem>())
+    {
+        AnimationSubsystem->NotifyAttachmentChanged(GetRootComponent() ? GetRootComponent()->GetAttachParent() : nullptr);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void AUR_Pickup::OnRep_AttachmentReplication()
+{
+    // Factories attach their pickup to a rotating component, refresh its render check on both ends
+    USceneComponent* OldParent = GetRootComponent() ? GetRootComponent()->GetAttachParent() : nullptr;
+
+    Super::OnRep_AttachmentReplication();
+
+    if (auto AnimationSubsystem = GetWorld()->GetSubsystem<UUR_PickupAnimationSubsystem>())
+    {
+        AnimationSubsystem->NotifyAttachmentChanged(OldParent);
+        AnimationSubsystem->NotifyAttachmentChanged(GetRootComponent() ? GetRootComponent()->GetAttachParent() : nullptr);
+    }
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 void AUR_Pickup::OnOverlap(UPrimitiveComponent* HitComp, AActor* Other, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
@@ -176,10 +211,15 @@ void AUR_Pickup::MulticastPickedUp_Implementation(AUR_Character* PickupCharacter
         SetActorEnableCollision(false);
         SetHidden(true);
         */
-        Destroy();
+        DestroyPickup();
     }
 }
 
+void AUR_Pickup::DestroyPickup()
+{
+    Destroy();
+}
+
 bool AUR_Pickup::OnPickup_Implementation(AUR_Character* PickupCharacter)
 {
     return true;
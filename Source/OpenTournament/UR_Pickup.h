@@ -37,6 +37,10 @@ class OPENTOURNAMENT_API AUR_Pickup : public AActor,
 public:	
 
     AUR_Pickup(const FObjectInitializer& ObjectInitializer);
+
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void OnRep_AttachmentReplication() override;
    
     /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -99,6 +103,13 @@ public:
     UFUNCTION(BlueprintNativeEvent, Category = "Pickup")
     bool OnPickup(AUR_Character* PickupCharacter);
 
+    /**
+    * Server & Client.
+    * Get rid of the pickup after it has been picked up, when OnPickup returned true.
+    * Recycled pickups override this to go back to their pool.
+    */
+    virtual void DestroyPickup();
+
     /**
     * Client only. Play pickup effects/sounds.
     */
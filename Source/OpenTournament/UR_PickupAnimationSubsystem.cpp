@@ -0,0 +1,373 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_PickupAnimationSubsystem.h"
+
+#include "Camera/PlayerCameraManager.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SceneComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Containers/Ticker.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+
+#include "UR_LogChannels.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_PickupAnimationSubsystem)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT Pickups"), STATGROUP_OTPickups, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Pickup Animation"), STAT_PickupAnimation, STATGROUP_OTPickups);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Animated Pickups"), STAT_AnimatedPickups, STATGROUP_OTPickups);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Animated Pickups Updated"), STAT_AnimatedPickupsUpdated, STATGROUP_OTPickups);
+
+namespace OTConsoleVariables
+{
+    static FAutoConsoleCommandWithWorldAndArgs CmdPickupAnimationBenchmark(
+        TEXT("OT.PickupAnimation.Benchmark"),
+        TEXT("Client only. Time pickup animation for increasing pickup counts. Optional args: max count (default 1000), seconds per step (default 5)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (auto AnimationSubsystem = World ? World->GetSubsystem<UUR_PickupAnimationSubsystem>() : nullptr)
+            {
+                AnimationSubsystem->Benchmark(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000, Args.Num() > 1 ? FCString::Atof(*Args[1]) : 5.f);
+            }
+        }));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UUR_PickupAnimationSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UUR_PickupAnimationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UUR_PickupAnimationSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_PickupAnimationSubsystem, STATGROUP_Tickables);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_PickupAnimationSubsystem::RegisterComponent(USceneComponent* Component, float RotationRate, float BobbingHeight, float BobbingSpeed, const FVector& InitialRelativeLocation)
+{
+    if (!Component || (RotationRate <= 0.f && BobbingHeight <= 0.f))
+    {
+        UnregisterComponent(Component);
+        return;
+    }
+
+    int32 Index;
+    if (const int32* ExistingIndex = EntryIndices.Find(Component))
+    {
+        Index = *ExistingIndex;
+    }
+    else
+    {
+        Index = Entries.AddDefaulted();
+        EntryIndices.Add(Component, Index);
+    }
+
+    FAnimatedEntry& Entry = Entries[Index];
+    Entry.Component = Component;
+    Entry.RotationRate = RotationRate;
+    Entry.BobbingHeight = BobbingHeight;
+    Entry.BobbingSpeed = BobbingSpeed;
+    Entry.InitialRelativeLocation = InitialRelativeLocation;
+    GatherRenderPrimitives(Entry);
+
+    SET_DWORD_STAT(STAT_AnimatedPickups, Entries.Num());
+}
+
+void UUR_PickupAnimationSubsystem::UnregisterComponent(USceneComponent* Component)
+{
+    if (const int32* Index = EntryIndices.Find(Component))
+    {
+        RemoveEntryAt(*Index);
+    }
+}
+
+void UUR_PickupAnimationSubsystem::NotifyAttachmentChanged(const USceneComponent* Parent)
+{
+    // Children of the animated component count too, walk up to the registered one
+    for (const USceneComponent* Component = Parent; Component; Component = Component->GetAttachParent())
+    {
+        if (const int32* Index = EntryIndices.Find(Component))
+        {
+            Entries[*Index].bRenderPrimitivesDirty = true;
+            return;
+        }
+    }
+}
+
+void UUR_PickupAnimationSubsystem::RemoveEntryAt(int32 Index)
+{
+    EntryIndices.Remove(Entries[Index].Component);
+
+    Entries.RemoveAtSwap(Index, 1, false);
+    if (Entries.IsValidIndex(Index))
+    {
+        EntryIndices.Add(Entries[Index].Component, Index);
+    }
+
+    SET_DWORD_STAT(STAT_AnimatedPickups, Entries.Num());
+}
+
+void UUR_PickupAnimationSubsystem::GatherRenderPrimitives(FAnimatedEntry& Entry) const
+{
+    Entry.RenderPrimitives.Reset();
+    Entry.bRenderPrimitivesDirty = false;
+
+    USceneComponent* Component = Entry.Component.Get();
+    if (!Component)
+    {
+        return;
+    }
+
+    if (UPrimitiveComponent* PrimitiveComp = Cast<UPrimitiveComponent>(Component))
+    {
+        Entry.RenderPrimitives.Add(PrimitiveComp);
+    }
+
+    // Most components used for rotating don't actually render, so also check attached children.
+    TArray<USceneComponent*> Children;
+    Component->GetChildrenComponents(true, Children);
+    for (USceneComponent* Child : Children)
+    {
+        if (UPrimitiveComponent* PrimitiveChild = Cast<UPrimitiveComponent>(Child))
+        {
+            Entry.RenderPrimitives.Add(PrimitiveChild);
+        }
+    }
+}
+
+// See MovementComponent.cpp @ 329
+bool UUR_PickupAnimationSubsystem::WasRecentlyRendered(const FAnimatedEntry& Entry, const UWorld* World) const
+{
+    for (const TWeakObjectPtr<UPrimitiveComponent>& WeakPrimitive : Entry.RenderPrimitives)
+    {
+        const UPrimitiveComponent* Primitive = WeakPrimitive.Get();
+        if (Primitive && Primitive->IsRegistered() && World->TimeSince(Primitive->GetLastRenderTime()) <= RenderTimeThreshold)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_PickupAnimationSubsystem::Tick(float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_PickupAnimation);
+
+    LastTickSeconds = 0.0;
+    LastNumUpdated = 0;
+
+    if (!bAnimatePickups || Entries.Num() == 0)
+    {
+        return;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    UWorld* World = GetWorld();
+    const double WorldTime = World->GetTimeSeconds();
+
+    bool bHasViewLocation = false;
+    FVector ViewLocation = FVector::ZeroVector;
+    if (CullDistance > 0.f)
+    {
+        if (APlayerController* PC = World->GetFirstPlayerController())
+        {
+            if (PC->PlayerCameraManager)
+            {
+                ViewLocation = PC->PlayerCameraManager->GetCameraLocation();
+                bHasViewLocation = true;
+            }
+        }
+    }
+    const double CullDistanceSq = FMath::Square(CullDistance);
+
+    int32 NumUpdated = 0;
+
+    for (int32 i = Entries.Num() - 1; i >= 0; i--)
+    {
+        FAnimatedEntry& Entry = Entries[i];
+
+        USceneComponent* Component = Entry.Component.Get();
+        if (!Component)
+        {
+            RemoveEntryAt(i);
+            continue;
+        }
+
+        if (Entry.bRenderPrimitivesDirty)
+        {
+            GatherRenderPrimitives(Entry);
+        }
+
+        if (!Component->IsVisible())
+        {
+            continue;
+        }
+
+        if (bHasViewLocation && FVector::DistSquared(Component->GetComponentLocation(), ViewLocation) > CullDistanceSq)
+        {
+            continue;
+        }
+
+        if (!WasRecentlyRendered(Entry, World))
+        {
+            continue;
+        }
+
+        if (Entry.RotationRate > 0.f)
+        {
+            Component->AddLocalRotation(FRotator(0.f, Entry.RotationRate * DeltaTime, 0.f));
+        }
+
+        if (Entry.BobbingHeight > 0.f)
+        {
+            FVector Loc(Entry.InitialRelativeLocation);
+            Loc.Z += Entry.BobbingHeight * FMath::Sin(Entry.BobbingSpeed * PI * WorldTime);
+            Component->SetRelativeLocation(Loc);
+        }
+
+        NumUpdated++;
+    }
+
+    INC_DWORD_STAT_BY(STAT_AnimatedPickupsUpdated, NumUpdated);
+
+    LastTickSeconds = FPlatformTime::Seconds() - StartTime;
+    LastNumUpdated = NumUpdated;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_PickupAnimationSubsystem::Benchmark(int32 Count, float Duration)
+{
+    UWorld* World = GetWorld();
+    APlayerController* PC = World->GetFirstPlayerController();
+    UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+    if (!PC || !PC->PlayerCameraManager || !Mesh || Count <= 0)
+    {
+        UE_LOG(LogGame, Warning, TEXT("PickupAnimation: benchmark needs a local player and a pickup count"));
+        return;
+    }
+
+    // Grid of small cubes in front of the view, so they pass the render and distance checks like visible pickups
+    const FVector ViewLocation = PC->PlayerCameraManager->GetCameraLocation();
+    const FRotator ViewRotation(0.f, PC->PlayerCameraManager->GetCameraRotation().Yaw, 0.f);
+    const auto SpawnCube = [World, Mesh, ViewLocation, ViewRotation](int32 Index) -> AStaticMeshActor*
+    {
+        const int32 Row = Index / 40;
+        const int32 Column = Index % 40;
+        const FVector Offset(500.f + 60.f * Row, 60.f * (Column - 20), 0.f);
+        FActorSpawnParameters Params;
+        Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        AStaticMeshActor* Cube = World->SpawnActor<AStaticMeshActor>(ViewLocation + ViewRotation.RotateVector(Offset), FRotator::ZeroRotator, Params);
+        if (Cube)
+        {
+            Cube->SetMobility(EComponentMobility::Movable);
+            Cube->GetStaticMeshComponent()->SetStaticMesh(Mesh);
+            Cube->GetStaticMeshComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+            Cube->SetActorScale3D(FVector(0.3f));
+        }
+        return Cube;
+    };
+
+    struct FBenchmark
+    {
+        TArray<int32> Steps;
+        int32 Step = 0;
+        TArray<TWeakObjectPtr<AStaticMeshActor>> Cubes;
+        double StepStartTime = 0.0;
+        double TickSeconds = 0.0;
+        double MaxTickSeconds = 0.0;
+        double FrameSeconds = 0.0;
+        int64 NumUpdated = 0;
+        int32 Frames = 0;
+    };
+    TSharedRef<FBenchmark> State = MakeShared<FBenchmark>();
+    State->Steps = { FMath::Max(Count / 10, 1), FMath::Max(Count / 4, 1), FMath::Max(Count / 2, 1), Count };
+
+    UE_LOG(LogGame, Log, TEXT("PickupAnimation: benchmark up to %i pickups, %.1f s per step (%i entries registered by the map)"), Count, Duration, Entries.Num());
+
+    TWeakObjectPtr<UUR_PickupAnimationSubsystem> WeakThis(this);
+    FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis, State, SpawnCube, Duration](float DeltaTime)
+    {
+        UUR_PickupAnimationSubsystem* Subsystem = WeakThis.Get();
+        if (!Subsystem)
+        {
+            return false;
+        }
+
+        const double Now = FPlatformTime::Seconds();
+        const auto RegisterUpTo = [&](int32 Num)
+        {
+            while (State->Cubes.Num() < Num)
+            {
+                AStaticMeshActor* Cube = SpawnCube(State->Cubes.Num());
+                State->Cubes.Add(Cube);
+                if (Cube)
+                {
+                    Subsystem->RegisterComponent(Cube->GetRootComponent(), 180.f, 10.f, 1.f, Cube->GetRootComponent()->GetRelativeLocation());
+                }
+            }
+            State->StepStartTime = Now;
+            State->TickSeconds = State->MaxTickSeconds = State->FrameSeconds = 0.0;
+            State->NumUpdated = State->Frames = 0;
+        };
+
+        if (State->StepStartTime == 0.0)
+        {
+            RegisterUpTo(State->Steps[0]);
+            return true;
+        }
+
+        // First second of each step lets new cubes get rendered once
+        if (Now - State->StepStartTime > 1.0)
+        {
+            State->TickSeconds += Subsystem->LastTickSeconds;
+            State->MaxTickSeconds = FMath::Max(State->MaxTickSeconds, Subsystem->LastTickSeconds);
+            State->FrameSeconds += FApp::GetDeltaTime();
+            State->NumUpdated += Subsystem->LastNumUpdated;
+            State->Frames++;
+        }
+        if (Now - State->StepStartTime < 1.0 + Duration)
+        {
+            return true;
+        }
+
+        const int32 Frames = FMath::Max(State->Frames, 1);
+        UE_LOG(LogGame, Log, TEXT("  %5i pickups: tick avg %.3f ms max %.3f ms, %.0f updated per frame, frame %.2f ms"),
+            State->Cubes.Num(), 1000.0 * State->TickSeconds / Frames, 1000.0 * State->MaxTickSeconds, static_cast<double>(State->NumUpdated) / Frames, 1000.0 * State->FrameSeconds / Frames);
+
+        if (State->Steps.IsValidIndex(++State->Step))
+        {
+            RegisterUpTo(State->Steps[State->Step]);
+            return true;
+        }
+
+        for (const TWeakObjectPtr<AStaticMeshActor>& Cube : State->Cubes)
+        {
+            if (Cube.IsValid())
+            {
+                Subsystem->UnregisterComponent(Cube->GetRootComponent());
+                Cube->Destroy();
+            }
+        }
+        return false;
+    }));
+}
@@ -0,0 +1,112 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UR_PickupAnimationSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+class USceneComponent;
+class UPrimitiveComponent;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Cosmetic rotating/bobbing animation of pickups and pickup factories.
+ *
+ * Maps can have a lot of pickups in them, and ticking each actor just to rotate a mesh adds up.
+ * Instead, pickups register their animated component here, and all of them are updated in a single
+ * loop over a packed array. Entries that were not rendered recently, or are too far from the local
+ * view, are skipped.
+ *
+ * Only exists on clients, dedicated servers never animate pickups.
+ */
+UCLASS(Config = Game)
+class OPENTOURNAMENT_API UUR_PickupAnimationSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    //~UWorldSubsystem interface
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    //~End of UWorldSubsystem interface
+
+    //~FTickableGameObject interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    //~End of FTickableGameObject interface
+
+    /**
+    * Start animating a component.
+    * InitialRelativeLocation is the bobbing center.
+    * Registering an already registered component updates its parameters.
+    */
+    void RegisterComponent(USceneComponent* Component, float RotationRate, float BobbingHeight, float BobbingSpeed, const FVector& InitialRelativeLocation);
+
+    void UnregisterComponent(USceneComponent* Component);
+
+    /**
+    * Call when something was attached to or detached from an animated component (or one of its children),
+    * so the primitives used for the render check are gathered again.
+    */
+    void NotifyAttachmentChanged(const USceneComponent* Parent);
+
+    /**
+    * Spawn animated cubes in front of the local view, in steps up to Count, and report tick and frame times
+    * over Duration seconds at each step. Backs the OT.PickupAnimation.Benchmark console command.
+    */
+    void Benchmark(int32 Count, float Duration);
+
+    /** Global switch for rotating pickups */
+    UPROPERTY(Config)
+    bool bAnimatePickups = true;
+
+    /** Entries farther than this from the local view are not animated. 0 = no distance culling. */
+    UPROPERTY(Config)
+    float CullDistance = 8000.f;
+
+    /** Entries not rendered within this time are not animated */
+    UPROPERTY(Config)
+    float RenderTimeThreshold = 0.41f;
+
+protected:
+
+    struct FAnimatedEntry
+    {
+        TWeakObjectPtr<USceneComponent> Component;
+
+        /** Primitives to check for render time (the component itself, and its attached children) */
+        TArray<TWeakObjectPtr<UPrimitiveComponent>, TInlineAllocator<4>> RenderPrimitives;
+
+        /** Set by NotifyAttachmentChanged, RenderPrimitives are gathered again on next update */
+        bool bRenderPrimitivesDirty;
+
+        FVector InitialRelativeLocation;
+        float RotationRate;
+        float BobbingHeight;
+        float BobbingSpeed;
+    };
+
+    void GatherRenderPrimitives(FAnimatedEntry& Entry) const;
+
+    bool WasRecentlyRendered(const FAnimatedEntry& Entry, const UWorld* World) const;
+
+    TArray<FAnimatedEntry> Entries;
+
+    /** Component to index in Entries */
+    TMap<TObjectKey<USceneComponent>, int32> EntryIndices;
+
+    /** Time spent in the last Tick, for the benchmark */
+    double LastTickSeconds = 0.0;
+
+    int32 LastNumUpdated = 0;
+
+    void RemoveEntryAt(int32 Index);
+};
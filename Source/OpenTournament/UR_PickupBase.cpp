@@ -15,8 +15,12 @@
 
 #include "UR_Character.h"
 #include "UR_FunctionLibrary.h"
+#include "UR_GameplayActorRegistry.h"
 #include "UR_PlayerController.h"
 #include "UR_LocalMessage.h"
+#include "UR_LogChannels.h"
+#include "UR_PickupAnimationSubsystem.h"
+#include "UR_PickupIndexSubsystem.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -31,6 +35,9 @@
 * We should :
 * - minimize that impact as much as possible
 * - even better, provide a configurable option to disable rotating pickups on client, so we can disable Tick altogether in this class.
+*
+* Rotating/bobbing is now handled by UUR_PickupAnimationSubsystem, which updates all pickups in a single loop,
+* and can be turned off with bAnimatePickups. Tick is only enabled for blueprints implementing it.
 */
 
 AUR_PickupBase::AUR_PickupBase()
@@ -38,14 +45,13 @@ AUR_PickupBase::AUR_PickupBase()
     PrimaryActorTick.bCanEverTick = true;
     PrimaryActorTick.bAllowTickOnDedicatedServer = false;
     PrimaryActorTick.bStartWithTickEnabled = false;
-    //PrimaryActorTick.bRunOnAnyThread = true;	//CRASH?
-
-    //NOTE: Consider using TickInterval to improve performance.
-    // Rotating weapon might not need to update any faster than 60hz,
-    // so if player is running at higher FPS some frames could be entirely skipped.
 
     bReplicates = true;
 
+    // Clients simulate respawns, the server only needs to send pick up events.
+    // Stay dormant in between, flushing before every replicated state change or multicast.
+    NetDormancy = DORM_Initial;
+
     RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
 
     CapsuleComponent = CreateDefaultSubobject<UCapsuleComponent>(TEXT("CapsuleComponent"));
@@ -84,6 +90,7 @@ void AUR_PickupBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLi
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
     DOREPLIFETIME_CONDITION(ThisClass, bRepInitialPickupAvailable, COND_InitialOnly);
+    DOREPLIFETIME_CONDITION(ThisClass, NextRespawnTime, COND_None);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -92,14 +99,20 @@ void AUR_PickupBase::BeginPlay()
 {
     Super::BeginPlay();
 
+    UUR_GameplayActorRegistry::Register(this, EGameplayActorType::Pickup);
+
     if (!IsNetMode(NM_DedicatedServer))
     {
-        //TODO: configurable rotating pickups ?
-        SetActorTickEnabled(RotatingComponent && (RotationRate != 0.0f || BobbingHeight != 0.0f));
+        SetActorTickEnabled(GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AActor, ReceiveTick)));
+    }
+
+    if (!IsNetMode(NM_DedicatedServer) && RotatingComponent)
+    {
+        InitialRelativeLocation = RotatingComponent->GetRelativeTransform().GetLocation();
 
-        if (RotatingComponent)
+        if (auto AnimationSubsystem = GetWorld()->GetSubsystem<UUR_PickupAnimationSubsystem>())
         {
-            InitialRelativeLocation = RotatingComponent->GetRelativeTransform().GetLocation();
+            AnimationSubsystem->RegisterComponent(RotatingComponent, RotationRate, BobbingHeight, BobbingSpeed, InitialRelativeLocation);
         }
     }
 
@@ -118,15 +131,9 @@ void AUR_PickupBase::BeginPlay()
         // Initial spawn delay
         if (InitialSpawnDelay > 0.0f)
         {
-            const float PreSpawnTime = InitialSpawnDelay - PreRespawnEffectDuration;
-            if (PreSpawnTime > 0.0f)
-            {
-                GetWorld()->GetTimerManager().SetTimer(RespawnTimerHandle, this, &AUR_PickupBase::PreRespawnTimer, PreSpawnTime, false);
-            }
-            else
-            {
-                MulticastWillRespawn();
-            }
+            FlushNetDormancy();
+            NextRespawnTime = UUR_PickupRespawnSubsystem::GetServerTime(this) + InitialSpawnDelay;
+            ScheduleRespawnEvents();
         }
     }
     else
@@ -135,70 +142,38 @@ void AUR_PickupBase::BeginPlay()
         // Careful, RepNotify can trigger just before or just after BeginPlay.
         ShowPickupAvailable(bPickupAvailable);
     }
-}
-
-void AUR_PickupBase::OnRep_bRepInitialPickupAvailable()
-{
-    // Remote initial availability
-    bPickupAvailable = bRepInitialPickupAvailable;
-    ShowPickupAvailable(bPickupAvailable);
-}
-
-void AUR_PickupBase::Tick(float DeltaTime)
-{
-    Super::Tick(DeltaTime);
 
-    if (!ShouldSkipTick())
+    if (auto PickupIndex = GetWorld()->GetSubsystem<UUR_PickupIndexSubsystem>())
     {
-        if (RotationRate > 0.0f)
-        {
-            RotatingComponent->AddLocalRotation(FRotator(0.0f, RotationRate * DeltaTime, 0.0f));
-        }
-
-        if (BobbingHeight > 0.0f)
-        {
-            FVector Loc(InitialRelativeLocation);
-            Loc.Z += BobbingHeight * FMath::Sin(BobbingSpeed * PI * GetWorld()->TimeSeconds);
-            RotatingComponent->SetRelativeLocation(Loc);
-        }
+        PickupIndex->RegisterItem(this, GameplayTags, bPickupAvailable);
     }
 }
 
-// See MovementComponent.cpp @ 329
-bool AUR_PickupBase::ShouldSkipTick()
+void AUR_PickupBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-    if (!RotatingComponent || !RotatingComponent->IsVisible())
-    {
-        return true;
-    }
+    CancelRespawnEvents();
 
-    const float RenderTimeThreshold = 0.41f;
-    UWorld* TheWorld = GetWorld();
+    UUR_GameplayActorRegistry::Unregister(this);
 
-    if (const UPrimitiveComponent* PrimitiveComp = Cast<UPrimitiveComponent>(RotatingComponent))
+    if (auto PickupIndex = GetWorld()->GetSubsystem<UUR_PickupIndexSubsystem>())
     {
-        if (TheWorld->TimeSince(PrimitiveComp->GetLastRenderTime()) <= RenderTimeThreshold)
-        {
-            return false; // Rendered, don't skip it.
-        }
+        PickupIndex->UnregisterItem(this);
     }
 
-    // Most components used with movement components don't actually render, so check attached children render times.
-    TArray<USceneComponent*> RotatingChildren;
-    RotatingComponent->GetChildrenComponents(true, RotatingChildren);
-    for (auto Child : RotatingChildren)
+    if (auto AnimationSubsystem = GetWorld()->GetSubsystem<UUR_PickupAnimationSubsystem>())
     {
-        if (const UPrimitiveComponent* PrimitiveChild = Cast<UPrimitiveComponent>(Child))
-        {
-            if (PrimitiveChild->IsRegistered() && TheWorld->TimeSince(PrimitiveChild->GetLastRenderTime()) <= RenderTimeThreshold)
-            {
-                return false; // Rendered, don't skip it.
-            }
-        }
+        AnimationSubsystem->UnregisterComponent(RotatingComponent);
     }
 
-    // No children were recently rendered, safely skip the update.
-    return true;
+    Super::EndPlay(EndPlayReason);
+}
+
+void AUR_PickupBase::OnRep_bRepInitialPickupAvailable()
+{
+    // Remote initial availability
+    bPickupAvailable = bRepInitialPickupAvailable;
+    ShowPickupAvailable(bPickupAvailable);
+    UpdatePickupIndex();
 }
 
 void AUR_PickupBase::OnBeginOverlap_Implementation(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
@@ -241,32 +216,94 @@ bool AUR_PickupBase::AllowPickupBy_Implementation(AActor* Other)
 
 void AUR_PickupBase::GiveTo_Implementation(AActor* Other)
 {
+    // Multicasts are not sent through dormant channels
+    FlushNetDormancy();
+    NextRespawnTime = UUR_PickupRespawnSubsystem::GetServerTime(this) + RespawnTime;
     MulticastPickedUp(Other);
     //NOTE: maybe we should broadcast PickupMessage from here, if we want spectators to see them.
 }
 
 #define PICKUP_PREDICTION_CHECK_DELAY 1.5f
 
+DECLARE_STATS_GROUP(TEXT("OT Pickup Prediction"), STATGROUP_OTPickupPrediction, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Predictions Made"), STAT_PickupPredictionsMade, STATGROUP_OTPickupPrediction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Predictions Confirmed"), STAT_PickupPredictionsConfirmed, STATGROUP_OTPickupPrediction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Predictions Rejected"), STAT_PickupPredictionsRejected, STATGROUP_OTPickupPrediction);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last Confirmation Latency (ms)"), STAT_PickupPredictionLatency, STATGROUP_OTPickupPrediction);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Max Confirmation Latency (ms)"), STAT_PickupPredictionMaxLatency, STATGROUP_OTPickupPrediction);
+
+namespace OTConsoleVariables
+{
+    static bool bPredictPickupEffects = true;
+    static FAutoConsoleVariableRef CVarPredictPickupEffects(
+        TEXT("OT.PredictPickupEffects"),
+        bPredictPickupEffects,
+        TEXT("Apply pickup effects (health...) locally when predicting a pickup, instead of waiting for the server."),
+        ECVF_Default);
+}
+
+static float MaxPickupPredictionLatencyMs = 0.f;
+
 void AUR_PickupBase::SimulateGiveTo_Implementation(AActor* LocalClientActor)
 {
     PlayPickupEffects();
     ShowPickupAvailable(false);
 
-    // Check that the server actually confirms our pickup.
-    if (RespawnTime > PICKUP_PREDICTION_CHECK_DELAY)
+    ActivePrediction.StartTime = FPlatformTime::Seconds();
+    ActivePrediction.Recipient = LocalClientActor;
+    INC_DWORD_STAT(STAT_PickupPredictionsMade);
+
+    if (OTConsoleVariables::bPredictPickupEffects)
     {
-        GetWorld()->GetTimerManager().SetTimer(PredictionErrorTimerHandle, this, &AUR_PickupBase::CheckClientPredictionError, PICKUP_PREDICTION_CHECK_DELAY, false);
+        ApplyPredictedEffects(LocalClientActor);
     }
+
+    // Check that the server actually confirms our pickup.
+    // Always armed, predicted effects must be rolled back even if the pickup already respawned locally.
+    GetWorld()->GetTimerManager().SetTimer(PredictionErrorTimerHandle, this, &AUR_PickupBase::CheckClientPredictionError, PICKUP_PREDICTION_CHECK_DELAY, false);
 }
 
 void AUR_PickupBase::CheckClientPredictionError()
 {
+    // Server never confirmed
+    if (ActivePrediction.IsActive())
+    {
+        ResolvePrediction(false);
+    }
+
     if (!bPickupAvailableLocally && bPickupAvailable)
     {
         ShowPickupAvailable(true);
     }
 }
 
+void AUR_PickupBase::ResolvePrediction(bool bConfirmed)
+{
+    if (bConfirmed)
+    {
+        const float LatencyMs = (FPlatformTime::Seconds() - ActivePrediction.StartTime) * 1000.0;
+        MaxPickupPredictionLatencyMs = FMath::Max(MaxPickupPredictionLatencyMs, LatencyMs);
+
+        INC_DWORD_STAT(STAT_PickupPredictionsConfirmed);
+        SET_FLOAT_STAT(STAT_PickupPredictionLatency, LatencyMs);
+        SET_FLOAT_STAT(STAT_PickupPredictionMaxLatency, MaxPickupPredictionLatencyMs);
+        UE_LOG(LogGame, Verbose, TEXT("Pickup prediction confirmed on %s after %.1f ms"), *GetName(), LatencyMs);
+    }
+    else
+    {
+        if (OTConsoleVariables::bPredictPickupEffects && ActivePrediction.Recipient.IsValid())
+        {
+            RollbackPredictedEffects(ActivePrediction.Recipient.Get());
+        }
+
+        INC_DWORD_STAT(STAT_PickupPredictionsRejected);
+        UE_LOG(LogGame, Verbose, TEXT("Pickup prediction rejected on %s"), *GetName());
+    }
+
+    GetWorld()->GetTimerManager().ClearTimer(PredictionErrorTimerHandle);
+    ActivePrediction = FPickupPrediction();
+}
+
 void AUR_PickupBase::MulticastPickedUp_Implementation(AActor* Picker)
 {
     if (!IsNetMode(NM_DedicatedServer))
@@ -288,13 +325,19 @@ void AUR_PickupBase::MulticastPickedUp_Implementation(AActor* Picker)
         // - bPickupAvailableLocally TRUE means pickup is here locally and we did not simulate picking up.
         // - bPickupAvailable FALSE means pickup hasn't respawned locally just yet.
 
+        // Server confirms or contradicts our prediction
+        if (ActivePrediction.IsActive())
+        {
+            ResolvePrediction(Picker && Picker == ActivePrediction.Recipient.Get());
+        }
+
         if (bPickupAvailableLocally || !bPickupAvailable)
         {
             PlayPickupEffects();
             ShowPickupAvailable(false);
 
             // avoid RespawnTimer firing just after this (also a case 4 thing)
-            GetWorld()->GetTimerManager().ClearTimer(RespawnTimerHandle);
+            CancelRespawnEvents();
         }
 
         // We don't simulate the pickup message, that one is only here.
@@ -306,34 +349,71 @@ void AUR_PickupBase::MulticastPickedUp_Implementation(AActor* Picker)
 
     bPickupAvailable = false;
     bRepInitialPickupAvailable = false;
+    UpdatePickupIndex();
 
-    const float PreRespawnTime = RespawnTime - PreRespawnEffectDuration;
-    if (PreRespawnTime > 0.0f)
+    // Server and clients schedule the same events, no need to multicast again when pickup is about to respawn.
+    // NextRespawnTime is replicated, and may arrive before or after this, so schedule from both.
+    ScheduleRespawnEvents();
+}
+
+void AUR_PickupBase::ShowPickupAvailable_Implementation(bool bAvailable)
+{
+    bPickupAvailableLocally = bAvailable;
+}
+
+void AUR_PickupBase::UpdatePickupIndex()
+{
+    if (auto PickupIndex = GetWorld()->GetSubsystem<UUR_PickupIndexSubsystem>())
     {
-        // if we have a respawn time, only trust authority to run timer and multicast at the end
-        if (HasAuthority())
-        {
-            GetWorld()->GetTimerManager().SetTimer(RespawnTimerHandle, this, &AUR_PickupBase::PreRespawnTimer, PreRespawnTime, false);
-        }
+        PickupIndex->SetItemAvailable(this, bPickupAvailable);
     }
-    else
+}
+
+void AUR_PickupBase::OnRep_NextRespawnTime()
+{
+    ScheduleRespawnEvents();
+}
+
+void AUR_PickupBase::ScheduleRespawnEvents()
+{
+    CancelRespawnEvents();
+
+    auto RespawnSubsystem = GetWorld()->GetSubsystem<UUR_PickupRespawnSubsystem>();
+    if (!RespawnSubsystem || NextRespawnTime <= 0.0)
+    {
+        return;
+    }
+
+    // Late joiners past the respawn time already know the pickup is available via bRepInitialPickupAvailable
+    if (!HasAuthority() && NextRespawnTime <= UUR_PickupRespawnSubsystem::GetServerTime(this))
     {
-        // if instant respawn, client can simulate everything
-        MulticastWillRespawn_Implementation();
+        return;
     }
+
+    // Order matters when PreRespawnEffectDuration is zero, both fire on the same update
+    PreRespawnHandle = RespawnSubsystem->Schedule(NextRespawnTime - PreRespawnEffectDuration, FSimpleDelegate::CreateUObject(this, &ThisClass::PreRespawnTimer));
+    RespawnHandle = RespawnSubsystem->Schedule(NextRespawnTime, FSimpleDelegate::CreateUObject(this, &ThisClass::RespawnTimer));
 }
 
-void AUR_PickupBase::ShowPickupAvailable_Implementation(bool bAvailable)
+void AUR_PickupBase::CancelRespawnEvents()
 {
-    bPickupAvailableLocally = bAvailable;
+    if (auto RespawnSubsystem = GetWorld()->GetSubsystem<UUR_PickupRespawnSubsystem>())
+    {
+        RespawnSubsystem->Cancel(PreRespawnHandle);
+        RespawnSubsystem->Cancel(RespawnHandle);
+    }
 }
 
-void AUR_PickupBase::PreRespawnTimer()
+float AUR_PickupBase::GetRespawnTimeRemaining() const
 {
-    MulticastWillRespawn();
+    if (bPickupAvailable || NextRespawnTime <= 0.0)
+    {
+        return 0.f;
+    }
+    return FMath::Max(0.f, static_cast<float>(NextRespawnTime - UUR_PickupRespawnSubsystem::GetServerTime(this)));
 }
 
-void AUR_PickupBase::MulticastWillRespawn_Implementation()
+void AUR_PickupBase::PreRespawnTimer()
 {
     if (!IsNetMode(NM_DedicatedServer))
     {
@@ -342,16 +422,6 @@ void AUR_PickupBase::MulticastWillRespawn_Implementation()
 
     // If client joins inbetween this and actual respawn, assume it's already spawned.
     bRepInitialPickupAvailable = true;
-
-    // This one timer should be short, client can simulate it.
-    if (PreRespawnEffectDuration > 0.0f)
-    {
-        GetWorld()->GetTimerManager().SetTimer(RespawnTimerHandle, this, &AUR_PickupBase::RespawnTimer, PreRespawnEffectDuration, false);
-    }
-    else
-    {
-        RespawnTimer();
-    }
 }
 
 void AUR_PickupBase::RespawnTimer()
@@ -364,6 +434,8 @@ void AUR_PickupBase::RespawnTimer()
         ShowPickupAvailable(true);
     }
 
+    UpdatePickupIndex();
+
     // Check overlaps
     // NOTE: with zero respawn time, avoid infinite pickup loop
     if (RespawnTime > 0.0f)
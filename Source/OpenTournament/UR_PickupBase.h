@@ -6,6 +6,9 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "GameplayTagContainer.h"
+
+#include "UR_PickupRespawnSubsystem.h"
 
 #include "UR_PickupBase.generated.h"
 
@@ -56,6 +59,12 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     float BobbingSpeed;
 
+    /**
+    * Tags this item is found by in the pickup index (UUR_PickupIndexSubsystem).
+    */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GameplayTags")
+    FGameplayTagContainer GameplayTags;
+
     UPROPERTY(BlueprintReadWrite)
     FVector InitialRelativeLocation;
 
@@ -69,7 +78,7 @@ public:
     /**
     * Replicates the state of the pickup to late-joining players.
     * Replication is initial-only.
-    * This slightly differs from bPickupAvailable as it has to handle player joining right in-between MulticastWillRespawn and actual respawn.
+    * This slightly differs from bPickupAvailable as it has to handle player joining right in-between the pre-respawn event and actual respawn.
     */
     UPROPERTY(Replicated, ReplicatedUsing = OnRep_bRepInitialPickupAvailable, BlueprintReadWrite)
     bool bRepInitialPickupAvailable;
@@ -89,7 +98,16 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly)
     float PreRespawnEffectDuration;
 
-    FTimerHandle RespawnTimerHandle;
+    /**
+    * Server world time at which the pickup respawns.
+    * Replicated, for late joiners too.
+    * Clients schedule pre-respawn and respawn events locally from it.
+    */
+    UPROPERTY(Transient, BlueprintReadOnly, ReplicatedUsing = OnRep_NextRespawnTime)
+    double NextRespawnTime;
+
+    FUR_PickupRespawnHandle PreRespawnHandle;
+    FUR_PickupRespawnHandle RespawnHandle;
 
     /**
     * Pickup availability according to client pickup predictions.
@@ -100,6 +118,21 @@ public:
 
     FTimerHandle PredictionErrorTimerHandle;
 
+    /**
+    * Client-side pickup prediction in flight.
+    * Nothing is sent to the server, which detects the overlap on its own.
+    * The prediction is confirmed when MulticastPickedUp names our recipient,
+    * and rolled back when it names someone else or does not come in time (CheckClientPredictionError).
+    */
+    struct FPickupPrediction
+    {
+        double StartTime = 0.0;
+        TWeakObjectPtr<AActor> Recipient;
+
+        bool IsActive() const { return StartTime > 0.0; }
+    };
+    FPickupPrediction ActivePrediction;
+
     /**
     * Initial spawn delay. For powerups.
     */
@@ -116,10 +149,18 @@ protected:
     virtual void OnConstruction(const FTransform& Transform) override;
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     UFUNCTION()
     virtual void OnRep_bRepInitialPickupAvailable();
-    virtual void Tick(float DeltaTime) override;
-    virtual bool ShouldSkipTick();
+    UFUNCTION()
+    virtual void OnRep_NextRespawnTime();
+
+    /** Schedule pre-respawn and respawn events from NextRespawnTime */
+    virtual void ScheduleRespawnEvents();
+    virtual void CancelRespawnEvents();
+
+    /** Push availability to the pickup index */
+    void UpdatePickupIndex();
 
 public:
 
@@ -156,6 +197,26 @@ public:
     UFUNCTION()
     virtual void CheckClientPredictionError();
 
+    /**
+    * Remote only.
+    * Apply the effects of this pickup locally on the predicting client (health, etc.), see OT.PredictPickupEffects.
+    * Must save whatever is needed to undo it in RollbackPredictedEffects.
+    */
+    UFUNCTION(BlueprintNativeEvent)
+    void ApplyPredictedEffects(AActor* LocalClientActor);
+    virtual void ApplyPredictedEffects_Implementation(AActor* LocalClientActor) {}
+
+    /**
+    * Remote only.
+    * Undo ApplyPredictedEffects, when the server did not confirm our pickup.
+    */
+    UFUNCTION(BlueprintNativeEvent)
+    void RollbackPredictedEffects(AActor* LocalClientActor);
+    virtual void RollbackPredictedEffects_Implementation(AActor* LocalClientActor) {}
+
+    /** Close the active prediction, updating counters */
+    void ResolvePrediction(bool bConfirmed);
+
     /**
     * Broadcast when pickup is being given away.
     */
@@ -178,18 +239,17 @@ public:
     void ShowPickupAvailable(bool bAvailable);
 
     /**
-    * Authority only.
-    * Only when RespawnTime - PreRespawnEffectDuration > 0.
-    * Broadcasts MulticastWillRespawn.
+    * Server / client.
+    * Triggered by the respawn scheduler when pickup is about to respawn (NextRespawnTime minus PreRespawnEffectDuration).
     */
-    UFUNCTION()
     virtual void PreRespawnTimer();
 
     /**
-    * Broadcast when pickup is about to respawn (RespawnTime minus PreRespawnEffectDuration).
+    * Seconds left until the pickup respawns. 0 if available.
+    * Computed locally from NextRespawnTime, usable for HUD countdowns.
     */
-    UFUNCTION(NetMulticast, Reliable)
-    void MulticastWillRespawn();
+    UFUNCTION(BlueprintPure)
+    float GetRespawnTimeRemaining() const;
 
     /**
     * Client only.
@@ -13,6 +13,9 @@
 
 #include "UR_FunctionLibrary.h"
 #include "UR_Pickup.h"
+#include "UR_PickupAnimationSubsystem.h"
+#include "UR_PickupIndexSubsystem.h"
+#include "AI/UR_AITacticalSubsystem.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -27,6 +30,9 @@
 * We should:
 * - minimize that impact as much as possible
 * - even better, provide a configurable option to disable rotating pickups on client, so we can disable Tick altogether in this class.
+*
+* Rotating/bobbing is now handled by UUR_PickupAnimationSubsystem, which updates all pickups in a single loop,
+* and can be turned off with bAnimatePickups. Tick is only enabled for blueprints implementing it.
 */
 
 AUR_PickupFactory::AUR_PickupFactory()
@@ -34,15 +40,14 @@ AUR_PickupFactory::AUR_PickupFactory()
     PrimaryActorTick.bCanEverTick = true;
     PrimaryActorTick.bAllowTickOnDedicatedServer = false;
     PrimaryActorTick.bStartWithTickEnabled = false;
-    //PrimaryActorTick.bRunOnAnyThread = true;	//CRASH?
-
-    // NOTE: Consider using TickInterval to improve performance.
-    // Rotating pickup might not need to update any faster than 60hz,
-    // so if player is running at higher FPS some frames could be entirely skipped.
 
     bReplicates = true;
     SetReplicatingMovement(false);
 
+    // Replicated state only changes on pickup and respawn, stay dormant in between.
+    // Every change of replicated state must call FlushNetDormancy().
+    NetDormancy = DORM_Initial;
+
     RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
 
     // NOTE: Cannot point to RootComponent here or it is impossible to override in BP construction script.
@@ -61,6 +66,8 @@ AUR_PickupFactory::AUR_PickupFactory()
 
     InitialSpawnDelay = 0;
     RespawnTime = 5;
+
+    AIDesirability = 1.f;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -108,6 +115,7 @@ void AUR_PickupFactory::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Ou
 
     DOREPLIFETIME_CONDITION(ThisClass, PickupClass, COND_InitialOnly);
     DOREPLIFETIME_CONDITION(ThisClass, Pickup, COND_None);
+    DOREPLIFETIME_CONDITION(ThisClass, NextRespawnTime, COND_None);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -121,19 +129,41 @@ void AUR_PickupFactory::BeginPlay()
         InitialRelativeLocation = AttachComponent->GetRelativeLocation();
     }
 
-    if (!IsNetMode(NM_DedicatedServer) && AttachComponent && (RotationRate != 0.f || BobbingHeight != 0.f))
+    if (!IsNetMode(NM_DedicatedServer))
     {
-        // TODO: configurable rotating pickups?
-        SetActorTickEnabled(true);
+        SetActorTickEnabled(GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AActor, ReceiveTick)));
     }
-    else
+
+    if (!IsNetMode(NM_DedicatedServer) && AttachComponent)
     {
-        SetActorTickEnabled(false);
+        if (auto AnimationSubsystem = GetWorld()->GetSubsystem<UUR_PickupAnimationSubsystem>())
+        {
+            AnimationSubsystem->RegisterComponent(AttachComponent, RotationRate, BobbingHeight, BobbingSpeed, InitialRelativeLocation);
+        }
     }
 
+    RegisterInPickupIndex();
+
     Reset();
 }
 
+void AUR_PickupFactory::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    CancelRespawnEvents();
+
+    if (auto AnimationSubsystem = GetWorld()->GetSubsystem<UUR_PickupAnimationSubsystem>())
+    {
+        AnimationSubsystem->UnregisterComponent(AttachComponent);
+    }
+
+    if (auto PickupIndex = GetWorld()->GetSubsystem<UUR_PickupIndexSubsystem>())
+    {
+        PickupIndex->UnregisterItem(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
 void AUR_PickupFactory::Reset()
 {
     if (HasAuthority())
@@ -143,10 +173,7 @@ void AUR_PickupFactory::Reset()
             Pickup->Destroy();
         }
 
-        if (auto World = GetWorld())
-        {
-            World->GetTimerManager().ClearTimer(RespawnTimerHandle);
-        }
+        CancelRespawnEvents();
 
         BeginRespawnTimer(InitialSpawnDelay);
     }
@@ -158,28 +185,57 @@ void AUR_PickupFactory::Reset()
 
 void AUR_PickupFactory::BeginRespawnTimer(float InRespawnTime)
 {
-    if (InRespawnTime > 0.f)
+    // NOTE: Zero respawn time still goes through the scheduler, which fires it on next update.
+    // This forces a frame to avoid pickup-loop problem.
+    // TODO: Might want to come up with something better, as this will spam network heavily.
+    // Eg. instant respawn under player's feet but without giving it to him unless he goes out and back in.
+    // But that's harder to do with pickup as a separate class.
+    // Also must consider when multiple players are standing on it.
+    FlushNetDormancy();
+    NextRespawnTime = UUR_PickupRespawnSubsystem::GetServerTime(this) + FMath::Max(InRespawnTime, 0.f);
+    ScheduleRespawnEvents();
+}
+
+void AUR_PickupFactory::ScheduleRespawnEvents()
+{
+    CancelRespawnEvents();
+
+    auto RespawnSubsystem = GetWorld()->GetSubsystem<UUR_PickupRespawnSubsystem>();
+    if (!RespawnSubsystem || NextRespawnTime <= 0.0)
     {
-        const float PreRespawnTime = InRespawnTime - PreRespawnEffectDuration;
-        if (PreRespawnTime > 0.f)
-        {
-            GetWorld()->GetTimerManager().SetTimer(RespawnTimerHandle, this, &ThisClass::PreRespawnTimer, PreRespawnTime, false);
-        }
-        else
-        {
-            MulticastWillRespawn();
-        }
+        return;
+    }
+
+    // No respawn effects for instant spawns (ie. initial spawn without delay).
+    // Late joiners within the pre-respawn window still get the effect, slightly late.
+    if (NextRespawnTime > UUR_PickupRespawnSubsystem::GetServerTime(this))
+    {
+        PreRespawnHandle = RespawnSubsystem->Schedule(NextRespawnTime - PreRespawnEffectDuration, FSimpleDelegate::CreateUObject(this, &ThisClass::PreRespawnTimer));
+    }
+
+    // Scheduled after pre-respawn, so they fire in order when PreRespawnEffectDuration is zero
+    if (HasAuthority())
+    {
+        RespawnHandle = RespawnSubsystem->Schedule(NextRespawnTime, FSimpleDelegate::CreateUObject(this, &ThisClass::RespawnTimer));
     }
-    else
+}
+
+void AUR_PickupFactory::CancelRespawnEvents()
+{
+    if (auto RespawnSubsystem = GetWorld()->GetSubsystem<UUR_PickupRespawnSubsystem>())
+    {
+        RespawnSubsystem->Cancel(PreRespawnHandle);
+        RespawnSubsystem->Cancel(RespawnHandle);
+    }
+}
+
+float AUR_PickupFactory::GetRespawnTimeRemaining() const
+{
+    if (Pickup || NextRespawnTime <= 0.0)
     {
-        // Force a frame to avoid pickup-loop problem
-        GetWorld()->GetTimerManager().ClearTimer(RespawnTimerHandle);
-        RespawnTimerHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &ThisClass::RespawnTimer);
-        // TODO: Might want to come up with something better, as this will spam network heavily.
-        // Eg. instant respawn under player's feet but without giving it to him unless he goes out and back in.
-        // But that's harder to do with pickup as a separate class.
-        // Also must consider when multiple players are standing on it.
+        return 0.f;
     }
+    return FMath::Max(0.f, static_cast<float>(NextRespawnTime - UUR_PickupRespawnSubsystem::GetServerTime(this)));
 }
 
 void AUR_PickupFactory::SpawnPickup()
@@ -232,6 +288,11 @@ void AUR_PickupFactory::SpawnPickup()
         // Attaching may trigger overlap + destroy
         if (!Pickup)
             return;
+
+        if (auto AnimationSubsystem = GetWorld()->GetSubsystem<UUR_PickupAnimationSubsystem>())
+        {
+            AnimationSubsystem->NotifyAttachmentChanged(AttachComponent);
+        }
     }
 
     // Blueprint do scene adjustements here
@@ -243,6 +304,20 @@ void AUR_PickupFactory::OnRep_PickupClass()
     // It may happen that Pickup is replicated before PickupClass,
     // In which case we may want to refresh whatever preview we have.
     ShowPickupAvailable(Pickup ? true : false);
+
+    if (HasActorBegunPlay())
+    {
+        RegisterInPickupIndex();
+    }
+}
+
+void AUR_PickupFactory::RegisterInPickupIndex()
+{
+    if (auto PickupIndex = GetWorld()->GetSubsystem<UUR_PickupIndexSubsystem>())
+    {
+        const TSubclassOf<AUR_Pickup> ClassForTags = GetPickupClass();
+        PickupIndex->RegisterItem(this, ClassForTags ? ClassForTags.GetDefaultObject()->GameplayTags : FGameplayTagContainer(), Pickup != nullptr);
+    }
 }
 
 void AUR_PickupFactory::OnRep_Pickup()
@@ -251,6 +326,16 @@ void AUR_PickupFactory::OnRep_Pickup()
     {
         ShowPickupAvailable(Pickup ? true : false);
     }
+
+    if (auto PickupIndex = GetWorld()->GetSubsystem<UUR_PickupIndexSubsystem>())
+    {
+        PickupIndex->SetItemAvailable(this, Pickup != nullptr);
+    }
+}
+
+void AUR_PickupFactory::OnRep_NextRespawnTime()
+{
+    ScheduleRespawnEvents();
 }
 
 void AUR_PickupFactory::OnPickupPickedUp_Implementation(AUR_Pickup* Other, APawn* Recipient)
@@ -264,28 +349,11 @@ void AUR_PickupFactory::OnPickupPickedUp_Implementation(AUR_Pickup* Other, APawn
 }
 
 void AUR_PickupFactory::PreRespawnTimer()
-{
-    MulticastWillRespawn();
-}
-
-void AUR_PickupFactory::MulticastWillRespawn_Implementation()
 {
     if (!IsNetMode(NM_DedicatedServer))
     {
         PlayRespawnEffects();
     }
-
-    if (HasAuthority())
-    {
-        if (PreRespawnEffectDuration > 0.f)
-        {
-            GetWorld()->GetTimerManager().SetTimer(RespawnTimerHandle, this, &AUR_PickupFactory::RespawnTimer, PreRespawnEffectDuration, false);
-        }
-        else
-        {
-            RespawnTimer();
-        }
-    }
 }
 
 void AUR_PickupFactory::PlayRespawnEffects_Implementation()
@@ -309,74 +377,28 @@ void AUR_PickupFactory::SetPickup(AUR_Pickup* NewPickup)
 {
     if (NewPickup != this->Pickup)
     {
-        this->Pickup = NewPickup;
-        OnRep_Pickup();
-    }
-}
-
-void AUR_PickupFactory::OnPickupDestroyed(AActor* DestroyedActor)
-{
-    if (DestroyedActor == Pickup)
-    {
-        SetPickup(nullptr);
-    }
-}
-
-/////////////////////////////////////////////////////////////////////////////////////////////////
-
-void AUR_PickupFactory::Tick(float DeltaTime)
-{
-    Super::Tick(DeltaTime);
-
-    if (!ShouldSkipTick())
-    {
-        if (RotationRate > 0.0f)
+        if (HasAuthority())
         {
-            AttachComponent->AddLocalRotation(FRotator(0.0f, RotationRate * DeltaTime, 0.0f));
+            FlushNetDormancy();
         }
 
-        if (BobbingHeight > 0.0f)
+        this->Pickup = NewPickup;
+        OnRep_Pickup();
+
+        if (HasAuthority())
         {
-            FVector Loc(InitialRelativeLocation);
-            Loc.Z += BobbingHeight * FMath::Sin(BobbingSpeed * PI * GetWorld()->TimeSeconds);
-            AttachComponent->SetRelativeLocation(Loc);
+            if (auto TacticalSubsystem = GetWorld()->GetSubsystem<UUR_AITacticalSubsystem>())
+            {
+                TacticalSubsystem->SetItemValue(this, Pickup ? AIDesirability : 0.f);
+            }
         }
     }
 }
 
-// See MovementComponent.cpp @ 329
-bool AUR_PickupFactory::ShouldSkipTick()
+void AUR_PickupFactory::OnPickupDestroyed(AActor* DestroyedActor)
 {
-    if (!AttachComponent || !AttachComponent->IsVisible())
-    {
-        return true;
-    }
-
-    const float RenderTimeThreshold = 0.41f;
-    UWorld* TheWorld = GetWorld();
-
-    if (const UPrimitiveComponent* PrimitiveComp = Cast<UPrimitiveComponent>(AttachComponent))
-    {
-        if (TheWorld->TimeSince(PrimitiveComp->GetLastRenderTime()) <= RenderTimeThreshold)
-        {
-            return false; // Rendered, don't skip it.
-        }
-    }
-
-    // Most components used with movement components don't actually render, so check attached children render times.
-    TArray<USceneComponent*> RotatingChildren;
-    AttachComponent->GetChildrenComponents(true, RotatingChildren);
-    for (auto Child : RotatingChildren)
+    if (DestroyedActor == Pickup)
     {
-        if (const UPrimitiveComponent* PrimitiveChild = Cast<UPrimitiveComponent>(Child))
-        {
-            if (PrimitiveChild->IsRegistered() && TheWorld->TimeSince(PrimitiveChild->GetLastRenderTime()) <= RenderTimeThreshold)
-            {
-                return false; // Rendered, don't skip it.
-            }
-        }
+        SetPickup(nullptr);
     }
-
-    // No children were recently rendered, safely skip the update.
-    return true;
 }
@@ -7,6 +7,8 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 
+#include "UR_PickupRespawnSubsystem.h"
+
 #include "UR_PickupFactory.generated.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -87,7 +89,15 @@ public:
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
     float PreRespawnEffectDuration;
 
-    FTimerHandle RespawnTimerHandle;
+    /**
+    * Server world time at which the pickup respawns.
+    * Replicated once per respawn cycle, clients compute the pre-respawn event and countdowns from it.
+    */
+    UPROPERTY(Transient, BlueprintReadOnly, ReplicatedUsing = OnRep_NextRespawnTime)
+    double NextRespawnTime;
+
+    FUR_PickupRespawnHandle PreRespawnHandle;
+    FUR_PickupRespawnHandle RespawnHandle;
 
     /**
     * Initial spawn delay. For powerups.
@@ -105,6 +115,13 @@ public:
     UPROPERTY(EditAnywhere, ReplicatedUsing = OnRep_PickupClass)
     TSubclassOf<AUR_Pickup> PickupClass;
 
+    /**
+    * How much bots value this item, registered in the AI influence map while the pickup is available.
+    * 0 = bots don't consider it as a goal.
+    */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI")
+    float AIDesirability;
+
     UPROPERTY(EditDefaultsOnly, BlueprintReadWrite)
     UFXSystemAsset* RespawnEffect;
 
@@ -121,14 +138,22 @@ protected:
     virtual void OnConstruction(const FTransform& Transform) override;
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void Reset() override;
-    virtual void Tick(float DeltaTime) override;
-    virtual bool ShouldSkipTick();
 
     UFUNCTION()
     virtual void OnRep_PickupClass();
     UFUNCTION()
     virtual void OnRep_Pickup();
+    UFUNCTION()
+    virtual void OnRep_NextRespawnTime();
+
+    /** Schedule pre-respawn (and respawn on authority) events from NextRespawnTime */
+    virtual void ScheduleRespawnEvents();
+    virtual void CancelRespawnEvents();
+
+    /** Add or refresh this factory in the pickup index (location, tags of pickup class, availability) */
+    virtual void RegisterInPickupIndex();
 
 public:
 
@@ -196,21 +221,18 @@ public:
     void OnPickupPickedUp(AUR_Pickup* Other, APawn* Recipient);
 
     /**
-    * Authority only.
-    * Only when RespawnTime - PreRespawnEffectDuration > 0.
-    * Broadcasts MulticastWillRespawn.
+    * Server / client.
+    * Triggered by the respawn scheduler at NextRespawnTime minus PreRespawnEffectDuration.
+    * On clients this is computed locally from the replicated NextRespawnTime, no multicast involved.
     */
-    UFUNCTION(BlueprintAuthorityOnly)
     virtual void PreRespawnTimer();
 
     /**
-    * Broadcast when pickup is about to respawn (RespawnTime minus PreRespawnEffectDuration).
-    *
-    * Unreliable as we don't want this to force a full actor replication when not relevant.
-    * That might cause missing respawn effects in some cases. TBD.
+    * Seconds left until the pickup respawns. 0 if available or not scheduled.
+    * Computed locally from the replicated NextRespawnTime, usable for HUD countdowns.
     */
-    UFUNCTION(NetMulticast, Unreliable)
-    void MulticastWillRespawn();
+    UFUNCTION(BlueprintPure)
+    float GetRespawnTimeRemaining() const;
 
     /**
     * Client only. Triggered at RespawnTime minus PreRespawnEffectDuration.
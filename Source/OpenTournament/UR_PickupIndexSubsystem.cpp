@@ -0,0 +1,302 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_PickupIndexSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+#include "UR_LogChannels.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_PickupIndexSubsystem)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT Pickup Index"), STATGROUP_OTPickupIndex, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Nearest Items Query"), STAT_PickupIndexNearest, STATGROUP_OTPickupIndex);
+DECLARE_CYCLE_STAT(TEXT("Items In Radius Query"), STAT_PickupIndexRadius, STATGROUP_OTPickupIndex);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Indexed Items"), STAT_PickupIndexItems, STATGROUP_OTPickupIndex);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace OTConsoleVariables
+{
+    static FAutoConsoleCommandWithWorldAndArgs CmdValidatePickupIndex(
+        TEXT("OT.PickupIndex.Validate"),
+        TEXT("Compare pickup index queries against brute force, and time both. Usage: OT.PickupIndex.Validate [NumQueries]"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (auto PickupIndex = World ? World->GetSubsystem<UUR_PickupIndexSubsystem>() : nullptr)
+            {
+                PickupIndex->Validate(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000);
+            }
+        }));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UUR_PickupIndexSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_PickupIndexSubsystem::RegisterItem(AActor* Item, const FGameplayTagContainer& Tags, bool bAvailable)
+{
+    if (!Item)
+    {
+        return;
+    }
+
+    UnregisterItem(Item);
+
+    FItemEntry Entry;
+    Entry.Actor = Item;
+    Entry.Location = Item->GetActorLocation();
+    Entry.Tags = Tags;
+    Entry.Cell = GetCell(Entry.Location);
+    Entry.bAvailable = bAvailable;
+
+    const int32 Index = Entries.Add(Entry);
+    EntryIndices.Add(Item, Index);
+    Cells.FindOrAdd(Entry.Cell).Add(Index);
+
+    MinCell = FIntPoint(FMath::Min(MinCell.X, Entry.Cell.X), FMath::Min(MinCell.Y, Entry.Cell.Y));
+    MaxCell = FIntPoint(FMath::Max(MaxCell.X, Entry.Cell.X), FMath::Max(MaxCell.Y, Entry.Cell.Y));
+
+    SET_DWORD_STAT(STAT_PickupIndexItems, Entries.Num());
+}
+
+void UUR_PickupIndexSubsystem::UnregisterItem(AActor* Item)
+{
+    int32 Index;
+    if (EntryIndices.RemoveAndCopyValue(Item, Index))
+    {
+        if (TArray<int32>* Cell = Cells.Find(Entries[Index].Cell))
+        {
+            Cell->RemoveSingleSwap(Index);
+        }
+        Entries.RemoveAt(Index);
+
+        SET_DWORD_STAT(STAT_PickupIndexItems, Entries.Num());
+    }
+}
+
+void UUR_PickupIndexSubsystem::SetItemAvailable(AActor* Item, bool bAvailable)
+{
+    if (const int32* Index = EntryIndices.Find(Item))
+    {
+        Entries[*Index].bAvailable = bAvailable;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_PickupIndexSubsystem::GatherCell(const FIntPoint& Cell, const FVector& Origin, const FGameplayTag& Tag, bool bOnlyAvailable, TArray<TPair<double, int32>>& OutCandidates) const
+{
+    if (const TArray<int32>* Indices = Cells.Find(Cell))
+    {
+        for (const int32 Index : *Indices)
+        {
+            const FItemEntry& Entry = Entries[Index];
+            if (Matches(Entry, Tag, bOnlyAvailable))
+            {
+                OutCandidates.Emplace(FVector::DistSquared(Origin, Entry.Location), Index);
+            }
+        }
+    }
+}
+
+void UUR_PickupIndexSubsystem::FindNearestItems(const FVector& Origin, int32 Count, FGameplayTag Tag, bool bOnlyAvailable, TArray<AActor*>& OutItems) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_PickupIndexNearest);
+
+    OutItems.Reset();
+    if (Count <= 0 || Entries.Num() == 0)
+    {
+        return;
+    }
+
+    const FIntPoint Center = GetCell(Origin);
+    const int32 MaxRing = FMath::Max(
+        FMath::Max(FMath::Abs(Center.X - MinCell.X), FMath::Abs(MaxCell.X - Center.X)),
+        FMath::Max(FMath::Abs(Center.Y - MinCell.Y), FMath::Abs(MaxCell.Y - Center.Y)));
+
+    TArray<TPair<double, int32>, TInlineAllocator<32>> Candidates;
+    TArray<TPair<double, int32>> RingCandidates;
+    const auto ByDistance = [](const TPair<double, int32>& A, const TPair<double, int32>& B) { return A.Key < B.Key; };
+
+    // Visit rings of cells around the origin cell.
+    // Items in ring R+1 are at least R*CellSize away, so we can stop once we have Count items closer than that.
+    for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+    {
+        RingCandidates.Reset();
+        if (Ring == 0)
+        {
+            GatherCell(Center, Origin, Tag, bOnlyAvailable, RingCandidates);
+        }
+        else
+        {
+            for (int32 d = -Ring; d <= Ring; d++)
+            {
+                GatherCell(Center + FIntPoint(d, -Ring), Origin, Tag, bOnlyAvailable, RingCandidates);
+                GatherCell(Center + FIntPoint(d, Ring), Origin, Tag, bOnlyAvailable, RingCandidates);
+            }
+            for (int32 d = -Ring + 1; d <= Ring - 1; d++)
+            {
+                GatherCell(Center + FIntPoint(-Ring, d), Origin, Tag, bOnlyAvailable, RingCandidates);
+                GatherCell(Center + FIntPoint(Ring, d), Origin, Tag, bOnlyAvailable, RingCandidates);
+            }
+        }
+
+        if (RingCandidates.Num() > 0)
+        {
+            Candidates.Append(RingCandidates);
+            Candidates.Sort(ByDistance);
+            if (Candidates.Num() > Count)
+            {
+                Candidates.SetNum(Count, false);
+            }
+        }
+
+        if (Candidates.Num() == Count && Candidates.Last().Key <= FMath::Square(Ring * (double)CellSize))
+        {
+            break;
+        }
+    }
+
+    OutItems.Reserve(Candidates.Num());
+    for (const TPair<double, int32>& Candidate : Candidates)
+    {
+        OutItems.Add(Entries[Candidate.Value].Actor.Get());
+    }
+}
+
+AActor* UUR_PickupIndexSubsystem::FindNearestItem(const FVector& Origin, FGameplayTag Tag, bool bOnlyAvailable) const
+{
+    TArray<AActor*> Items;
+    FindNearestItems(Origin, 1, Tag, bOnlyAvailable, Items);
+    return Items.Num() > 0 ? Items[0] : nullptr;
+}
+
+void UUR_PickupIndexSubsystem::FindItemsInRadius(const FVector& Origin, float Radius, FGameplayTag Tag, bool bOnlyAvailable, TArray<AActor*>& OutItems) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_PickupIndexRadius);
+
+    OutItems.Reset();
+    if (Radius <= 0.f || Entries.Num() == 0)
+    {
+        return;
+    }
+
+    const FIntPoint From = GetCell(Origin - FVector(Radius));
+    const FIntPoint To = GetCell(Origin + FVector(Radius));
+    const double RadiusSq = FMath::Square((double)Radius);
+
+    TArray<TPair<double, int32>, TInlineAllocator<32>> Candidates;
+    TArray<TPair<double, int32>> CellCandidates;
+    for (int32 X = FMath::Max(From.X, MinCell.X); X <= FMath::Min(To.X, MaxCell.X); X++)
+    {
+        for (int32 Y = FMath::Max(From.Y, MinCell.Y); Y <= FMath::Min(To.Y, MaxCell.Y); Y++)
+        {
+            CellCandidates.Reset();
+            GatherCell(FIntPoint(X, Y), Origin, Tag, bOnlyAvailable, CellCandidates);
+            for (const TPair<double, int32>& Candidate : CellCandidates)
+            {
+                if (Candidate.Key <= RadiusSq)
+                {
+                    Candidates.Add(Candidate);
+                }
+            }
+        }
+    }
+
+    Candidates.Sort([](const TPair<double, int32>& A, const TPair<double, int32>& B) { return A.Key < B.Key; });
+
+    OutItems.Reserve(Candidates.Num());
+    for (const TPair<double, int32>& Candidate : Candidates)
+    {
+        OutItems.Add(Entries[Candidate.Value].Actor.Get());
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_PickupIndexSubsystem::BruteForceNearest(const FVector& Origin, int32 Count, const FGameplayTag& Tag, bool bOnlyAvailable, TArray<AActor*>& OutItems) const
+{
+    TArray<TPair<double, int32>> Candidates;
+    for (auto It = Entries.CreateConstIterator(); It; ++It)
+    {
+        if (Matches(*It, Tag, bOnlyAvailable))
+        {
+            Candidates.Emplace(FVector::DistSquared(Origin, It->Location), It.GetIndex());
+        }
+    }
+    Candidates.Sort([](const TPair<double, int32>& A, const TPair<double, int32>& B) { return A.Key < B.Key; });
+
+    OutItems.Reset();
+    for (int32 i = 0; i < FMath::Min(Count, Candidates.Num()); i++)
+    {
+        OutItems.Add(Entries[Candidates[i].Value].Actor.Get());
+    }
+}
+
+void UUR_PickupIndexSubsystem::Validate(int32 NumQueries) const
+{
+    if (Entries.Num() == 0 || NumQueries <= 0)
+    {
+        UE_LOG(LogGame, Log, TEXT("PickupIndex: nothing to validate (%i items)"), Entries.Num());
+        return;
+    }
+
+    const FVector BoundsMin(MinCell.X * CellSize, MinCell.Y * CellSize, 0.f);
+    const FVector BoundsMax((MaxCell.X + 1) * CellSize, (MaxCell.Y + 1) * CellSize, 0.f);
+
+    TArray<FVector> Origins;
+    for (int32 i = 0; i < NumQueries; i++)
+    {
+        Origins.Emplace(FMath::RandRange(BoundsMin.X, BoundsMax.X), FMath::RandRange(BoundsMin.Y, BoundsMax.Y), 0.f);
+    }
+
+    const int32 Count = 4;
+    int32 NumMismatches = 0;
+    TArray<AActor*> Indexed;
+    TArray<AActor*> Brute;
+
+    const double IndexStart = FPlatformTime::Seconds();
+    for (const FVector& Origin : Origins)
+    {
+        FindNearestItems(Origin, Count, FGameplayTag(), false, Indexed);
+    }
+    const double IndexTime = FPlatformTime::Seconds() - IndexStart;
+
+    const double BruteStart = FPlatformTime::Seconds();
+    for (const FVector& Origin : Origins)
+    {
+        BruteForceNearest(Origin, Count, FGameplayTag(), false, Brute);
+    }
+    const double BruteTime = FPlatformTime::Seconds() - BruteStart;
+
+    // Check both all items and available items only
+    for (const bool bOnlyAvailable : { false, true })
+    {
+        for (const FVector& Origin : Origins)
+        {
+            FindNearestItems(Origin, Count, FGameplayTag(), bOnlyAvailable, Indexed);
+            BruteForceNearest(Origin, Count, FGameplayTag(), bOnlyAvailable, Brute);
+            // Compare distances rather than actors, equidistant items may come in any order
+            bool bMatch = (Indexed.Num() == Brute.Num());
+            for (int32 i = 0; bMatch && i < Indexed.Num(); i++)
+            {
+                bMatch = FMath::IsNearlyEqual(FVector::Dist(Origin, Indexed[i]->GetActorLocation()), FVector::Dist(Origin, Brute[i]->GetActorLocation()), 0.1);
+            }
+            NumMismatches += bMatch ? 0 : 1;
+        }
+    }
+
+    UE_LOG(LogGame, Log, TEXT("PickupIndex: %i items, %i queries (k=%i): indexed %.3f ms, brute force %.3f ms, %i mismatches (all and available only)"),
+        Entries.Num(), NumQueries, Count, IndexTime * 1000.0, BruteTime * 1000.0, NumMismatches);
+}
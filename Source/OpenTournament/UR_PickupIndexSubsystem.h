@@ -0,0 +1,109 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UR_PickupIndexSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Spatial index of item locations (pickup factories, pickup bases), with their tags and availability.
+ *
+ * Items are bucketed in a 2D grid, which is enough for item placement in arena maps.
+ * Items register themselves, and update availability on pickup and respawn events.
+ *
+ * Answers "nearest available health/armor/weapon" style queries for bots, HUD and game logic,
+ * without scanning all pickup actors.
+ *
+ * Exists on server and clients. On clients, availability is as known locally.
+ */
+UCLASS(Config = Game)
+class OPENTOURNAMENT_API UUR_PickupIndexSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    //~UWorldSubsystem interface
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    //~End of UWorldSubsystem interface
+
+    /**
+    * Add an item to the index, or update it if already registered.
+    * Location is read from the actor, items are expected not to move.
+    */
+    void RegisterItem(AActor* Item, const FGameplayTagContainer& Tags, bool bAvailable);
+
+    void UnregisterItem(AActor* Item);
+
+    void SetItemAvailable(AActor* Item, bool bAvailable);
+
+    /**
+    * Find up to Count items nearest to Origin, sorted by distance.
+    * If Tag is valid, only items with a matching tag (hierarchical) are considered.
+    */
+    UFUNCTION(BlueprintCallable, Category = "Pickups")
+    void FindNearestItems(const FVector& Origin, int32 Count, FGameplayTag Tag, bool bOnlyAvailable, TArray<AActor*>& OutItems) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Pickups")
+    AActor* FindNearestItem(const FVector& Origin, FGameplayTag Tag, bool bOnlyAvailable) const;
+
+    /**
+    * Find all items within Radius of Origin, sorted by distance.
+    * If Tag is valid, only items with a matching tag (hierarchical) are considered.
+    */
+    UFUNCTION(BlueprintCallable, Category = "Pickups")
+    void FindItemsInRadius(const FVector& Origin, float Radius, FGameplayTag Tag, bool bOnlyAvailable, TArray<AActor*>& OutItems) const;
+
+    /** Size of grid cells. Should be in the order of typical query radius. */
+    UPROPERTY(Config)
+    float CellSize = 2048.f;
+
+    /**
+    * Compare query results against brute force, and time both.
+    * Backs the OT.PickupIndex.Validate console command.
+    */
+    void Validate(int32 NumQueries) const;
+
+protected:
+
+    struct FItemEntry
+    {
+        TWeakObjectPtr<AActor> Actor;
+        FVector Location;
+        FGameplayTagContainer Tags;
+        FIntPoint Cell;
+        bool bAvailable;
+    };
+
+    /** Sparse, so indices stored in cells remain valid */
+    TSparseArray<FItemEntry> Entries;
+
+    TMap<TObjectKey<AActor>, int32> EntryIndices;
+
+    TMap<FIntPoint, TArray<int32>> Cells;
+
+    /** Bounds of used cells, limits the k-nearest search */
+    FIntPoint MinCell = FIntPoint(MAX_int32, MAX_int32);
+    FIntPoint MaxCell = FIntPoint(MIN_int32, MIN_int32);
+
+    FIntPoint GetCell(const FVector& Location) const
+    {
+        return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+    }
+
+    static bool Matches(const FItemEntry& Entry, const FGameplayTag& Tag, bool bOnlyAvailable)
+    {
+        return Entry.Actor.IsValid() && (!bOnlyAvailable || Entry.bAvailable) && (!Tag.IsValid() || Entry.Tags.HasTag(Tag));
+    }
+
+    void GatherCell(const FIntPoint& Cell, const FVector& Origin, const FGameplayTag& Tag, bool bOnlyAvailable, TArray<TPair<double, int32>>& OutCandidates) const;
+
+    void BruteForceNearest(const FVector& Origin, int32 Count, const FGameplayTag& Tag, bool bOnlyAvailable, TArray<AActor*>& OutItems) const;
+};
@@ -0,0 +1,264 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_PickupRespawnSubsystem.h"
+
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+
+#include "UR_LogChannels.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_PickupRespawnSubsystem)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT Pickup Respawns"), STATGROUP_OTPickupRespawns, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Respawn Scheduler Update"), STAT_RespawnSchedulerUpdate, STATGROUP_OTPickupRespawns);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Scheduled Events"), STAT_RespawnScheduledEvents, STATGROUP_OTPickupRespawns);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Fired Events"), STAT_RespawnFiredEvents, STATGROUP_OTPickupRespawns);
+
+namespace OTConsoleVariables
+{
+    static FAutoConsoleCommandWithWorldAndArgs CmdPickupRespawnValidate(
+        TEXT("OT.PickupRespawn.Validate"),
+        TEXT("Schedule random respawn events and check their fire times and order. Optional arg: count (default 200)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (auto RespawnSubsystem = World ? World->GetSubsystem<UUR_PickupRespawnSubsystem>() : nullptr)
+            {
+                RespawnSubsystem->Validate(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 200);
+            }
+        }));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UUR_PickupRespawnSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UUR_PickupRespawnSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_PickupRespawnSubsystem, STATGROUP_Tickables);
+}
+
+double UUR_PickupRespawnSubsystem::GetServerTime(const UObject* WorldContextObject)
+{
+    if (const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr)
+    {
+        if (const AGameStateBase* GameState = World->GetGameState())
+        {
+            return GameState->GetServerWorldTimeSeconds();
+        }
+        return World->GetTimeSeconds();
+    }
+    return 0.0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+FUR_PickupRespawnHandle UUR_PickupRespawnSubsystem::Schedule(double ServerTime, FSimpleDelegate&& Callback)
+{
+    // Convert to local time, the heap must not depend on server time corrections
+    const double LocalTime = GetWorld()->GetTimeSeconds() + (ServerTime - GetServerTime(this));
+
+    // Skip 0, it is the invalid handle
+    if (++LastId == 0)
+    {
+        ++LastId;
+    }
+
+    Heap.HeapPush({ LocalTime, LastId, GFrameCounter, MoveTemp(Callback) });
+    PendingIds.Add(LastId);
+
+    SET_DWORD_STAT(STAT_RespawnScheduledEvents, PendingIds.Num());
+
+    return FUR_PickupRespawnHandle{ LastId };
+}
+
+void UUR_PickupRespawnSubsystem::Cancel(FUR_PickupRespawnHandle& Handle)
+{
+    if (Handle.IsValid())
+    {
+        PendingIds.Remove(Handle.Id);
+        Handle.Invalidate();
+
+        SET_DWORD_STAT(STAT_RespawnScheduledEvents, PendingIds.Num());
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_PickupRespawnSubsystem::Tick(float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_RespawnSchedulerUpdate);
+
+    const double Now = GetWorld()->GetTimeSeconds();
+
+    // Events scheduled this frame are left for next frame, wherever they were scheduled from
+    // (callbacks scheduling the next event, or overlaps during actor tick).
+    // Force a frame to avoid pickup-loop problem with zero respawn time.
+    const uint64 Frame = GFrameCounter;
+
+    TArray<FScheduledEvent, TInlineAllocator<8>> Deferred;
+    int32 NumFired = 0;
+
+    while (Heap.Num() > 0 && Heap.HeapTop().Time <= Now)
+    {
+        FScheduledEvent Event;
+        Heap.HeapPop(Event, false);
+
+        if (Event.Frame == Frame)
+        {
+            Deferred.Add(MoveTemp(Event));
+        }
+        else if (PendingIds.Remove(Event.Id) > 0)
+        {
+            Event.Callback.ExecuteIfBound();
+            NumFired++;
+        }
+    }
+
+    for (FScheduledEvent& Event : Deferred)
+    {
+        Heap.HeapPush(MoveTemp(Event));
+    }
+
+    INC_DWORD_STAT_BY(STAT_RespawnFiredEvents, NumFired);
+    SET_DWORD_STAT(STAT_RespawnScheduledEvents, PendingIds.Num());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_PickupRespawnSubsystem::Validate(int32 Count)
+{
+    if (Count <= 0)
+    {
+        return;
+    }
+
+    struct FValidationEvent
+    {
+        FUR_PickupRespawnHandle Handle;
+        /** Local world time the event is due */
+        double DueTime = 0.0;
+        bool bCancelled = false;
+        int32 NumFired = 0;
+        double FireTime = 0.0;
+        /** World time of the previous frame when fired */
+        double PreviousFrameTime = 0.0;
+        uint64 FireFrame = 0;
+    };
+    struct FValidation
+    {
+        TArray<FValidationEvent> Events;
+        /** Event indices in fire order */
+        TArray<int32> FireOrder;
+        uint64 ScheduleFrame = 0;
+        double EndTime = 0.0;
+    };
+    TSharedRef<FValidation> Validation = MakeShared<FValidation>();
+    Validation->ScheduleFrame = GFrameCounter;
+
+    UWorld* World = GetWorld();
+    const double Now = World->GetTimeSeconds();
+    const double ServerNow = GetServerTime(this);
+
+    // Delays cover past events, zero respawn time, same-time ties and regular respawns
+    FRandomStream Random(1337);
+    Validation->Events.SetNum(Count);
+    for (int32 i = 0; i < Count; i++)
+    {
+        const float Delay = (i % 10 == 0) ? -1.f : (i % 10 == 1) ? 0.f : (i % 10 == 2) ? 1.f : Random.FRandRange(0.f, 3.f);
+        FValidationEvent& Event = Validation->Events[i];
+        Event.DueTime = Now + Delay;
+        Event.Handle = Schedule(ServerNow + Delay, FSimpleDelegate::CreateLambda([Validation, World, i]()
+        {
+            FValidationEvent& Fired = Validation->Events[i];
+            Fired.NumFired++;
+            Fired.FireTime = World->GetTimeSeconds();
+            Fired.PreviousFrameTime = Fired.FireTime - World->GetDeltaSeconds();
+            Fired.FireFrame = GFrameCounter;
+            Validation->FireOrder.Add(i);
+        }));
+        Validation->EndTime = FMath::Max(Validation->EndTime, Event.DueTime);
+    }
+    for (int32 i = 3; i < Count; i += 7)
+    {
+        Cancel(Validation->Events[i].Handle);
+        Validation->Events[i].bCancelled = true;
+    }
+
+    TWeakObjectPtr<UWorld> WeakWorld(World);
+    FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Validation, WeakWorld](float DeltaTime)
+    {
+        const UWorld* World = WeakWorld.Get();
+        if (!World)
+        {
+            return false;
+        }
+        // Leave a margin for the last events to fire
+        if (World->GetTimeSeconds() < Validation->EndTime + 0.5)
+        {
+            return true;
+        }
+
+        // Local due times are derived from server time and back, allow for rounding
+        const double Epsilon = 0.001;
+        int32 NumErrors = 0;
+        for (int32 i = 0; i < Validation->Events.Num(); i++)
+        {
+            const FValidationEvent& Event = Validation->Events[i];
+            if (Event.bCancelled)
+            {
+                if (Event.NumFired > 0)
+                {
+                    UE_LOG(LogGame, Warning, TEXT("PickupRespawn: cancelled event %i fired"), i);
+                    NumErrors++;
+                }
+                continue;
+            }
+            if (Event.NumFired != 1)
+            {
+                UE_LOG(LogGame, Warning, TEXT("PickupRespawn: event %i fired %i times"), i, Event.NumFired);
+                NumErrors++;
+                continue;
+            }
+            if (Event.FireFrame <= Validation->ScheduleFrame)
+            {
+                UE_LOG(LogGame, Warning, TEXT("PickupRespawn: event %i fired in the frame it was scheduled"), i);
+                NumErrors++;
+            }
+            if (Event.FireTime < Event.DueTime - Epsilon)
+            {
+                UE_LOG(LogGame, Warning, TEXT("PickupRespawn: event %i fired %.3f s early"), i, Event.DueTime - Event.FireTime);
+                NumErrors++;
+            }
+            // Must fire in the first frame it is due, except when deferred out of the scheduling frame
+            else if (Event.PreviousFrameTime > Event.DueTime + Epsilon && Event.FireFrame != Validation->ScheduleFrame + 1)
+            {
+                UE_LOG(LogGame, Warning, TEXT("PickupRespawn: event %i fired %.3f s late"), i, Event.FireTime - Event.DueTime);
+                NumErrors++;
+            }
+        }
+
+        // Events firing in the same frame must follow their due time, then scheduling order
+        for (int32 j = 1; j < Validation->FireOrder.Num(); j++)
+        {
+            const FValidationEvent& Previous = Validation->Events[Validation->FireOrder[j - 1]];
+            const FValidationEvent& Current = Validation->Events[Validation->FireOrder[j]];
+            if (Previous.FireFrame == Current.FireFrame
+                && (Previous.DueTime > Current.DueTime || (Previous.DueTime == Current.DueTime && Validation->FireOrder[j - 1] > Validation->FireOrder[j])))
+            {
+                UE_LOG(LogGame, Warning, TEXT("PickupRespawn: event %i fired before event %i"), Validation->FireOrder[j - 1], Validation->FireOrder[j]);
+                NumErrors++;
+            }
+        }
+
+        UE_LOG(LogGame, Log, TEXT("PickupRespawn: validated %i events, %i errors"), Validation->Events.Num(), NumErrors);
+        return false;
+    }));
+}
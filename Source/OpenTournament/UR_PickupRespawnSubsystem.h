@@ -0,0 +1,99 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UR_PickupRespawnSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Handle to an event scheduled in UUR_PickupRespawnSubsystem.
+ */
+struct FUR_PickupRespawnHandle
+{
+    uint32 Id = 0;
+
+    bool IsValid() const { return Id != 0; }
+    void Invalidate() { Id = 0; }
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Central scheduler for pickup respawn events.
+ *
+ * Instead of every pickup running its own pre-respawn and respawn timers,
+ * all deadlines go into a single min-heap which is popped once per frame.
+ *
+ * Exists on both server and clients.
+ * Server uses it to drive actual respawns, clients use it for cosmetic pre-respawn events,
+ * computed from a replicated respawn timestamp (see AUR_PickupFactory::NextRespawnTime).
+ */
+UCLASS()
+class OPENTOURNAMENT_API UUR_PickupRespawnSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    //~UWorldSubsystem interface
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    //~End of UWorldSubsystem interface
+
+    //~FTickableGameObject interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    //~End of FTickableGameObject interface
+
+    /**
+    * Schedule an event at given server world time.
+    * Events due in the past fire on next update, never in the frame they were scheduled.
+    */
+    FUR_PickupRespawnHandle Schedule(double ServerTime, FSimpleDelegate&& Callback);
+
+    /** Cancel a scheduled event and invalidate the handle. Safe to call with an invalid or expired handle. */
+    void Cancel(FUR_PickupRespawnHandle& Handle);
+
+    bool IsScheduled(const FUR_PickupRespawnHandle& Handle) const
+    {
+        return PendingIds.Contains(Handle.Id);
+    }
+
+    /** Server world time, as seen by the local game state */
+    static double GetServerTime(const UObject* WorldContextObject);
+
+    /**
+    * Schedule random events (some due in the past, some cancelled), then check when and in which order they fired.
+    * Reports once the last event is due. Backs the OT.PickupRespawn.Validate console command.
+    */
+    void Validate(int32 Count);
+
+protected:
+
+    struct FScheduledEvent
+    {
+        /** Local world time */
+        double Time;
+        uint32 Id;
+        /** GFrameCounter when scheduled, the event does not fire before next frame */
+        uint64 Frame;
+        FSimpleDelegate Callback;
+
+        bool operator<(const FScheduledEvent& Other) const
+        {
+            return Time < Other.Time || (Time == Other.Time && Id < Other.Id);
+        }
+    };
+
+    TArray<FScheduledEvent> Heap;
+
+    /** Ids of events not fired nor cancelled yet. Cancelled events are dropped lazily when they reach the top of the heap. */
+    TSet<uint32> PendingIds;
+
+    uint32 LastId = 0;
+};
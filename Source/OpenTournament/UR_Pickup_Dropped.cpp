@@ -8,7 +8,9 @@
 #include "Engine/World.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
-#include "TimerManager.h"
+
+#include "UR_DroppedPickupSubsystem.h"
+#include "UR_PickupRespawnSubsystem.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -30,77 +32,184 @@ AUR_Pickup_Dropped::AUR_Pickup_Dropped(const FObjectInitializer& ObjectInitializ
     ProjectileMovementComponent->OnProjectileStop.AddDynamic(this, &ThisClass::OnProjectileStop);
 
     InitialLifeSpan = 10.f;
-    RemainingLifeSpan = -1;
     ExpireEffectDuration = 2.f;
     RotationRate = 0.f;
 
-    PrimaryActorTick.bStartWithTickEnabled = false;
-    PrimaryActorTick.bCanEverTick = true;
+    // Expire animation is handled by UUR_DroppedPickupSubsystem
+    PrimaryActorTick.bCanEverTick = false;
 }
 
 void AUR_Pickup_Dropped::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    DOREPLIFETIME_CONDITION(ThisClass, RemainingLifeSpan, COND_InitialOnly);
+    DOREPLIFETIME_CONDITION(ThisClass, DropState, COND_None);
 }
 
 void AUR_Pickup_Dropped::BeginPlay()
 {
     Super::BeginPlay();
 
-    CreatedAt = GetWorld()->GetTimeSeconds();
+    // Lifespan is managed by the subsystem, don't let the engine destroy us
+    DropLifeSpan = InitialLifeSpan;
+    SetLifeSpan(0.f);
+
+    if (HasAuthority())
+    {
+        StartDrop();
+    }
+    else
+    {
+        // Careful, RepNotify can trigger just before or just after BeginPlay.
+        ApplyDropState();
+    }
+}
+
+void AUR_Pickup_Dropped::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (auto DroppedPickupSubsystem = GetWorld()->GetSubsystem<UUR_DroppedPickupSubsystem>())
+    {
+        DroppedPickupSubsystem->UnregisterDroppedPickup(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
 
-    if (HasAuthority() && InitialLifeSpan > 0)
+bool AUR_Pickup_Dropped::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+    // Pooled pickups are hidden without collision, which the default check treats as irrelevant.
+    // Keep them relevant, so clients keep the actor and its dormant channel for the next drop.
+    if (HasActorBegunPlay() && !IsDropped())
     {
-        RemainingLifeSpan = InitialLifeSpan;
-
-        // Update sparsely
-        GetWorldTimerManager().SetTimer(RefreshRemainingLifeSpanTimerHandle, this, &AUR_Pickup_Dropped::RefreshRemainingLifeSpan, 0.5f, true);
-        /**
-        * Ideally we should update the variable whenever the actor becomes relevant to a new client and is about to replicate initially.
-        * Unfortunately there is no such event, so we have to update it on a tick or timer basis :(
-        */
+        return IsWithinNetRelevancyDistance(SrcLocation);
     }
+    return Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation);
+}
+
+void AUR_Pickup_Dropped::StartDrop()
+{
+    // Recycled instance, wake up for the new drop
+    if (NetDormancy > DORM_Awake)
+    {
+        SetNetDormancy(DORM_Awake);
+    }
+
+    CreatedAt = GetWorld()->GetTimeSeconds();
+
+    const auto CDOMovement = GetDefault<AUR_Pickup_Dropped>(GetClass())->ProjectileMovementComponent;
+    const FVector LocalDir = CDOMovement ? CDOMovement->Velocity.GetSafeNormal() : FVector::ForwardVector;
+
+    DropState.Location = GetActorLocation();
+    DropState.Velocity = GetActorRotation().RotateVector(LocalDir) * ProjectileMovementComponent->InitialSpeed;
+    DropState.DroppedAt = FMath::Max(UUR_PickupRespawnSubsystem::GetServerTime(this), UE_SMALL_NUMBER);
+    DropState.LifeSpan = DropLifeSpan;
 
-    if (RemainingLifeSpan > 0 && ExpireEffectDuration > 0)
+    ApplyDropState();
+}
+
+void AUR_Pickup_Dropped::ReturnToPool()
+{
+    DropState = FUR_DroppedPickupState();
+    ApplyDropState();
+
+    // Nothing changes while pooled. The channel goes dormant once clients have the pooled state,
+    // instead of closing, so clients don't destroy and spawn the actor again for every drop.
+    SetNetDormancy(DORM_DormantAll);
+}
+
+void AUR_Pickup_Dropped::OnRep_DropState()
+{
+    if (HasActorBegunPlay())
     {
-        GetWorldTimerManager().SetTimer(ExpireTimerHandle, this, &AUR_Pickup_Dropped::PlayExpire, FMath::Max(InitialLifeSpan - ExpireEffectDuration, 0.001f), false);
+        ApplyDropState();
     }
 }
 
-void AUR_Pickup_Dropped::RefreshRemainingLifeSpan()
+void AUR_Pickup_Dropped::ApplyDropState()
 {
-    // Send this for bRepInitial
-    RemainingLifeSpan = GetLifeSpan() - 0.25f;
+    auto DroppedPickupSubsystem = GetWorld()->GetSubsystem<UUR_DroppedPickupSubsystem>();
+
+    if (IsDropped())
+    {
+        // Reset expiration, in case this is a recycled instance
+        const auto CDO = GetDefault<AUR_Pickup_Dropped>(GetClass());
+        if (bExpiring)
+        {
+            SetActorScale3D(OriginalScale);
+        }
+        bExpiring = false;
+        RotationRate = CDO->RotationRate;
+        ExpireDuration = ExpireEffectDuration;
+
+        SetActorLocation(DropState.Location, false, nullptr, ETeleportType::ResetPhysics);
+        SetActorHiddenInGame(false);
+        SetActorEnableCollision(true);
+
+        ProjectileMovementComponent->SetUpdatedComponent(RootComponent);
+        ProjectileMovementComponent->Activate(true);
+        ProjectileMovementComponent->Velocity = DropState.Velocity;
+
+        if (DroppedPickupSubsystem)
+        {
+            DroppedPickupSubsystem->RegisterDroppedPickup(this);
+        }
+    }
+    else
+    {
+        // Hidden and without collision until reused
+        SetActorHiddenInGame(true);
+        SetActorEnableCollision(false);
+        ProjectileMovementComponent->StopMovementImmediately();
+        ProjectileMovementComponent->Deactivate();
+
+        if (DroppedPickupSubsystem)
+        {
+            DroppedPickupSubsystem->UnregisterDroppedPickup(this);
+        }
+    }
 }
 
 void AUR_Pickup_Dropped::OnProjectileStop(const FHitResult& ImpactResult)
 {
-    SetReplicateMovement(false);
+    // Resting, no need to keep a movement component ticking
+    ProjectileMovementComponent->Deactivate();
 }
 
 void AUR_Pickup_Dropped::PlayExpire()
 {
     bExpiring = true;
     OriginalScale = GetActorScale3D();
-    SetActorTickEnabled(true);
     // Speed up the effect if we don't have enough time left
-    ExpireEffectDuration = GetRemainingLifeSpan();
+    ExpireDuration = FMath::Max(GetRemainingLifeSpan(), UE_KINDA_SMALL_NUMBER);
 }
 
-void AUR_Pickup_Dropped::Tick(float DeltaTime)
+void AUR_Pickup_Dropped::DestroyPickup()
 {
-    if (bExpiring)
+    if (HasAuthority())
+    {
+        if (auto DroppedPickupSubsystem = GetWorld()->GetSubsystem<UUR_DroppedPickupSubsystem>())
+        {
+            DroppedPickupSubsystem->ReleaseDroppedPickup(this);
+            return;
+        }
+    }
+    else
     {
-        SetActorScale3D(FMath::VInterpConstantTo(GetActorScale3D(), FVector::ZeroVector, DeltaTime, OriginalScale.Size() / ExpireEffectDuration));
-        RotationRate += DeltaTime * (720.f / ExpireEffectDuration);
-        AddActorWorldRotation(DeltaTime * RotationRate * FRotator(0.f, 1.f, 0.f));
+        // Hide right away, server will follow up with the pooled state
+        SetActorHiddenInGame(true);
+        return;
     }
+
+    Super::DestroyPickup();
 }
 
 bool AUR_Pickup_Dropped::IsPickupPermitted(const AUR_Character* PickupCharacter) const
 {
+    if (!IsDropped())
+    {
+        return false;
+    }
+
     // If pickup was dropped by someone, do not allow owner to pick it during a delay (must be short enough to allow juggling tho)
     if ((AActor*)PickupCharacter == GetOwner() && GetWorld()->TimeSince(CreatedAt) < 0.8f)
     {
@@ -111,12 +220,9 @@ bool AUR_Pickup_Dropped::IsPickupPermitted(const AUR_Character* PickupCharacter)
 
 float AUR_Pickup_Dropped::GetRemainingLifeSpan()
 {
-    if (HasAuthority())
-    {
-        return GetLifeSpan();
-    }
-    else
+    if (!IsDropped() || DropState.LifeSpan <= 0.f)
     {
-        return FMath::Max(0.f, RemainingLifeSpan - GetWorld()->TimeSince(CreatedAt));
+        return 0.f;
     }
+    return FMath::Max(0.f, static_cast<float>(DropState.DroppedAt + DropState.LifeSpan - UUR_PickupRespawnSubsystem::GetServerTime(this)));
 }
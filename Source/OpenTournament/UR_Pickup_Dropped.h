@@ -5,6 +5,7 @@
 #pragma once
 
 #include "UR_Pickup.h"
+#include "Engine/NetSerialization.h"
 
 #include "UR_Pickup_Dropped.generated.h"
 
@@ -15,20 +16,58 @@ class UProjectileMovementComponent;
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 /**
- * 
+* Replicated state of a drop.
+* Dropped pickups are recycled, so this is sent again every time the actor is reused.
+*/
+USTRUCT()
+struct FUR_DroppedPickupState
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FVector_NetQuantize Location;
+
+    UPROPERTY()
+    FVector_NetQuantize10 Velocity;
+
+    /** Server world time of the drop. 0 while sitting in the pool. */
+    UPROPERTY()
+    double DroppedAt = 0.0;
+
+    UPROPERTY()
+    float LifeSpan = 0.f;
+
+    FUR_DroppedPickupState()
+        : Location(ForceInitToZero)
+        , Velocity(ForceInitToZero)
+    {}
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Pickup dropped in the world (eg. weapon dropped on death).
+ *
+ * Instances are recycled through UUR_DroppedPickupSubsystem,
+ * which also handles lifespan and expire animation for all of them.
+ * Prefer UUR_DroppedPickupSubsystem::AcquireDroppedPickup over spawning directly.
  */
 UCLASS(Blueprintable)
 class OPENTOURNAMENT_API AUR_Pickup_Dropped : public AUR_Pickup
 {
     GENERATED_BODY()
 
+    friend class UUR_DroppedPickupSubsystem;
+
 protected:
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual bool IsPickupPermitted(const AUR_Character* PickupCharacter) const override;
-    virtual void Tick(float DeltaTime) override;
-    
-public:	
+    virtual void DestroyPickup() override;
+    virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+
+public:
     AUR_Pickup_Dropped(const FObjectInitializer& ObjectInitializer);
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
@@ -40,23 +79,21 @@ public:
     UPROPERTY()
     float CreatedAt;
 
+    UPROPERTY(ReplicatedUsing = OnRep_DropState)
+    FUR_DroppedPickupState DropState;
+
+    UFUNCTION()
+    virtual void OnRep_DropState();
+
     /**
-    * Remaining life span.
-    * Updated sparsely (on server). Replicated initial-only for client.
+    * Life span of a drop. Taken from InitialLifeSpan,
+    * the actor itself never expires, UUR_DroppedPickupSubsystem recycles it instead.
     */
-    UPROPERTY(Replicated, BlueprintReadOnly)
-    float RemainingLifeSpan;
-    FTimerHandle RefreshRemainingLifeSpanTimerHandle;
+    float DropLifeSpan;
 
     UPROPERTY()
     float ExpireEffectDuration;
 
-    UPROPERTY(BlueprintReadOnly)
-    FTimerHandle ExpireTimerHandle;
-
-    UFUNCTION()
-    virtual void RefreshRemainingLifeSpan();
-
     UFUNCTION()
     virtual void OnProjectileStop(const FHitResult& ImpactResult);
 
@@ -68,10 +105,33 @@ public:
     bool bExpiring;
     FVector OriginalScale;
     float RotationRate;
+    float ExpireDuration;
 
     /**
     * Adjusted to work on both server & client
     */
     UFUNCTION(BlueprintPure)
     virtual float GetRemainingLifeSpan();
+
+    bool IsDropped() const
+    {
+        return DropState.DroppedAt > 0.0;
+    }
+
+protected:
+
+    /**
+    * Authority only.
+    * Start a new drop from current actor transform.
+    */
+    virtual void StartDrop();
+
+    /**
+    * Authority only.
+    * Drop is over, hide and disable until reused. Stays relevant, but net dormant.
+    */
+    virtual void ReturnToPool();
+
+    /** Apply DropState locally (show and start moving, or hide) */
+    virtual void ApplyDropState();
 };
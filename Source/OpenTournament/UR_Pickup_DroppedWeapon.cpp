@@ -10,6 +10,7 @@
 
 #include "UR_Weapon.h"
 #include "UR_Character.h"
+#include "UR_ReplicationGraph.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -23,7 +24,7 @@ void AUR_Pickup_DroppedWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProper
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    DOREPLIFETIME_CONDITION(ThisClass, Weapon, COND_InitialOnly);
+    DOREPLIFETIME_CONDITION(ThisClass, Weapon, COND_None);
 }
 
 void AUR_Pickup_DroppedWeapon::SetWeapon(AUR_Weapon* InWeapon)
@@ -39,6 +40,15 @@ void AUR_Pickup_DroppedWeapon::SetWeapon(AUR_Weapon* InWeapon)
         Weapon->ToggleGeneralVisibility(true);
 
         DisplayName = FText::FromString(Weapon->WeaponName);
+
+        // Ownerless weapons are not routed by the replication graph, replicate along with this pickup
+        if (HasAuthority())
+        {
+            if (UUR_ReplicationGraph* RepGraph = UUR_ReplicationGraph::Get(GetWorld()))
+            {
+                RepGraph->UpdateWeaponDependency(Weapon, this);
+            }
+        }
     }
 }
 
@@ -59,6 +69,18 @@ bool AUR_Pickup_DroppedWeapon::OnPickup_Implementation(AUR_Character* PickupChar
     return false;
 }
 
+void AUR_Pickup_DroppedWeapon::ReturnToPool()
+{
+    // Expired without being picked up
+    if (Weapon)
+    {
+        Weapon->Destroy();
+        Weapon = nullptr;
+    }
+
+    Super::ReturnToPool();
+}
+
 void AUR_Pickup_DroppedWeapon::Destroyed()
 {
     if (Weapon)
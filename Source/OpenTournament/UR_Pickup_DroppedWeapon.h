@@ -26,12 +26,14 @@ protected:
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
     virtual bool OnPickup_Implementation(AUR_Character* PickupCharacter) override;
     virtual void Destroyed() override;
+    virtual void ReturnToPool() override;
     
 public:	
     AUR_Pickup_DroppedWeapon(const FObjectInitializer& ObjectInitializer);
 
     /**
-    * Weapon instance held by this dropped pickup
+    * Weapon instance held by this dropped pickup.
+    * Not initial-only, as the pickup can be recycled with another weapon.
     */
     UPROPERTY(ReplicatedUsing = OnRep_Weapon)
     AUR_Weapon* Weapon;
@@ -411,3 +411,14 @@ void AUR_PlayerController::SetTeamIndex_Implementation(int32 NewTeamIndex)
         IUR_TeamInterface::Execute_SetTeamIndex(PS, NewTeamIndex);
     }
 }
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AUR_PlayerController::ClientDamageEvent_Implementation(AUR_Character* Victim, const FReplicatedDamageEvent& RepDamageEvent)
+{
+    // Victim may not be relevant to us anymore
+    if (Victim)
+    {
+        Victim->BroadcastDamageEvent(RepDamageEvent);
+    }
+}
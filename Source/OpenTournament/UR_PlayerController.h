@@ -6,6 +6,7 @@
 
 #include "UR_BasePlayerController.h"
 #include "Interfaces/UR_TeamInterface.h"
+#include "UR_Character.h"    // FReplicatedDamageEvent
 #include "UR_PlayerController.generated.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -278,6 +279,15 @@ public:
 
     /////////////////////////////////////////////////////////////////////////////////////////////////
 
+    /**
+    * Damage event routed to this connection only.
+    * @see AUR_Character::SendDamageEvent
+    */
+    UFUNCTION(Client, Unreliable)
+    void ClientDamageEvent(AUR_Character* Victim, const FReplicatedDamageEvent& RepDamageEvent);
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////
+
     //~ Begin TeamInterface
     virtual int32 GetTeamIndex_Implementation() override;
     virtual void SetTeamIndex_Implementation(int32 NewTeamIndex) override;
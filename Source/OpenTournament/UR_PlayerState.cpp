@@ -5,7 +5,7 @@
 #include "UR_PlayerState.h"
 
 #include "Net/UnrealNetwork.h"
-//#include "Net/Core/PushModel/PushModel.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Engine/World.h"
 #include "Kismet/KismetSystemLibrary.h"
 
@@ -23,6 +23,10 @@ AUR_PlayerState::AUR_PlayerState()
     TeamIndex = -1;
     ReplicatedTeamIndex = -1;
 
+    LeaderboardIndex = INDEX_NONE;
+    LeaderboardRank = 0;
+    LeaderboardSerial = 0;
+
     OnPawnSet.AddUniqueDynamic(this, &ThisClass::InternalOnPawnSet);
     OnTeamChanged.AddUniqueDynamic(this, &ThisClass::InternalOnTeamChanged);
 }
@@ -75,7 +79,7 @@ void AUR_PlayerState::RegisterKill(AController* Victim, FGameplayTagContainer& O
     // Although including teamkills in multikills & sprees might not be a bad thing.
 
     Kills++;
-    //MARK_PROPERTY_DIRTY_FROM_NAME(AUR_PlayerState, Kills, this);
+    MARK_PROPERTY_DIRTY_FROM_NAME(AUR_PlayerState, Kills, this);
 
     if (GetWorld()->TimeSince(LastKillTime) < 3.f)
     {
@@ -126,7 +130,7 @@ void AUR_PlayerState::RegisterKill(AController* Victim, FGameplayTagContainer& O
 void AUR_PlayerState::RegisterDeath(AController* Killer, FGameplayTagContainer& OutTags)
 {
     Deaths++;
-    //MARK_PROPERTY_DIRTY_FROM_NAME(AUR_PlayerState, Deaths, this);
+    MARK_PROPERTY_DIRTY_FROM_NAME(AUR_PlayerState, Deaths, this);
 
     if (SpreeLevel > 0)
     {
@@ -149,13 +153,55 @@ void AUR_PlayerState::RegisterDeath(AController* Killer, FGameplayTagContainer&
 void AUR_PlayerState::RegisterSuicide(FGameplayTagContainer& OutExtras)
 {
     Suicides++;
-    //MARK_PROPERTY_DIRTY_FROM_NAME(AUR_PlayerState, Suicides, this);
+    MARK_PROPERTY_DIRTY_FROM_NAME(AUR_PlayerState, Suicides, this);
     ForceNetUpdate();
 }
 
 void AUR_PlayerState::AddScore(const int32 Value)
 {
-    SetScore(GetScore() + Value);
+    SetPlayerScore(GetScore() + Value);
+}
+
+void AUR_PlayerState::SetPlayerScore(const float NewScore)
+{
+    SetScore(NewScore);
+
+    if (auto GS = GetWorld()->GetGameState<AUR_GameState>())
+    {
+        GS->UpdateLeaderboard(this);
+    }
+}
+
+void AUR_PlayerState::OnRep_Score()
+{
+    Super::OnRep_Score();
+
+    if (auto GS = GetWorld()->GetGameState<AUR_GameState>())
+    {
+        GS->UpdateLeaderboard(this);
+    }
+}
+
+void AUR_PlayerState::CopyProperties(APlayerState* PlayerState)
+{
+    Super::CopyProperties(PlayerState);
+
+    // Score was copied over (seamless travel, inactive player state on disconnect)
+    if (auto GS = GetWorld()->GetGameState<AUR_GameState>())
+    {
+        GS->UpdateLeaderboard(Cast<AUR_PlayerState>(PlayerState));
+    }
+}
+
+void AUR_PlayerState::OverrideWith(APlayerState* PlayerState)
+{
+    Super::OverrideWith(PlayerState);
+
+    // Score was restored from the inactive player state on reconnect
+    if (auto GS = GetWorld()->GetGameState<AUR_GameState>())
+    {
+        GS->UpdateLeaderboard(this);
+    }
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -185,7 +231,7 @@ void AUR_PlayerState::SetTeamIndex_Implementation(int32 NewTeamIndex)
         if (HasAuthority())
         {
             ReplicatedTeamIndex = TeamIndex;
-            //MARK_PROPERTY_DIRTY_FROM_NAME(AUR_PlayerState, ReplicatedTeamIndex, this);
+            MARK_PROPERTY_DIRTY_FROM_NAME(AUR_PlayerState, ReplicatedTeamIndex, this);
             ForceNetUpdate();
         }
 
@@ -326,6 +372,7 @@ void AUR_PlayerState::ServerSetCharacterCustomization_Implementation(const FChar
     //NOTE: We can either do server validation of chosen assets, and correct the assets before replicating them to others
     // Or just replicate directly and let clients decide if they accept those customizations.
     CharacterCustomization = InCustomization;
+    MARK_PROPERTY_DIRTY_FROM_NAME(AUR_PlayerState, CharacterCustomization, this);
     OnRep_CharacterCustomization();
 }
 
@@ -83,6 +83,30 @@ public:
     UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable)
     virtual void AddScore(int32 Value);
 
+    /**
+    * Set score and keep GameState leaderboard in order.
+    * Server code should use this (or AddScore) rather than APlayerState::SetScore.
+    */
+    UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable)
+    virtual void SetPlayerScore(float NewScore);
+
+    virtual void OnRep_Score() override;
+
+    virtual void CopyProperties(APlayerState* PlayerState) override;
+    virtual void OverrideWith(APlayerState* PlayerState) override;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////
+    // Leaderboard entry, maintained by AUR_GameState
+
+    /** Position in GameState Leaderboard, INDEX_NONE if not in it */
+    int32 LeaderboardIndex;
+
+    /** Rank starting at 1, shared by tied players */
+    int32 LeaderboardRank;
+
+    /** Arrival order in the leaderboard, breaks ties */
+    int32 LeaderboardSerial;
+
     /////////////////////////////////////////////////////////////////////////////////////////////////
 
 public:
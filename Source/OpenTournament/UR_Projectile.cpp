@@ -16,6 +16,8 @@
 #include "Kismet/GameplayStatics.h"
 #include "Net/UnrealNetwork.h"
 
+#include "UR_GameplayActorRegistry.h"
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 //NOTE: Maybe a BouncingProjectile subclass would be appropriate.
@@ -88,6 +90,15 @@ void AUR_Projectile::BeginPlay()
     {
         ProjectileMovementComponent->OnProjectileBounce.AddDynamic(this, &ThisClass::OnBounceInternal);
     }
+
+    UUR_GameplayActorRegistry::Register(this, EGameplayActorType::Projectile);
+}
+
+void AUR_Projectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    UUR_GameplayActorRegistry::Unregister(this);
+
+    Super::EndPlay(EndPlayReason);
 }
 
 //deprecated
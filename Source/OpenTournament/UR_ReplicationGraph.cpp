@@ -0,0 +1,434 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_ReplicationGraph.h"
+
+#include "Engine/LevelScriptActor.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "UObject/UObjectIterator.h"
+
+#include "UR_Ammo.h"
+#include "UR_Character.h"
+#include "UR_InventoryComponent.h"
+#include "UR_LogChannels.h"
+#include "UR_NetProfiler.h"
+#include "UR_Pickup.h"
+#include "UR_PickupBase.h"
+#include "UR_PickupFactory.h"
+#include "UR_Projectile.h"
+#include "UR_Weapon.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_ReplicationGraph)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT Replication Graph"), STATGROUP_OTReplicationGraph, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Server Replicate Actors"), STAT_OTRepGraphReplicateActors, STATGROUP_OTReplicationGraph);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Connections"), STAT_OTRepGraphConnections, STATGROUP_OTReplicationGraph);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon Dependencies"), STAT_OTRepGraphWeaponDependencies, STATGROUP_OTReplicationGraph);
+
+namespace OTConsoleVariables
+{
+    static FAutoConsoleCommandWithWorldAndArgs CmdRepGraphBenchmark(
+        TEXT("OT.RepGraph.Benchmark"),
+        TEXT("Measure server replication time of the replication graph. Optional arg: duration in seconds (default 30)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (auto Graph = UUR_ReplicationGraph::Get(World))
+            {
+                Graph->StartBenchmark(Args.Num() > 0 ? FCString::Atof(*Args[0]) : 30.f);
+            }
+            else
+            {
+                UE_LOG(LogNetOT, Warning, TEXT("Replication graph is not in use. Measure the legacy path with 'stat net' (Server Rep Actor Time)."));
+            }
+        }));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_ReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+    // Controller and view target
+    Super::GatherActorListsForConnection(Params);
+
+    InventoryList.Reset();
+
+    const auto GatherInventory = [this](const AActor* Actor)
+    {
+        const AUR_Character* URCharacter = Cast<AUR_Character>(Actor);
+        const UUR_InventoryComponent* Inventory = URCharacter ? URCharacter->InventoryComponent : nullptr;
+        if (!Inventory)
+        {
+            return;
+        }
+
+        for (AUR_Weapon* Weapon : Inventory->WeaponArray)
+        {
+            if (Weapon && Weapon->GetIsReplicated())
+            {
+                InventoryList.ConditionalAdd(Weapon);
+            }
+        }
+
+        // Ammo actors only replicate in legacy inventory mode
+        for (AUR_Ammo* Ammo : Inventory->AmmoArray)
+        {
+            if (Ammo && Ammo->GetIsReplicated())
+            {
+                InventoryList.ConditionalAdd(Ammo);
+            }
+        }
+    };
+
+    for (const FNetViewer& Viewer : Params.Viewers)
+    {
+        // Own pawn, and whoever is being spectated
+        const APlayerController* PC = Cast<APlayerController>(Viewer.InViewer);
+        const APawn* Pawn = PC ? PC->GetPawn() : nullptr;
+        GatherInventory(Pawn);
+        if (Viewer.ViewTarget != Pawn)
+        {
+            GatherInventory(Viewer.ViewTarget);
+        }
+    }
+
+    if (InventoryList.Num() > 0)
+    {
+        Params.OutGatheredReplicationLists.AddReplicationActorList(InventoryList);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+UUR_ReplicationGraph::UUR_ReplicationGraph()
+{
+    if (!UReplicationDriver::CreateReplicationDriverDelegate().IsBound())
+    {
+        UReplicationDriver::CreateReplicationDriverDelegate().BindLambda([](UNetDriver* ForNetDriver, const FURL& URL, UWorld* World) -> UReplicationDriver*
+        {
+            if (World && ForNetDriver && ForNetDriver->NetDriverName == NAME_GameNetDriver && GetDefault<UUR_ReplicationGraph>()->bEnableReplicationGraph)
+            {
+                return NewObject<UUR_ReplicationGraph>(GetTransientPackage());
+            }
+            return nullptr;
+        });
+    }
+}
+
+UUR_ReplicationGraph* UUR_ReplicationGraph::Get(const UWorld* World)
+{
+    const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+    return NetDriver ? Cast<UUR_ReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr;
+}
+
+void UUR_ReplicationGraph::InitGlobalActorClassSettings()
+{
+    Super::InitGlobalActorClassSettings();
+
+    const float ServerMaxTickRate = NetDriver ? NetDriver->GetNetServerMaxTickRate() : 30.f;
+
+    // Same breakdown as UUR_NetProfiler in CSV captures (csvprofile)
+    CSVTracker.SetExplicitClassTracking(AUR_Character::StaticClass(), TEXT("Character"));
+    CSVTracker.SetExplicitClassTracking(AUR_Weapon::StaticClass(), TEXT("Weapon"));
+    CSVTracker.SetExplicitClassTracking(AUR_Projectile::StaticClass(), TEXT("Projectile"));
+    CSVTracker.SetExplicitClassTracking(AUR_PickupBase::StaticClass(), TEXT("Pickup"));
+    CSVTracker.SetExplicitClassTracking(AUR_PickupFactory::StaticClass(), TEXT("Pickup"));
+    CSVTracker.SetExplicitClassTracking(AUR_Pickup::StaticClass(), TEXT("Pickup"));
+
+    // Every class loaded now gets its own policy, iteration order does not matter.
+    // Classes loaded later (blueprints) resolve to their closest parent, see GetMappingPolicy.
+    for (TObjectIterator<UClass> It; It; ++It)
+    {
+        UClass* Class = *It;
+        if (!Class->IsChildOf(AActor::StaticClass())
+            || Class->GetName().StartsWith(TEXT("SKEL_"))
+            || Class->GetName().StartsWith(TEXT("REINST_")))
+        {
+            continue;
+        }
+
+        if (!ClassRepNodePolicies.Contains(Class, /*bIncludeSuper*/ false))
+        {
+            ClassRepNodePolicies.Set(Class, ComputeMappingPolicy(Class));
+        }
+
+        const AActor* ActorCDO = Class->GetDefaultObject<AActor>();
+        if (!ActorCDO || !ActorCDO->GetIsReplicated())
+        {
+            continue;
+        }
+
+        const EUR_ClassRepNodeMapping Policy = GetMappingPolicy(Class);
+
+        FClassReplicationInfo ClassInfo;
+        if (Policy == EUR_ClassRepNodeMapping::Spatialize_Static
+            || Policy == EUR_ClassRepNodeMapping::Spatialize_Dynamic
+            || Policy == EUR_ClassRepNodeMapping::Spatialize_Dormancy)
+        {
+            ClassInfo.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared > 0.f ? ActorCDO->NetCullDistanceSquared : FMath::Square(DefaultCullDistance));
+        }
+        ClassInfo.ReplicationPeriodFrame = FMath::Max<uint32>(1, FMath::RoundToInt(ServerMaxTickRate / FMath::Max(ActorCDO->NetUpdateFrequency, 1.f)));
+        GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+    }
+}
+
+void UUR_ReplicationGraph::InitGlobalGraphNodes()
+{
+    GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+    GridNode->CellSize = GridCellSize;
+    GridNode->SpatialBias = GridSpatialBias;
+    AddGlobalGraphNode(GridNode);
+
+    AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+    AddGlobalGraphNode(AlwaysRelevantNode);
+
+    PlayerStateNode = CreateNewNode<UReplicationGraphNode_PlayerStateFrequencyLimiter>();
+    AddGlobalGraphNode(PlayerStateNode);
+}
+
+void UUR_ReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+    Super::InitConnectionGraphNodes(RepGraphConnection);
+
+    auto ConnectionNode = CreateNewNode<UUR_ReplicationGraphNode_AlwaysRelevant_ForConnection>();
+    AddConnectionGraphNode(ConnectionNode, RepGraphConnection);
+}
+
+EUR_ClassRepNodeMapping UUR_ReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+    // Exact for classes visited by InitGlobalActorClassSettings,
+    // inherited from the closest registered parent for classes loaded later
+    if (const EUR_ClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class))
+    {
+        return *Policy;
+    }
+    const EUR_ClassRepNodeMapping Policy = ComputeMappingPolicy(Class);
+    ClassRepNodePolicies.Set(Class, Policy);
+    return Policy;
+}
+
+EUR_ClassRepNodeMapping UUR_ReplicationGraph::ComputeMappingPolicy(const UClass* Class)
+{
+    // Player states have their own node, inventory is gathered per connection.
+    // Equipped and dropped weapons are also dependents of their pawn or pickup, see UpdateWeaponDependency.
+    if (Class->IsChildOf(APlayerState::StaticClass())
+        || Class->IsChildOf(AUR_Weapon::StaticClass())
+        || Class->IsChildOf(AUR_Ammo::StaticClass()))
+    {
+        return EUR_ClassRepNodeMapping::NotRouted;
+    }
+
+    if (Class->IsChildOf(AUR_PickupBase::StaticClass())
+        || Class->IsChildOf(AUR_PickupFactory::StaticClass())
+        || Class->IsChildOf(AUR_Pickup::StaticClass()))
+    {
+        return EUR_ClassRepNodeMapping::Spatialize_Dormancy;
+    }
+
+    if (Class->IsChildOf(APawn::StaticClass())
+        || Class->IsChildOf(AUR_Projectile::StaticClass()))
+    {
+        return EUR_ClassRepNodeMapping::Spatialize_Dynamic;
+    }
+
+    const AActor* ActorCDO = Class->GetDefaultObject<AActor>();
+    if (ActorCDO->bAlwaysRelevant)
+    {
+        return EUR_ClassRepNodeMapping::RelevantAllConnections;
+    }
+    // Controllers are gathered per connection
+    if (ActorCDO->bOnlyRelevantToOwner)
+    {
+        return EUR_ClassRepNodeMapping::NotRouted;
+    }
+    if (Class->IsChildOf(ALevelScriptActor::StaticClass()) || !ActorCDO->IsReplicatingMovement())
+    {
+        return EUR_ClassRepNodeMapping::Spatialize_Static;
+    }
+    return EUR_ClassRepNodeMapping::Spatialize_Dynamic;
+}
+
+void UUR_ReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+    if (ActorInfo.Actor->IsA<APlayerState>())
+    {
+        PlayerStateNode->NotifyAddNetworkActor(ActorInfo);
+        return;
+    }
+
+    switch (GetMappingPolicy(ActorInfo.Class))
+    {
+        case EUR_ClassRepNodeMapping::RelevantAllConnections:
+            AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+            break;
+        case EUR_ClassRepNodeMapping::Spatialize_Static:
+            GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+            break;
+        case EUR_ClassRepNodeMapping::Spatialize_Dynamic:
+            GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+            break;
+        case EUR_ClassRepNodeMapping::Spatialize_Dormancy:
+            GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+            break;
+        default:
+            break;
+    }
+}
+
+void UUR_ReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+    if (ActorInfo.Actor->IsA<APlayerState>())
+    {
+        PlayerStateNode->NotifyRemoveNetworkActor(ActorInfo);
+        return;
+    }
+
+    switch (GetMappingPolicy(ActorInfo.Class))
+    {
+        case EUR_ClassRepNodeMapping::RelevantAllConnections:
+            AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+            break;
+        case EUR_ClassRepNodeMapping::Spatialize_Static:
+            GridNode->RemoveActor_Static(ActorInfo);
+            break;
+        case EUR_ClassRepNodeMapping::Spatialize_Dynamic:
+            GridNode->RemoveActor_Dynamic(ActorInfo);
+            break;
+        case EUR_ClassRepNodeMapping::Spatialize_Dormancy:
+            GridNode->RemoveActor_Dormancy(ActorInfo);
+            break;
+        default:
+            break;
+    }
+
+    TWeakObjectPtr<AActor> Parent;
+    if (WeaponParents.RemoveAndCopyValue(ActorInfo.Actor, Parent))
+    {
+        if (AActor* ParentActor = Parent.Get())
+        {
+            GlobalActorReplicationInfoMap.RemoveDependentActor(ParentActor, ActorInfo.Actor);
+        }
+    }
+}
+
+void UUR_ReplicationGraph::UpdateWeaponDependency(AUR_Weapon* Weapon, AActor* DroppedPickup)
+{
+    AActor* NewParent = DroppedPickup ? DroppedPickup : (Weapon->IsEquipped() ? Weapon->GetOwner() : nullptr);
+
+    const TWeakObjectPtr<AActor>* OldParent = WeaponParents.Find(Weapon);
+    if (OldParent ? (OldParent->Get() == NewParent) : (NewParent == nullptr))
+    {
+        return;
+    }
+
+    if (OldParent)
+    {
+        if (AActor* OldParentActor = OldParent->Get())
+        {
+            GlobalActorReplicationInfoMap.RemoveDependentActor(OldParentActor, Weapon);
+        }
+        WeaponParents.Remove(Weapon);
+    }
+
+    if (NewParent)
+    {
+        GlobalActorReplicationInfoMap.AddDependentActor(NewParent, Weapon);
+        WeaponParents.Add(Weapon, NewParent);
+    }
+
+    SET_DWORD_STAT(STAT_OTRepGraphWeaponDependencies, WeaponParents.Num());
+}
+
+int32 UUR_ReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+    SCOPE_CYCLE_COUNTER(STAT_OTRepGraphReplicateActors);
+    SET_DWORD_STAT(STAT_OTRepGraphConnections, Connections.Num());
+
+    UUR_NetProfiler* NetProfiler = GetCapturingNetProfiler();
+    const int64 StartBits = NetProfiler ? UUR_NetProfiler::GetSentBits(NetDriver) : 0;
+
+    const double StartTime = FPlatformTime::Seconds();
+    FrameNetProfiler = NetProfiler;
+    const int32 Result = Super::ServerReplicateActors(DeltaSeconds);
+    FrameNetProfiler = nullptr;
+
+    if (NetProfiler)
+    {
+        NetProfiler->RecordReplicateActors(UUR_NetProfiler::GetSentBits(NetDriver) - StartBits, FPlatformTime::Seconds() - StartTime);
+    }
+
+    if (Benchmark.bActive)
+    {
+        const double Now = FPlatformTime::Seconds();
+        const double Ms = (Now - StartTime) * 1000.0;
+        Benchmark.TotalMs += Ms;
+        Benchmark.MaxMs = FMath::Max(Benchmark.MaxMs, Ms);
+        Benchmark.Frames++;
+        Benchmark.MaxConnections = FMath::Max(Benchmark.MaxConnections, Connections.Num());
+
+        if (Now >= Benchmark.EndTime)
+        {
+            Benchmark.bActive = false;
+            UE_LOG(LogNetOT, Log, TEXT("RepGraph benchmark: %d connections, %d frames, avg %.3f ms, max %.3f ms"),
+                Benchmark.MaxConnections, Benchmark.Frames, Benchmark.TotalMs / FMath::Max(Benchmark.Frames, 1), Benchmark.MaxMs);
+        }
+    }
+
+    return Result;
+}
+
+bool UUR_ReplicationGraph::ProcessRemoteFunction(AActor* Actor, UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack, UObject* SubObject)
+{
+    UUR_NetProfiler* NetProfiler = GetCapturingNetProfiler();
+    if (!NetProfiler)
+    {
+        return Super::ProcessRemoteFunction(Actor, Function, Parameters, OutParms, Stack, SubObject);
+    }
+
+    // RPCs are written to the connections right away, so the difference in sent bits is the cost of this call
+    const int64 StartBits = UUR_NetProfiler::GetSentBits(NetDriver);
+    const double StartTime = FPlatformTime::Seconds();
+    const bool bResult = Super::ProcessRemoteFunction(Actor, Function, Parameters, OutParms, Stack, SubObject);
+    NetProfiler->RecordRemoteFunction(Actor, Function, UUR_NetProfiler::GetSentBits(NetDriver) - StartBits, FPlatformTime::Seconds() - StartTime);
+
+    return bResult;
+}
+
+int64 UUR_ReplicationGraph::ReplicateSingleActor(AActor* Actor, FConnectionReplicationActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalActorInfo, FPerConnectionActorInfoMap& ConnectionActorInfoMap, UNetReplicationGraphConnection& ConnectionManager, const uint32 FrameNum)
+{
+    if (!FrameNetProfiler)
+    {
+        return Super::ReplicateSingleActor(Actor, ActorInfo, GlobalActorInfo, ConnectionActorInfoMap, ConnectionManager, FrameNum);
+    }
+
+    // Returns the bits written for this actor (and its subobjects) to this connection.
+    // The channel is opened in there when the actor has none yet for the connection.
+    const bool bOpensChannel = ActorInfo.Channel == nullptr;
+    const double StartTime = FPlatformTime::Seconds();
+    const int64 Bits = Super::ReplicateSingleActor(Actor, ActorInfo, GlobalActorInfo, ConnectionActorInfoMap, ConnectionManager, FrameNum);
+    FrameNetProfiler->RecordReplicateActor(Actor, Bits, FPlatformTime::Seconds() - StartTime, bOpensChannel && ActorInfo.Channel != nullptr);
+
+    return Bits;
+}
+
+UUR_NetProfiler* UUR_ReplicationGraph::GetCapturingNetProfiler() const
+{
+    const UWorld* World = NetDriver ? NetDriver->GetWorld() : nullptr;
+    UUR_NetProfiler* NetProfiler = World ? World->GetSubsystem<UUR_NetProfiler>() : nullptr;
+    return (NetProfiler && NetProfiler->IsCapturing()) ? NetProfiler : nullptr;
+}
+
+void UUR_ReplicationGraph::StartBenchmark(float Duration)
+{
+    Benchmark = FBenchmark();
+    Benchmark.EndTime = FPlatformTime::Seconds() + FMath::Max(Duration, 1.f);
+    Benchmark.bActive = true;
+
+    UE_LOG(LogNetOT, Log, TEXT("RepGraph benchmark started for %.0f s with %d connections"), FMath::Max(Duration, 1.f), Connections.Num());
+}
@@ -0,0 +1,160 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+
+#include "UR_ReplicationGraph.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+class AUR_Weapon;
+class UUR_NetProfiler;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * How actors of a class are routed to the graph nodes.
+ */
+UENUM()
+enum class EUR_ClassRepNodeMapping : uint8
+{
+    /** Not routed to a global node, handled by a dedicated node or a dependency (player states, inventory) */
+    NotRouted,
+    /** Relevant to all connections (game state, team infos...) */
+    RelevantAllConnections,
+    /** Spatialized, never moves */
+    Spatialize_Static,
+    /** Spatialized, moves frequently (pawns, projectiles) */
+    Spatialize_Dynamic,
+    /** Spatialized, treated as static while dormant (pickups) */
+    Spatialize_Dormancy,
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Per-connection node for what only the connection's owner needs.
+ * On top of the controller and view target, gathers the inventory (weapons, ammo) of the possessed pawn
+ * and of the view target, so spectators get the inventory of who they are watching.
+ */
+UCLASS()
+class OPENTOURNAMENT_API UUR_ReplicationGraphNode_AlwaysRelevant_ForConnection : public UReplicationGraphNode_AlwaysRelevant_ForConnection
+{
+    GENERATED_BODY()
+
+public:
+
+    virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+protected:
+
+    FActorRepListRefView InventoryList;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Replication graph for OpenTournament.
+ *
+ * Replaces per-connection relevancy checks over every replicated actor with a few nodes:
+ * - A 2D grid for spatialized actors. Pawns and projectiles are dynamic, pickups are static while dormant.
+ * - An always relevant list for game state, team infos and other bAlwaysRelevant actors.
+ * - A frequency limited node for player states.
+ * - A per-connection node for the controller, its pawn and the pawn's inventory.
+ *   Equipped weapons are also made dependent on their pawn so other connections see them along with it.
+ *   Dropped weapons are dependent on the dropped pickup holding them.
+ *
+ * Created by the game net driver when bEnableReplicationGraph is set in config.
+ */
+UCLASS(Transient, Config = Game)
+class OPENTOURNAMENT_API UUR_ReplicationGraph : public UReplicationGraph
+{
+    GENERATED_BODY()
+
+public:
+
+    UUR_ReplicationGraph();
+
+    //~UReplicationGraph interface
+    virtual void InitGlobalActorClassSettings() override;
+    virtual void InitGlobalGraphNodes() override;
+    virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+    virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+    virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+    virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+    virtual bool ProcessRemoteFunction(AActor* Actor, UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack, UObject* SubObject) override;
+    virtual int64 ReplicateSingleActor(AActor* Actor, FConnectionReplicationActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalActorInfo, FPerConnectionActorInfoMap& ConnectionActorInfoMap, UNetReplicationGraphConnection& ConnectionManager, const uint32 FrameNum) override;
+    //~End of UReplicationGraph interface
+
+    /** Replication graph of the world's game net driver, if it uses one */
+    static UUR_ReplicationGraph* Get(const UWorld* World);
+
+    /**
+    * Make an equipped weapon replicate along with its pawn, a dropped weapon along with its pickup, or undo it.
+    * Called by the weapon whenever its net relevancy changes, and by the dropped pickup receiving it.
+    */
+    void UpdateWeaponDependency(AUR_Weapon* Weapon, AActor* DroppedPickup = nullptr);
+
+    /**
+    * Measure ServerReplicateActors over a number of seconds and log the result.
+    * Backs the OT.RepGraph.Benchmark console command.
+    */
+    void StartBenchmark(float Duration);
+
+    /** Use this graph for the game net driver. Disable to compare against the legacy relevancy path. */
+    UPROPERTY(Config)
+    bool bEnableReplicationGraph = true;
+
+    UPROPERTY(Config)
+    float GridCellSize = 10000.f;
+
+    /** Offset of the grid origin, should cover the most negative coordinates of the maps */
+    UPROPERTY(Config)
+    FVector2D GridSpatialBias = FVector2D(-150000.f, -150000.f);
+
+    /** Cull distance used for spatialized classes that don't set one */
+    UPROPERTY(Config)
+    float DefaultCullDistance = 15000.f;
+
+protected:
+
+    EUR_ClassRepNodeMapping GetMappingPolicy(UClass* Class);
+
+    static EUR_ClassRepNodeMapping ComputeMappingPolicy(const UClass* Class);
+
+    /** Net profiler of the world, if a capture is running */
+    UUR_NetProfiler* GetCapturingNetProfiler() const;
+
+    /** Capturing net profiler, for the duration of ServerReplicateActors */
+    UUR_NetProfiler* FrameNetProfiler = nullptr;
+
+    TClassMap<EUR_ClassRepNodeMapping> ClassRepNodePolicies;
+
+    UPROPERTY()
+    TObjectPtr<UReplicationGraphNode_GridSpatialization2D> GridNode;
+
+    UPROPERTY()
+    TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
+
+    UPROPERTY()
+    TObjectPtr<UReplicationGraphNode_PlayerStateFrequencyLimiter> PlayerStateNode;
+
+    /** Pawn or dropped pickup each weapon currently depends on */
+    TMap<TObjectKey<AActor>, TWeakObjectPtr<AActor>> WeaponParents;
+
+    struct FBenchmark
+    {
+        double EndTime = 0.0;
+        double TotalMs = 0.0;
+        double MaxMs = 0.0;
+        int32 Frames = 0;
+        int32 MaxConnections = 0;
+        bool bActive = false;
+    };
+
+    FBenchmark Benchmark;
+};
@@ -0,0 +1,557 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "UR_SpawnSelectionSubsystem.h"
+
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerStart.h"
+#include "GameFramework/PlayerStartPIE.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/SpectatorPawn.h"
+
+#include "UR_Character.h"
+#include "UR_GameplayActorRegistry.h"
+#include "UR_LogChannels.h"
+#include "Interfaces/UR_TeamInterface.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(UR_SpawnSelectionSubsystem)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+DECLARE_STATS_GROUP(TEXT("OT Spawn Selection"), STATGROUP_OTSpawnSelection, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Choose Spawn Point"), STAT_ChooseSpawnPoint, STATGROUP_OTSpawnSelection);
+DECLARE_CYCLE_STAT(TEXT("Update Pawns"), STAT_SpawnUpdatePawns, STATGROUP_OTSpawnSelection);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Tracked Pawns"), STAT_SpawnTrackedPawns, STATGROUP_OTSpawnSelection);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rejected Candidates"), STAT_SpawnRejectedCandidates, STATGROUP_OTSpawnSelection);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sight Traces"), STAT_SpawnSightTraces, STATGROUP_OTSpawnSelection);
+
+namespace OTConsoleVariables
+{
+    static const APawn* GetDefaultPawnToFit(UWorld* World)
+    {
+        AGameModeBase* GameMode = World ? World->GetAuthGameMode() : nullptr;
+        return (GameMode && GameMode->DefaultPawnClass) ? GameMode->DefaultPawnClass->GetDefaultObject<APawn>() : nullptr;
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs CmdSpawnValidate(
+        TEXT("OT.Spawn.Validate"),
+        TEXT("Compare incremental spawn threat scores against a full recomputation."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (auto SpawnSelection = World ? World->GetSubsystem<UUR_SpawnSelectionSubsystem>() : nullptr)
+            {
+                SpawnSelection->ValidateScores();
+            }
+        }));
+
+    static FAutoConsoleCommandWithWorldAndArgs CmdSpawnBenchmark(
+        TEXT("OT.Spawn.Benchmark"),
+        TEXT("Time spawn selection against a naive scan of all starts. Optional arg: iterations (default 100)."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (auto SpawnSelection = World ? World->GetSubsystem<UUR_SpawnSelectionSubsystem>() : nullptr)
+            {
+                SpawnSelection->Benchmark(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100, GetDefaultPawnToFit(World));
+            }
+        }));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FUR_SpawnScoreTree::Init(const TArray<int32>& InScores)
+{
+    Scores = InScores;
+
+    LeafOffset = FMath::RoundUpToPowerOfTwo(FMath::Max(Scores.Num(), 1));
+    Nodes.Init(INDEX_NONE, Scores.Num() > 0 ? 2 * LeafOffset : 0);
+    for (int32 i = 0; i < Scores.Num(); i++)
+    {
+        Nodes[LeafOffset + i] = i;
+    }
+    for (int32 i = LeafOffset - 1; i >= 1; i--)
+    {
+        Nodes[i] = Pick(Nodes[2 * i], Nodes[2 * i + 1]);
+    }
+}
+
+void FUR_SpawnScoreTree::Update(int32 Index, int32 Score)
+{
+    Scores[Index] = Score;
+    for (int32 i = (LeafOffset + Index) / 2; i >= 1; i /= 2)
+    {
+        Nodes[i] = Pick(Nodes[2 * i], Nodes[2 * i + 1]);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UUR_SpawnSelectionSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // Spawning is decided by the server
+    return !IsRunningClientOnly() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UUR_SpawnSelectionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UUR_SpawnSelectionSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UUR_SpawnSelectionSubsystem, STATGROUP_Tickables);
+}
+
+void UUR_SpawnSelectionSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    for (TActorIterator<APlayerStart> It(&InWorld); It; ++It)
+    {
+        if (It->IsA<APlayerStartPIE>())
+        {
+            bHasPIEStart = true;
+            continue;
+        }
+        const int32 Index = Starts.Add({ *It, It->GetActorLocation(), It->GetActorRotation() });
+        StartCells.FindOrAdd(GetCellCoord(Starts[Index].Location)).Add(Index);
+    }
+
+    Threat.SetNumZeroed(Starts.Num());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+int32 UUR_SpawnSelectionSubsystem::GetCellThreat(const FIntPoint& Cell, int32 StartIndex) const
+{
+    const FVector2D CellCenter((Cell.X + 0.5) * CellSize, (Cell.Y + 0.5) * CellSize);
+    const double Dist = FVector2D::Distance(CellCenter, FVector2D(Starts[StartIndex].Location));
+    if (Dist >= ThreatRadius)
+    {
+        return 0;
+    }
+    return FMath::RoundToInt(PawnThreat * (1.0 - Dist / ThreatRadius));
+}
+
+void UUR_SpawnSelectionSubsystem::ApplyPawnThreat(const FIntPoint& Cell, int32 TeamIndex, int32 Sign)
+{
+    // A start in a cell further than this is at least ThreatRadius away from the cell center
+    const int32 Range = FMath::CeilToInt(ThreatRadius / CellSize);
+    for (int32 X = Cell.X - Range; X <= Cell.X + Range; X++)
+    {
+        for (int32 Y = Cell.Y - Range; Y <= Cell.Y + Range; Y++)
+        {
+            if (const TArray<int32>* CellStarts = StartCells.Find(FIntPoint(X, Y)))
+            {
+                for (int32 StartIndex : *CellStarts)
+                {
+                    if (const int32 Amount = GetCellThreat(Cell, StartIndex))
+                    {
+                        AddThreat(StartIndex, TeamIndex, Sign * Amount);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void UUR_SpawnSelectionSubsystem::AddThreat(int32 StartIndex, int32 TeamIndex, int32 Delta)
+{
+    Threat[StartIndex] += Delta;
+
+    if (TeamIndex >= 0)
+    {
+        TArray<int32>& Team = TeamThreat.FindOrAdd(TeamIndex);
+        if (Team.Num() != Starts.Num())
+        {
+            Team.SetNumZeroed(Starts.Num());
+        }
+        Team[StartIndex] += Delta;
+    }
+
+    for (auto& Pair : ScoreTrees)
+    {
+        Pair.Value.Update(StartIndex, GetScore(StartIndex, Pair.Key));
+    }
+}
+
+int32 UUR_SpawnSelectionSubsystem::GetScore(int32 StartIndex, int32 TeamIndex) const
+{
+    int32 Score = Threat[StartIndex];
+    if (TeamIndex >= 0)
+    {
+        if (const TArray<int32>* Team = TeamThreat.Find(TeamIndex))
+        {
+            Score -= (*Team)[StartIndex];
+        }
+    }
+    return Score;
+}
+
+FUR_SpawnScoreTree& UUR_SpawnSelectionSubsystem::GetScoreTree(int32 TeamIndex)
+{
+    if (FUR_SpawnScoreTree* Tree = ScoreTrees.Find(TeamIndex))
+    {
+        return *Tree;
+    }
+
+    TArray<int32> Scores;
+    Scores.SetNumUninitialized(Starts.Num());
+    for (int32 i = 0; i < Starts.Num(); i++)
+    {
+        Scores[i] = GetScore(i, TeamIndex);
+    }
+
+    FUR_SpawnScoreTree& Tree = ScoreTrees.Add(TeamIndex);
+    Tree.Init(Scores);
+    return Tree;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+void UUR_SpawnSelectionSubsystem::Tick(float DeltaTime)
+{
+    if (Starts.Num() == 0)
+    {
+        return;
+    }
+
+    const double Now = GetWorld()->GetTimeSeconds();
+
+    for (int32 i = RecentUses.Num() - 1; i >= 0; i--)
+    {
+        if (RecentUses[i].ExpireTime <= Now)
+        {
+            AddThreat(RecentUses[i].StartIndex, INDEX_NONE, -RecentUseThreat);
+            RecentUses.RemoveAtSwap(i, 1, false);
+        }
+    }
+
+    if (Now - LastUpdateTime >= UpdateInterval)
+    {
+        LastUpdateTime = Now;
+        UpdatePawns();
+    }
+}
+
+void UUR_SpawnSelectionSubsystem::UpdatePawns()
+{
+    SCOPE_CYCLE_COUNTER(STAT_SpawnUpdatePawns);
+
+    auto Registry = GetWorld()->GetSubsystem<UUR_GameplayActorRegistry>();
+    if (!Registry)
+    {
+        return;
+    }
+
+    UpdateId++;
+
+    Registry->ForEachActor(EGameplayActorType::Pawn, [this](AActor* Actor)
+    {
+        APawn* Pawn = Cast<APawn>(Actor);
+        if (!Pawn || Pawn->IsPendingKillPending() || Pawn->IsA<ASpectatorPawn>())
+        {
+            return;
+        }
+        const AUR_Character* Char = Cast<AUR_Character>(Pawn);
+        if (Char && !Char->IsAlive())
+        {
+            return;
+        }
+
+        const FIntPoint Cell = GetCellCoord(Pawn->GetActorLocation());
+        const int32 TeamIndex = Pawn->Implements<UUR_TeamInterface>() ? IUR_TeamInterface::Execute_GetTeamIndex(Pawn) : INDEX_NONE;
+
+        if (FTrackedPawn* Tracked = TrackedPawns.Find(Pawn))
+        {
+            if (Tracked->Cell != Cell || Tracked->TeamIndex != TeamIndex)
+            {
+                ApplyPawnThreat(Tracked->Cell, Tracked->TeamIndex, -1);
+                ApplyPawnThreat(Cell, TeamIndex, 1);
+                Tracked->Cell = Cell;
+                Tracked->TeamIndex = TeamIndex;
+            }
+            Tracked->UpdateId = UpdateId;
+        }
+        else
+        {
+            TrackedPawns.Add(Pawn, { Pawn, Cell, TeamIndex, UpdateId });
+            ApplyPawnThreat(Cell, TeamIndex, 1);
+        }
+    });
+
+    // Pawns that died or went away
+    for (auto It = TrackedPawns.CreateIterator(); It; ++It)
+    {
+        if (It.Value().UpdateId != UpdateId)
+        {
+            ApplyPawnThreat(It.Value().Cell, It.Value().TeamIndex, -1);
+            It.RemoveCurrent();
+        }
+    }
+
+    SET_DWORD_STAT(STAT_SpawnTrackedPawns, TrackedPawns.Num());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UUR_SpawnSelectionSubsystem::IsStartBlocked(int32 StartIndex, const APawn* PawnToFit) const
+{
+    const FSpawnStart& Start = Starts[StartIndex];
+    if (!Start.Actor.IsValid())
+    {
+        return true;
+    }
+    return PawnToFit && GetWorld()->EncroachingBlockingGeometry(PawnToFit, Start.Location, Start.Rotation);
+}
+
+bool UUR_SpawnSelectionSubsystem::IsStartVisibleToEnemies(int32 StartIndex, int32 TeamIndex, const APawn* PawnToFit) const
+{
+    if (SightCheckRadius <= 0.f)
+    {
+        return false;
+    }
+
+    const FVector Target = Starts[StartIndex].Location + FVector(0.f, 0.f, PawnToFit ? PawnToFit->BaseEyeHeight : 64.f);
+    const double MaxDistSq = FMath::Square(SightCheckRadius);
+
+    int32 NumTraces = 0;
+    for (const auto& Pair : TrackedPawns)
+    {
+        const FTrackedPawn& Tracked = Pair.Value;
+        if (TeamIndex >= 0 && Tracked.TeamIndex == TeamIndex)
+        {
+            continue;
+        }
+        const APawn* Pawn = Tracked.Pawn.Get();
+        if (!Pawn || FVector::DistSquared(Pawn->GetActorLocation(), Target) > MaxDistSq)
+        {
+            continue;
+        }
+        if (NumTraces >= MaxSightTraces)
+        {
+            break;
+        }
+
+        FVector EyeLocation;
+        FRotator EyeRotation;
+        Pawn->GetActorEyesViewPoint(EyeLocation, EyeRotation);
+
+        FCollisionQueryParams Params(SCENE_QUERY_STAT(SpawnSightCheck), false, Pawn);
+        NumTraces++;
+        if (!GetWorld()->LineTraceTestByChannel(EyeLocation, Target, ECC_Visibility, Params))
+        {
+            INC_DWORD_STAT_BY(STAT_SpawnSightTraces, NumTraces);
+            return true;
+        }
+    }
+
+    INC_DWORD_STAT_BY(STAT_SpawnSightTraces, NumTraces);
+    return false;
+}
+
+int32 UUR_SpawnSelectionSubsystem::SelectStart(int32 TeamIndex, const APawn* PawnToFit)
+{
+    FUR_SpawnScoreTree& Tree = GetScoreTree(TeamIndex);
+
+    // Candidates are taken out of the tree while validating, and put back afterwards
+    TArray<int32, TInlineAllocator<16>> Taken;
+    int32 Chosen = INDEX_NONE;
+    int32 Fallback = INDEX_NONE;
+
+    for (int32 i = 0; i < MaxCandidates; i++)
+    {
+        const int32 Best = Tree.GetBest();
+        if (Best == INDEX_NONE || Tree.GetScore(Best) == MAX_int32)
+        {
+            break;
+        }
+        Taken.Add(Best);
+        Tree.Update(Best, MAX_int32);
+
+        if (IsStartBlocked(Best, PawnToFit))
+        {
+            continue;
+        }
+        if (Fallback == INDEX_NONE)
+        {
+            Fallback = Best;
+        }
+        if (!IsStartVisibleToEnemies(Best, TeamIndex, PawnToFit))
+        {
+            Chosen = Best;
+            break;
+        }
+    }
+
+    for (int32 Index : Taken)
+    {
+        Tree.Update(Index, GetScore(Index, TeamIndex));
+    }
+
+    INC_DWORD_STAT_BY(STAT_SpawnRejectedCandidates, Taken.Num() - (Chosen != INDEX_NONE ? 1 : 0));
+
+    // Every candidate is in sight, take the least threatened one that fits
+    return (Chosen != INDEX_NONE) ? Chosen : Fallback;
+}
+
+AActor* UUR_SpawnSelectionSubsystem::ChooseSpawnPoint(AController* Player, const APawn* PawnToFit)
+{
+    SCOPE_CYCLE_COUNTER(STAT_ChooseSpawnPoint);
+
+    if (bHasPIEStart || Starts.Num() == 0)
+    {
+        return nullptr;
+    }
+
+    APlayerState* PS = Player ? Player->PlayerState : nullptr;
+    const int32 TeamIndex = (PS && PS->Implements<UUR_TeamInterface>()) ? IUR_TeamInterface::Execute_GetTeamIndex(PS) : INDEX_NONE;
+
+    const int32 StartIndex = SelectStart(TeamIndex, PawnToFit);
+    if (StartIndex == INDEX_NONE)
+    {
+        return nullptr;
+    }
+
+    // Spread consecutive spawns
+    if (RecentUseThreat > 0)
+    {
+        AddThreat(StartIndex, INDEX_NONE, RecentUseThreat);
+        RecentUses.Add({ StartIndex, GetWorld()->GetTimeSeconds() + RecentUseDuration });
+    }
+
+    return Starts[StartIndex].Actor.Get();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UUR_SpawnSelectionSubsystem::ValidateScores() const
+{
+    // Recompute from scratch, checking every start against every pawn (no grid lookup)
+    TArray<int32> ExpectedThreat;
+    ExpectedThreat.SetNumZeroed(Starts.Num());
+    TMap<int32, TArray<int32>> ExpectedTeamThreat;
+
+    for (const auto& Pair : TrackedPawns)
+    {
+        const FTrackedPawn& Tracked = Pair.Value;
+        TArray<int32>* Team = nullptr;
+        if (Tracked.TeamIndex >= 0)
+        {
+            Team = &ExpectedTeamThreat.FindOrAdd(Tracked.TeamIndex);
+            Team->SetNumZeroed(Starts.Num());
+        }
+        for (int32 i = 0; i < Starts.Num(); i++)
+        {
+            const int32 Amount = GetCellThreat(Tracked.Cell, i);
+            ExpectedThreat[i] += Amount;
+            if (Team)
+            {
+                (*Team)[i] += Amount;
+            }
+        }
+    }
+    for (const FRecentUse& Use : RecentUses)
+    {
+        ExpectedThreat[Use.StartIndex] += RecentUseThreat;
+    }
+
+    int32 NumErrors = 0;
+    for (int32 i = 0; i < Starts.Num(); i++)
+    {
+        if (Threat[i] != ExpectedThreat[i])
+        {
+            UE_LOG(LogGame, Warning, TEXT("SpawnSelection: start %i threat %i, expected %i"), i, Threat[i], ExpectedThreat[i]);
+            NumErrors++;
+        }
+        for (const auto& Pair : TeamThreat)
+        {
+            const TArray<int32>* Expected = ExpectedTeamThreat.Find(Pair.Key);
+            const int32 ExpectedValue = Expected ? (*Expected)[i] : 0;
+            if (Pair.Value[i] != ExpectedValue)
+            {
+                UE_LOG(LogGame, Warning, TEXT("SpawnSelection: start %i team %i threat %i, expected %i"), i, Pair.Key, Pair.Value[i], ExpectedValue);
+                NumErrors++;
+            }
+        }
+    }
+
+    for (const auto& Pair : ScoreTrees)
+    {
+        int32 ExpectedBest = INDEX_NONE;
+        for (int32 i = 0; i < Starts.Num(); i++)
+        {
+            const int32 Score = GetScore(i, Pair.Key);
+            if (Pair.Value.GetScore(i) != Score)
+            {
+                UE_LOG(LogGame, Warning, TEXT("SpawnSelection: team %i tree score %i for start %i, expected %i"), Pair.Key, Pair.Value.GetScore(i), i, Score);
+                NumErrors++;
+            }
+            if (ExpectedBest == INDEX_NONE || Score < GetScore(ExpectedBest, Pair.Key))
+            {
+                ExpectedBest = i;
+            }
+        }
+        if (Pair.Value.GetBest() != ExpectedBest)
+        {
+            UE_LOG(LogGame, Warning, TEXT("SpawnSelection: team %i tree best %i, expected %i"), Pair.Key, Pair.Value.GetBest(), ExpectedBest);
+            NumErrors++;
+        }
+    }
+
+    UE_LOG(LogGame, Log, TEXT("SpawnSelection: validated %i starts, %i tracked pawns, %i score trees: %i errors"), Starts.Num(), TrackedPawns.Num(), ScoreTrees.Num(), NumErrors);
+    return NumErrors == 0;
+}
+
+void UUR_SpawnSelectionSubsystem::Benchmark(int32 Iterations, const APawn* PawnToFit)
+{
+    if (Iterations <= 0 || Starts.Num() == 0)
+    {
+        return;
+    }
+
+    int32 Selected = INDEX_NONE;
+    const double SelectStartTime = FPlatformTime::Seconds();
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        Selected = SelectStart(INDEX_NONE, PawnToFit);
+    }
+    const double SelectTime = FPlatformTime::Seconds() - SelectStartTime;
+
+    // Naive: collision check every start, score it against every pawn
+    int32 NaiveSelected = INDEX_NONE;
+    const double NaiveStartTime = FPlatformTime::Seconds();
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        NaiveSelected = INDEX_NONE;
+        double BestScore = 0.0;
+        for (int32 StartIndex = 0; StartIndex < Starts.Num(); StartIndex++)
+        {
+            if (IsStartBlocked(StartIndex, PawnToFit))
+            {
+                continue;
+            }
+            double Score = 0.0;
+            for (const auto& Pair : TrackedPawns)
+            {
+                if (const APawn* Pawn = Pair.Value.Pawn.Get())
+                {
+                    Score += FMath::Max(0.0, 1.0 - FVector::Dist2D(Pawn->GetActorLocation(), Starts[StartIndex].Location) / ThreatRadius);
+                }
+            }
+            if (NaiveSelected == INDEX_NONE || Score < BestScore)
+            {
+                NaiveSelected = StartIndex;
+                BestScore = Score;
+            }
+        }
+    }
+    const double NaiveTime = FPlatformTime::Seconds() - NaiveStartTime;
+
+    UE_LOG(LogGame, Log, TEXT("SpawnSelection: %i starts, %i pawns, %i iterations: select %.4f ms (start %i), naive %.4f ms (start %i)"),
+        Starts.Num(), TrackedPawns.Num(), Iterations, SelectTime * 1000.0 / Iterations, Selected, NaiveTime * 1000.0 / Iterations, NaiveSelected);
+}
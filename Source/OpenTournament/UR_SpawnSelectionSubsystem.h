@@ -0,0 +1,212 @@
+// Copyright (c) Open Tournament Project, All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UR_SpawnSelectionSubsystem.generated.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+class AController;
+class APawn;
+class APlayerStart;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Min tournament tree over integer scores.
+ * Best (lowest score, then lowest index) is read in O(1), a score update costs O(log n).
+ */
+struct FUR_SpawnScoreTree
+{
+    void Init(const TArray<int32>& InScores);
+
+    void Update(int32 Index, int32 Score);
+
+    /** Index of the lowest score, INDEX_NONE if empty */
+    int32 GetBest() const { return Nodes.Num() > 1 ? Nodes[1] : INDEX_NONE; }
+
+    int32 GetScore(int32 Index) const { return Scores[Index]; }
+
+    int32 Num() const { return Scores.Num(); }
+
+private:
+
+    int32 Pick(int32 A, int32 B) const
+    {
+        if (A == INDEX_NONE) return B;
+        if (B == INDEX_NONE) return A;
+        return (Scores[B] < Scores[A] || (Scores[B] == Scores[A] && B < A)) ? B : A;
+    }
+
+    TArray<int32> Scores;
+
+    /** Implicit binary tree, leaves start at LeafOffset */
+    TArray<int32> Nodes;
+
+    int32 LeafOffset = 0;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Spawn point selection with threat awareness. Server only.
+ *
+ * Each player start keeps a threat score, made of the proximity of live pawns and recent use.
+ * Pawns are tracked on a coarse 2D grid; when a pawn changes cell, only the starts around
+ * its old and new cells are updated. Scores are integers, so incremental updates are exact
+ * and selection is deterministic for a given state.
+ *
+ * Per team, a tournament tree ranks starts by enemy threat. Selection takes the best start,
+ * then validates it (collision, enemy sight lines), moving to the next best on failure.
+ */
+UCLASS(Config = Game)
+class OPENTOURNAMENT_API UUR_SpawnSelectionSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    //~UWorldSubsystem interface
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    //~End of UWorldSubsystem interface
+
+    //~FTickableGameObject interface
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    //~End of FTickableGameObject interface
+
+    /**
+    * Choose a start for a player about to spawn.
+    * Returns null when there is nothing to choose from, caller should fall back to default behavior.
+    */
+    AActor* ChooseSpawnPoint(AController* Player, const APawn* PawnToFit);
+
+    /**
+    * Compare incremental threat scores and trees against a full recomputation.
+    * Backs the OT.Spawn.Validate console command.
+    */
+    bool ValidateScores() const;
+
+    /**
+    * Time selection against a naive scan of all starts.
+    * Backs the OT.Spawn.Benchmark console command.
+    */
+    void Benchmark(int32 Iterations, const APawn* PawnToFit);
+
+    /** Size of the grid cells pawns are tracked in */
+    UPROPERTY(Config)
+    float CellSize = 1024.f;
+
+    /** Pawns further than this from a start don't threaten it */
+    UPROPERTY(Config)
+    float ThreatRadius = 3000.f;
+
+    /** Threat of a pawn standing on a start. Decreases linearly to 0 at ThreatRadius. */
+    UPROPERTY(Config)
+    int32 PawnThreat = 1000;
+
+    /** Threat added to a start when it is used, for RecentUseDuration */
+    UPROPERTY(Config)
+    int32 RecentUseThreat = 2000;
+
+    UPROPERTY(Config)
+    float RecentUseDuration = 4.f;
+
+    /** Enemies within this distance are traced against to reject starts in plain sight */
+    UPROPERTY(Config)
+    float SightCheckRadius = 5000.f;
+
+    /** Cap on sight traces per candidate start */
+    UPROPERTY(Config)
+    int32 MaxSightTraces = 8;
+
+    /** Number of best starts validated before settling for the best non-blocked one */
+    UPROPERTY(Config)
+    int32 MaxCandidates = 6;
+
+    /** Interval between pawn position updates */
+    UPROPERTY(Config)
+    float UpdateInterval = 0.2f;
+
+protected:
+
+    struct FSpawnStart
+    {
+        TWeakObjectPtr<APlayerStart> Actor;
+        FVector Location;
+        FRotator Rotation;
+    };
+
+    struct FTrackedPawn
+    {
+        TWeakObjectPtr<APawn> Pawn;
+        FIntPoint Cell;
+        int32 TeamIndex;
+        uint32 UpdateId;
+    };
+
+    struct FRecentUse
+    {
+        int32 StartIndex;
+        double ExpireTime;
+    };
+
+    FIntPoint GetCellCoord(const FVector& Location) const
+    {
+        return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+    }
+
+    /** Threat of a pawn in Cell on a given start. Uses the cell center so add and remove always match. */
+    int32 GetCellThreat(const FIntPoint& Cell, int32 StartIndex) const;
+
+    /** Add (Sign = 1) or remove (Sign = -1) a pawn threat around a cell */
+    void ApplyPawnThreat(const FIntPoint& Cell, int32 TeamIndex, int32 Sign);
+
+    /** Change threat of a start and propagate to score trees */
+    void AddThreat(int32 StartIndex, int32 TeamIndex, int32 Delta);
+
+    /** Threat of a start as seen by a team, ie. excluding the team's own pawns */
+    int32 GetScore(int32 StartIndex, int32 TeamIndex) const;
+
+    FUR_SpawnScoreTree& GetScoreTree(int32 TeamIndex);
+
+    void UpdatePawns();
+
+    bool IsStartBlocked(int32 StartIndex, const APawn* PawnToFit) const;
+
+    bool IsStartVisibleToEnemies(int32 StartIndex, int32 TeamIndex, const APawn* PawnToFit) const;
+
+    int32 SelectStart(int32 TeamIndex, const APawn* PawnToFit);
+
+    TArray<FSpawnStart> Starts;
+
+    /** Start indices bucketed per grid cell */
+    TMap<FIntPoint, TArray<int32>> StartCells;
+
+    /** Total threat per start */
+    TArray<int32> Threat;
+
+    /** Threat per start caused by the pawns of each team (TeamIndex >= 0) */
+    TMap<int32, TArray<int32>> TeamThreat;
+
+    /** Score trees per spawning team, created on first use. Key -1 is for players without a team. */
+    TMap<int32, FUR_SpawnScoreTree> ScoreTrees;
+
+    TMap<TObjectKey<APawn>, FTrackedPawn> TrackedPawns;
+
+    TArray<FRecentUse> RecentUses;
+
+    uint32 UpdateId = 0;
+
+    double LastUpdateTime = 0.0;
+
+    /** Let the engine handle "play from here" in editor */
+    bool bHasPIEStart = false;
+};
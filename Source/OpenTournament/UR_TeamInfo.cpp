@@ -5,7 +5,7 @@
 #include "UR_TeamInfo.h"
 
 #include "Net/UnrealNetwork.h"
-//#include "Net/Core/PushModel/PushModel.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Engine/Engine.h"
 #include "Engine/World.h"
 #include "Kismet/KismetSystemLibrary.h"
@@ -30,11 +30,12 @@ void AUR_TeamInfo::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLife
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    DOREPLIFETIME_CONDITION(ThisClass, TeamIndex, COND_InitialOnly);
-
     FDoRepLifetimeParams Params;
     Params.bIsPushBased = true;
     DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, Score, Params);
+
+    Params.Condition = COND_InitialOnly;
+    DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, TeamIndex, Params);
 }
 
 void AUR_TeamInfo::BeginPlay()
@@ -92,7 +93,7 @@ void AUR_TeamInfo::RemovePlayer(AUR_PlayerState* Player)
 void AUR_TeamInfo::AddScore(const int32 Value)
 {
     Score += Value;
-    //MARK_PROPERTY_DIRTY_FROM_NAME(AUR_TeamInfo, Score, this);
+    MARK_PROPERTY_DIRTY_FROM_NAME(AUR_TeamInfo, Score, this);
     ForceNetUpdate();
 }
 
@@ -106,6 +107,7 @@ int32 AUR_TeamInfo::GetTeamIndex_Implementation()
 void AUR_TeamInfo::SetTeamIndex_Implementation(int32 NewTeamIndex)
 {
 	TeamIndex = NewTeamIndex;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AUR_TeamInfo, TeamIndex, this);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -13,9 +13,12 @@
 #include "Components/SkeletalMeshComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/Engine.h"
+#include "EngineUtils.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetSystemLibrary.h" //debug
 #include "Net/UnrealNetwork.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
 #include "TimerManager.h"
 #include "Particles/ParticleSystemComponent.h"
 
@@ -26,6 +29,7 @@
 #include "UR_PlayerController.h"
 #include "UR_FunctionLibrary.h"
 #include "UR_PaniniUtils.h"
+#include "UR_ReplicationGraph.h"
 #include "UR_Ammo.h"
 
 #include "UR_FireModeBasic.h"
@@ -34,6 +38,57 @@
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+namespace OTConsoleVariables
+{
+    static FAutoConsoleCommandWithWorldAndArgs CmdNetWeaponChannels(
+        TEXT("OT.Net.WeaponChannels"),
+        TEXT("Server only. Log per client connection: open actor channels, weapon channels, and bandwidth."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+            if (!NetDriver || !NetDriver->IsServer())
+            {
+                UE_LOG(LogTemp, Warning, TEXT("OT.Net.WeaponChannels: not a server"));
+                return;
+            }
+
+            int32 NumWeapons = 0;
+            int32 NumEquippedWeapons = 0;
+            for (TActorIterator<AUR_Weapon> It(World); It; ++It)
+            {
+                NumWeapons++;
+                NumEquippedWeapons += It->IsEquipped() ? 1 : 0;
+            }
+            UE_LOG(LogTemp, Log, TEXT("%d clients, %d weapons (%d equipped)"), NetDriver->ClientConnections.Num(), NumWeapons, NumEquippedWeapons);
+
+            int32 TotalChannels = 0;
+            int32 TotalWeaponChannels = 0;
+            for (UNetConnection* Connection : NetDriver->ClientConnections)
+            {
+                if (!Connection)
+                {
+                    continue;
+                }
+                int32 NumWeaponChannels = 0;
+                for (const auto& Pair : Connection->ActorChannelMap())
+                {
+                    NumWeaponChannels += (Pair.Key.Get() && Pair.Key.Get()->IsA<AUR_Weapon>()) ? 1 : 0;
+                }
+                TotalChannels += Connection->ActorChannelsNum();
+                TotalWeaponChannels += NumWeaponChannels;
+                UE_LOG(LogTemp, Log, TEXT("  %s: %d actor channels, %d weapon channels, out %d B/s, in %d B/s"),
+                    *GetNameSafe(Connection->PlayerController), Connection->ActorChannelsNum(), NumWeaponChannels, Connection->OutBytesPerSecond, Connection->InBytesPerSecond);
+            }
+            if (NetDriver->ClientConnections.Num() > 0)
+            {
+                UE_LOG(LogTemp, Log, TEXT("Average per client: %.1f actor channels, %.1f weapon channels"),
+                    static_cast<float>(TotalChannels) / NetDriver->ClientConnections.Num(), static_cast<float>(TotalWeaponChannels) / NetDriver->ClientConnections.Num());
+            }
+        }));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
 AUR_Weapon::AUR_Weapon(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer)
 {
@@ -68,7 +123,15 @@ void AUR_Weapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifeti
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    DOREPLIFETIME_CONDITION(ThisClass, AmmoRefs, COND_OwnerOnly);
+    // Compact ammo storage uses local ammo instances, resolved by the inventory on each side
+    if (GetDefault<UUR_InventoryComponent>()->bCompactAmmoStorage)
+    {
+        DISABLE_REPLICATED_PROPERTY(ThisClass, AmmoRefs);
+    }
+    else
+    {
+        DOREPLIFETIME_CONDITION(ThisClass, AmmoRefs, COND_OwnerOnly);
+    }
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -140,6 +203,57 @@ void AUR_Weapon::GiveTo(AUR_Character* NewOwner)
     {
         OnRep_Owner();
     }
+
+    // AddWeapon destroys duplicates
+    if (IsValid(this))
+    {
+        UpdateNetRelevancy();
+    }
+}
+
+void AUR_Weapon::OnRep_AmmoRefs()
+{
+    // Ammo availability of this weapon may have changed
+    if (URCharOwner && URCharOwner->InventoryComponent)
+    {
+        URCharOwner->InventoryComponent->RefreshWeaponSwitchAmmo(nullptr);
+    }
+}
+
+bool AUR_Weapon::IsEquipped() const
+{
+    const UUR_InventoryComponent* Inventory = URCharOwner ? URCharOwner->InventoryComponent : nullptr;
+    return Inventory && (Inventory->DesiredWeapon == this || Inventory->ActiveWeapon == this);
+}
+
+void AUR_Weapon::UpdateNetRelevancy()
+{
+    if (!HasAuthority())
+    {
+        return;
+    }
+
+    // Inventory weapons stay awake, the owner's channel must remain open for fire mode server RPCs.
+    // Non-owners are culled by relevancy instead (IsNetRelevantFor, or the replication graph dependency).
+    if (!URCharOwner || IsEquipped())
+    {
+        // Bring it to remote clients along with the inventory's DesiredWeapon
+        ForceNetUpdate();
+    }
+
+    if (UUR_ReplicationGraph* RepGraph = UUR_ReplicationGraph::Get(GetWorld()))
+    {
+        RepGraph->UpdateWeaponDependency(this);
+    }
+}
+
+bool AUR_Weapon::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+    if (URCharOwner && !IsEquipped())
+    {
+        return IsOwnedBy(ViewTarget) || IsOwnedBy(RealViewer);
+    }
+    return Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation);
 }
 
 void AUR_Weapon::OnRep_Owner()
@@ -102,6 +102,23 @@ public:
     UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable)
     void GiveTo(AUR_Character* NewOwner);
 
+    /**
+    * Whether this weapon is the desired or active weapon of its owner's inventory.
+    * Only the equipped weapon matters to non-owners.
+    */
+    UFUNCTION(BlueprintPure, Category = "Weapon")
+    bool IsEquipped() const;
+
+    /**
+    * Authority only.
+    * Equipped or ownerless weapons are relevant to all.
+    * Weapons sitting in inventory are only relevant to owner.
+    * Call whenever ownership or equipped status changes.
+    */
+    void UpdateNetRelevancy();
+
+    virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+
 protected:
 
     virtual void OnRep_Owner() override;
@@ -141,10 +158,14 @@ public:
     /**
     * Map AmmoDefinition indices to the real AUR_Ammo objects contained in InventoryComponent, for simpler usage.
     * Replicated (OwnerOnly) to workaround painful race conditions (eg. weapon replicated before ammo).
+    * Not replicated with compact ammo storage, see UUR_InventoryComponent::bCompactAmmoStorage.
     */
-    UPROPERTY(BlueprintReadOnly, Replicated)
+    UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_AmmoRefs)
     TArray<AUR_Ammo*> AmmoRefs;
 
+    UFUNCTION()
+    virtual void OnRep_AmmoRefs();
+
     /**
     * Fallback to that weapon if no user configuration is found for this weapon.
     * Used to apply plug-and-play user settings on mod-weapons by falling back to more common (core) weapons.
@@ -10,12 +10,14 @@
 #include "Components/SkeletalMeshComponent.h"
 
 #include "UR_Character.h"
+#include "UR_GameplayTags.h"
 #include "UR_Weapon.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 AUR_WeaponBase::AUR_WeaponBase()
 {
+    GameplayTags.AddTag(URGameplayTags::TAG_Pickup_Weapon);
 }
 
 #if WITH_EDITOR
@@ -11,5 +11,10 @@ public class OpenTournamentServerTarget : TargetRules
         Type = TargetType.Server;
         LinkType = TargetLinkType.Modular;
         ExtraModuleNames.Add("OpenTournament");
+
+        // Replicated properties of gameplay classes are push based, see net.IsPushModelEnabled.
+        // Only here: server targets already require a source engine, while the game and editor targets
+        // share the launcher engine's build environment, which doesn't allow changing this setting.
+        bWithPushModel = true;
     }
 }
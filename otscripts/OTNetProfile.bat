@@ -0,0 +1,114 @@
+@echo off
+setlocal EnableDelayedExpansion EnableExtensions
+title OTNetProfile.bat
+
+:: Local net profile: dedicated server running a bot match, with headless clients over loopback.
+:: The server captures a net profile (see UR_NetProfiler) and exits with a nonzero code if a budget is exceeded.
+::
+:: Usage: OTNetProfile.bat [-editor <UnrealEditor-Cmd.exe>] [-map <map>] [-clients <count>] [-bots <count>] [-duration <seconds>] [-warmup <seconds>] [-fullammo] [-nopause]
+:: -bots is the number of bots on top of the clients (the server is started with BotFill=clients+bots).
+:: -fullammo turns off compact ammo storage on server and clients, compare the spawn payload line of the report with a default run.
+
+:: Move to OT root
+cd "%~dp0.."
+
+:: Defaults
+set "editor=!UE_EDITOR_CMD!"
+if "!editor!"=="" (
+	set "editor=UnrealEditor-Cmd.exe"
+)
+set map=/Game/OpenTournament/Levels/Aqua_2
+set clients=4
+set bots=8
+set duration=120
+set warmup=30
+set port=7787
+set nopause=0
+set extraargs=
+
+:: Parse arguments
+:parseargs
+if "%~1"=="" goto endargs
+if /I "%~1"=="-editor" (
+	set "editor=%~2"
+	shift
+) else if /I "%~1"=="-map" (
+	set "map=%~2"
+	shift
+) else if /I "%~1"=="-clients" (
+	set "clients=%~2"
+	shift
+) else if /I "%~1"=="-bots" (
+	set "bots=%~2"
+	shift
+) else if /I "%~1"=="-duration" (
+	set "duration=%~2"
+	shift
+) else if /I "%~1"=="-warmup" (
+	set "warmup=%~2"
+	shift
+) else if /I "%~1"=="-fullammo" (
+	set "extraargs=-ini:Game:[/Script/OpenTournament.UR_InventoryComponent]:bCompactAmmoStorage=False"
+) else if /I "%~1"=="-nopause" (
+	:: Automation - skip pause at end of script
+	set nopause=1
+)
+shift
+goto parseargs
+:endargs
+
+set "project=%cd%\OpenTournament.uproject"
+set "logdir=%cd%\Saved\Logs"
+if exist "!logdir!\NetProfile-Server.log" (
+	del "!logdir!\NetProfile-Server.log"
+)
+
+:: BotFill is the total of players and bots
+set /a botfill=clients+bots
+
+echo Starting server on !map! with !bots! bots, profiling !duration! s after !warmup! s with !clients! clients
+start "OTNetProfile Server" /MIN "!editor!" "!project!" "!map!?BotFill=!botfill!" -server -log -unattended -nullrhi -nosound -port=!port! -NetProfile=!duration! -NetProfileWarmup=!warmup! -NetProfileClients=!clients! -NetProfileExit !extraargs! -abslog="!logdir!\NetProfile-Server.log"
+
+:: Give the server time to load the map before clients connect
+timeout /t 20 /nobreak >nul
+
+for /L %%i in (1,1,!clients!) do (
+	start "OTNetProfile Client %%i" /MIN "!editor!" "!project!" 127.0.0.1:!port! -game -unattended -nullrhi -nosound !extraargs! -abslog="!logdir!\NetProfile-Client%%i.log"
+)
+
+:: Wait for the server to report, giving up if it died or is way past the capture
+set /a waitleft=warmup+duration+120
+:waitserver
+timeout /t 5 /nobreak >nul
+findstr /C:"NetProfile: PASS" /C:"NetProfile: FAIL" "!logdir!\NetProfile-Server.log" >nul 2>&1
+if not errorlevel 1 goto serverdone
+powershell -NoProfile -Command "if (Get-CimInstance Win32_Process | Where-Object { $_.ProcessId -ne $PID -and $_.CommandLine -like '*NetProfile-Server*' }) { exit 0 } else { exit 1 }"
+if errorlevel 1 (
+	echo Server exited without reporting
+	goto serverdone
+)
+set /a waitleft-=5
+if !waitleft! LEQ 0 (
+	echo Timed out waiting for the server to report
+	powershell -NoProfile -Command "Get-CimInstance Win32_Process | Where-Object { $_.ProcessId -ne $PID -and $_.CommandLine -like '*NetProfile-Server*' } | ForEach-Object { Stop-Process -Id $_.ProcessId -Force }"
+	goto serverdone
+)
+goto waitserver
+:serverdone
+
+:: Clients don't exit on their own when the server goes away
+powershell -NoProfile -Command "Get-CimInstance Win32_Process | Where-Object { $_.ProcessId -ne $PID -and $_.CommandLine -like '*NetProfile-Client*' } | ForEach-Object { Stop-Process -Id $_.ProcessId -Force }"
+
+set result=0
+findstr /C:"NetProfile: PASS" "!logdir!\NetProfile-Server.log" >nul 2>&1
+if errorlevel 1 (
+	set result=1
+	echo Net profile FAILED, see !logdir!\NetProfile-Server.log
+) else (
+	echo Net profile passed, see !logdir!\NetProfile-Server.log
+)
+
+if !nopause!==0 (
+	pause
+)
+exit /B !result!